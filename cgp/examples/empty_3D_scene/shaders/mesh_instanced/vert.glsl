@@ -0,0 +1,50 @@
+#version 330 core // OpenGL 3.3 shader
+
+// Vertex shader for instanced drawing (see mesh_drawable_instanced) - same as shaders/mesh/vert.glsl,
+//  with the model matrices and a color coming from per-instance attributes instead of uniforms.
+//  Use with the fragment shader shaders/mesh/frag.glsl
+
+// Inputs coming from VBOs
+layout (location = 0) in vec3 vertex_position; // vertex position in local space (x,y,z)
+layout (location = 1) in vec3 vertex_normal;   // vertex normal in local space   (nx,ny,nz)
+layout (location = 2) in vec3 vertex_color;    // vertex color      (r,g,b)
+layout (location = 3) in vec2 vertex_uv;       // vertex uv-texture (u,v)
+
+// Inputs coming from the per-instance buffer (one value per instance)
+layout (location = 4) in mat4 instance_model;        // Model affine transform matrix of the instance (locations 4 to 7)
+layout (location = 8) in mat4 instance_model_normal; // transpose(inverse(instance_model)) (locations 8 to 11)
+layout (location = 12) in vec3 instance_color;       // Color of the instance (multiplied by the vertex color)
+
+// Output variables sent to the fragment shader
+out struct fragment_data
+{
+    vec3 position; // vertex position in world space
+    vec3 normal;   // normal position in world space
+    vec3 color;    // vertex color
+    vec2 uv;       // vertex uv
+} fragment;
+
+// Uniform variables expected to receive from the C++ program
+uniform mat4 view;  // View matrix (rigid transform) of the camera
+uniform mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+
+
+void main()
+{
+	// The position of the vertex in the world space
+	vec4 position = instance_model * vec4(vertex_position, 1.0);
+
+	// The normal of the vertex in the world space
+	vec4 normal = instance_model_normal * vec4(vertex_normal, 0.0);
+
+	// The projected position of the vertex in the normalized device coordinates:
+	vec4 position_projected = projection * view * position;
+
+	// Fill the parameters sent to the fragment shader
+	fragment.position = position.xyz;
+	fragment.normal   = normal.xyz;
+	fragment.color = vertex_color * instance_color;
+	fragment.uv = vertex_uv;
+
+	gl_Position = position_projected;
+}
@@ -0,0 +1,44 @@
+#version 330 core // OpenGL 3.3 shader
+
+// Geometry shader of the single pass wireframe - executed once per triangle
+//  Forwards the vertices of the triangle and associates each of them to a barycentric coordinate (1,0,0), (0,1,0), (0,0,1).
+//  The fragment shader detects the edges where one of the interpolated barycentric coordinates is close to 0.
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+// Inputs coming from the vertex shader
+in vertex_data
+{
+    vec3 position;
+    vec3 normal;
+    vec3 color;
+    vec2 uv;
+} vertex[];
+
+// Output variables sent to the fragment shader
+out fragment_data
+{
+    vec3 position;    // position in the world space
+    vec3 normal;      // normal in the world space
+    vec3 color;       // vertex color
+    vec2 uv;          // vertex uv
+    vec3 barycentric; // barycentric coordinates in the triangle
+} fragment;
+
+
+void main()
+{
+	for (int k = 0; k < 3; ++k) {
+		fragment.position = vertex[k].position;
+		fragment.normal = vertex[k].normal;
+		fragment.color = vertex[k].color;
+		fragment.uv = vertex[k].uv;
+		fragment.barycentric = vec3(0.0);
+		fragment.barycentric[k] = 1.0;
+
+		gl_Position = gl_in[k].gl_Position;
+		EmitVertex();
+	}
+	EndPrimitive();
+}
@@ -0,0 +1,44 @@
+#version 330 core // OpenGL 3.3 shader
+
+// Vertex shader of the single pass wireframe (see mesh_drawable::wireframe_shader) - same as shaders/mesh/vert.glsl,
+//  with the outputs sent to the geometry shader shaders/mesh_wireframe/geom.glsl
+
+// Inputs coming from VBOs
+layout (location = 0) in vec3 vertex_position; // vertex position in local space (x,y,z)
+layout (location = 1) in vec3 vertex_normal;   // vertex normal in local space   (nx,ny,nz)
+layout (location = 2) in vec3 vertex_color;    // vertex color      (r,g,b)
+layout (location = 3) in vec2 vertex_uv;       // vertex uv-texture (u,v)
+
+// Output variables sent to the geometry shader
+out vertex_data
+{
+    vec3 position; // vertex position in world space
+    vec3 normal;   // normal position in world space
+    vec3 color;    // vertex color
+    vec2 uv;       // vertex uv
+} vertex;
+
+// Uniform variables expected to receive from the C++ program
+uniform mat4 model; // Model affine transform matrix associated to the current shape
+uniform mat4 view;  // View matrix (rigid transform) of the camera
+uniform mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+
+uniform mat4 modelNormal; // Model without scaling used for the normal. modelNormal = transpose(inverse(model))
+
+
+void main()
+{
+	// The position of the vertex in the world space
+	vec4 position = model * vec4(vertex_position, 1.0);
+
+	// The normal of the vertex in the world space
+	vec4 normal = modelNormal * vec4(vertex_normal, 0.0);
+
+	// Fill the parameters sent to the geometry shader
+	vertex.position = position.xyz;
+	vertex.normal   = normal.xyz;
+	vertex.color = vertex_color;
+	vertex.uv = vertex_uv;
+
+	gl_Position = projection * view * position;
+}
@@ -1,4 +1,5 @@
 #pragma once
 
 #include "numarray_stack/numarray_stack.hpp"
+#include "expression/expression.hpp"
 #include "numarray/numarray.hpp"
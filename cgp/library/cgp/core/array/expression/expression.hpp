@@ -0,0 +1,325 @@
+#pragma once
+
+#include "cgp/core/base/base.hpp"
+
+#include <type_traits>
+#include <iostream>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+/** Lazy element-wise arithmetic on numarray, grid_2D and grid_3D
+ *
+ * The operators + - * / between containers, and between a container and a scalar value, don't compute their result:
+ *  they return an expression_node storing references to their operands.
+ *  The expression is evaluated element by element in a single loop when it is assigned to a container, without temporary containers.
+ *  ex. numarray<vec3> p = a + b*0.5f - c; // one loop, one allocation for p
+ *
+ * - The sizes of the operands are checked when the expression is built (as the operators computing the result directly).
+ * - The result of each operation is converted to the element type of the container before being used by the next operation.
+ * - An expression refers to its operands: assign it to a container before they are destroyed (don't store it with auto).
+ * - eval(expression) returns the container storing the result.
+ **/
+
+/** Description of a container usable in expressions - specialized by numarray, grid_2D and grid_3D
+ *  using value_type: type of the elements
+ *  using shape_type: dimension of the container (int, int2, int3)
+ *  static value_type const* data(Container const&), static int size(Container const&), static shape_type shape(Container const&) */
+template <typename Container> struct expression_container { static constexpr bool enabled = false; };
+
+
+/** Reference to the elements of a container */
+template <typename Container>
+struct expression_terminal
+{
+    using traits = expression_container<Container>;
+    using value_type = typename traits::value_type;
+    using shape_type = typename traits::shape_type;
+
+    value_type const* value;
+    int N;
+    shape_type dimension;
+
+    explicit expression_terminal(Container const& container) :value(traits::data(container)), N(traits::size(container)), dimension(traits::shape(container)) {}
+
+    int size() const { return N; }
+    shape_type shape() const { return dimension; }
+    value_type const& operator()(int k) const { return value[k]; }
+};
+
+/** Scalar value used for every element */
+template <typename S>
+struct expression_scalar
+{
+    S value;
+    S const& operator()(int) const { return value; }
+};
+
+/** Second operand of unary operations */
+struct expression_empty
+{
+    expression_empty operator()(int) const { return {}; }
+};
+
+/** Element-wise operation Op between the expressions L and R (R is expression_empty for unary operations) */
+template <typename Container, typename Op, typename L, typename R>
+struct expression_node
+{
+    using container = Container;
+    using value_type = typename expression_container<Container>::value_type;
+    using shape_type = typename expression_container<Container>::shape_type;
+
+    L left;
+    R right;
+    int N;
+    shape_type dimension;
+
+    int size() const { return N; }
+    shape_type shape() const { return dimension; }
+    value_type operator()(int k) const { return value_type(Op::apply(left(k), right(k))); }
+};
+
+struct expression_add      { template <typename A, typename B> static auto apply(A const& a, B const& b) -> decltype(a+b) { return a+b; } };
+struct expression_subtract { template <typename A, typename B> static auto apply(A const& a, B const& b) -> decltype(a-b) { return a-b; } };
+struct expression_multiply { template <typename A, typename B> static auto apply(A const& a, B const& b) -> decltype(a*b) { return a*b; } };
+struct expression_divide   { template <typename A, typename B> static auto apply(A const& a, B const& b) -> decltype(a/b) { return a/b; } };
+struct expression_negate   { template <typename A> static auto apply(A const& a, expression_empty) -> decltype(-a) { return -a; } };
+
+
+namespace detail
+{
+    // Operand of an expression: a container (stored as expression_terminal) or an expression_node (stored by copy)
+    template <typename X>
+    struct expression_operand
+    {
+        static constexpr bool enabled = expression_container<X>::enabled;
+        using container = X;
+        using type = expression_terminal<X>;
+        static type get(X const& x) { return type(x); }
+    };
+    template <typename Container, typename Op, typename L, typename R>
+    struct expression_operand<expression_node<Container, Op, L, R> >
+    {
+        static constexpr bool enabled = true;
+        using container = Container;
+        using type = expression_node<Container, Op, L, R>;
+        static type const& get(type const& x) { return x; }
+    };
+
+    template <typename A> using expression_container_t = typename expression_operand<A>::container;
+    template <typename A> using expression_operand_t = typename expression_operand<A>::type;
+    template <typename A> using expression_value_t = typename expression_container<expression_container_t<A> >::value_type;
+
+    template <typename A, typename B>
+    using expression_enable_binary = typename std::enable_if<expression_operand<A>::enabled && expression_operand<B>::enabled && std::is_same<expression_container_t<A>, expression_container_t<B> >::value>::type;
+    template <typename A>
+    using expression_enable_unary = typename std::enable_if<expression_operand<A>::enabled>::type;
+
+    template <typename Op, typename A, typename B>
+    using expression_binary_t = expression_node<expression_container_t<A>, Op, expression_operand_t<A>, expression_operand_t<B> >;
+    template <typename Op, typename A, typename S>
+    using expression_right_scalar_t = expression_node<expression_container_t<A>, Op, expression_operand_t<A>, expression_scalar<S> >;
+    template <typename Op, typename A, typename S>
+    using expression_left_scalar_t = expression_node<expression_container_t<A>, Op, expression_scalar<S>, expression_operand_t<A> >;
+
+    template <typename Op, typename A, typename B>
+    expression_binary_t<Op, A, B> expression_binary(A const& a, B const& b)
+    {
+        auto const& ea = expression_operand<A>::get(a);
+        auto const& eb = expression_operand<B>::get(b);
+        assert_cgp(ea.size()>0 && eb.size()>0, "Size must be >0");
+        assert_cgp(is_equal(ea.shape(), eb.shape()), "Size do not agree: a:"+str(ea.shape())+", b:"+str(eb.shape()));
+        return { ea, eb, ea.size(), ea.shape() };
+    }
+
+    // check_size: the operation is not defined on empty containers
+    template <typename Op, typename A, typename S>
+    expression_right_scalar_t<Op, A, S> expression_right_scalar(A const& a, S const& s, bool check_size)
+    {
+        auto const& ea = expression_operand<A>::get(a);
+        assert_cgp(!check_size || ea.size()>0, "Size must be >0");
+        return { ea, expression_scalar<S>{s}, ea.size(), ea.shape() };
+    }
+    template <typename Op, typename A, typename S>
+    expression_left_scalar_t<Op, A, S> expression_left_scalar(S const& s, A const& a)
+    {
+        auto const& ea = expression_operand<A>::get(a);
+        return { expression_scalar<S>{s}, ea, ea.size(), ea.shape() };
+    }
+}
+
+/** Store the values of the expression in the buffer value (of size e.size()) */
+template <typename E> void expression_evaluate(typename E::value_type* value, E const& e);
+
+/** Apply value[k] (op)= e(k) for every element */
+template <typename E> void expression_evaluate_add(typename E::value_type* value, E const& e);
+template <typename E> void expression_evaluate_subtract(typename E::value_type* value, E const& e);
+template <typename E> void expression_evaluate_multiply(typename E::value_type* value, E const& e);
+template <typename E> void expression_evaluate_divide(typename E::value_type* value, E const& e);
+
+/** Container storing the result of the expression */
+template <typename Container, typename Op, typename L, typename R> Container eval(expression_node<Container, Op, L, R> const& e);
+
+template <typename Container, typename Op, typename L, typename R, typename X> bool is_equal(expression_node<Container, Op, L, R> const& e, X const& x);
+template <typename X, typename Container, typename Op, typename L, typename R> bool is_equal(X const& x, expression_node<Container, Op, L, R> const& e);
+template <typename C1, typename Op1, typename L1, typename R1, typename C2, typename Op2, typename L2, typename R2> bool is_equal(expression_node<C1, Op1, L1, R1> const& e1, expression_node<C2, Op2, L2, R2> const& e2);
+
+template <typename Container, typename Op, typename L, typename R> std::string str(expression_node<Container, Op, L, R> const& e, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+template <typename Container, typename Op, typename L, typename R> std::ostream& operator<<(std::ostream& s, expression_node<Container, Op, L, R> const& e);
+
+
+/** Math operators
+ * A and B are containers of the same type, or expressions on them. The scalar operand is an element value, or a float for * and /. */
+template <typename A, typename = detail::expression_enable_unary<A> >
+expression_node<detail::expression_container_t<A>, expression_negate, detail::expression_operand_t<A>, expression_empty> operator-(A const& a);
+
+template <typename A, typename B, typename = detail::expression_enable_binary<A, B> > detail::expression_binary_t<expression_add, A, B> operator+(A const& a, B const& b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_right_scalar_t<expression_add, A, detail::expression_value_t<A> > operator+(A const& a, detail::expression_value_t<A> const& b); // a[i]+b
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_left_scalar_t<expression_add, A, detail::expression_value_t<A> > operator+(detail::expression_value_t<A> const& a, A const& b); // a+b[i]
+
+template <typename A, typename B, typename = detail::expression_enable_binary<A, B> > detail::expression_binary_t<expression_subtract, A, B> operator-(A const& a, B const& b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_right_scalar_t<expression_subtract, A, detail::expression_value_t<A> > operator-(A const& a, detail::expression_value_t<A> const& b); // a[i]-b
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_left_scalar_t<expression_subtract, A, detail::expression_value_t<A> > operator-(detail::expression_value_t<A> const& a, A const& b); // a-b[i]
+
+template <typename A, typename B, typename = detail::expression_enable_binary<A, B> > detail::expression_binary_t<expression_multiply, A, B> operator*(A const& a, B const& b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_right_scalar_t<expression_multiply, A, float> operator*(A const& a, float b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_left_scalar_t<expression_multiply, A, float> operator*(float a, A const& b);
+
+template <typename A, typename B, typename = detail::expression_enable_binary<A, B> > detail::expression_binary_t<expression_divide, A, B> operator/(A const& a, B const& b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_right_scalar_t<expression_divide, A, float> operator/(A const& a, float b);
+template <typename A, typename = detail::expression_enable_unary<A> > detail::expression_left_scalar_t<expression_divide, A, float> operator/(float a, A const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename E> void expression_evaluate(typename E::value_type* value, E const& e)
+{
+    int const N = e.size();
+    for (int k = 0; k < N; ++k)
+        value[k] = e(k);
+}
+template <typename E> void expression_evaluate_add(typename E::value_type* value, E const& e)
+{
+    int const N = e.size();
+    for (int k = 0; k < N; ++k)
+        value[k] += e(k);
+}
+template <typename E> void expression_evaluate_subtract(typename E::value_type* value, E const& e)
+{
+    int const N = e.size();
+    for (int k = 0; k < N; ++k)
+        value[k] -= e(k);
+}
+template <typename E> void expression_evaluate_multiply(typename E::value_type* value, E const& e)
+{
+    int const N = e.size();
+    for (int k = 0; k < N; ++k)
+        value[k] *= e(k);
+}
+template <typename E> void expression_evaluate_divide(typename E::value_type* value, E const& e)
+{
+    int const N = e.size();
+    for (int k = 0; k < N; ++k)
+        value[k] /= e(k);
+}
+
+template <typename Container, typename Op, typename L, typename R> Container eval(expression_node<Container, Op, L, R> const& e)
+{
+    return Container(e);
+}
+
+template <typename Container, typename Op, typename L, typename R, typename X> bool is_equal(expression_node<Container, Op, L, R> const& e, X const& x)
+{
+    return is_equal(eval(e), x);
+}
+template <typename X, typename Container, typename Op, typename L, typename R> bool is_equal(X const& x, expression_node<Container, Op, L, R> const& e)
+{
+    return is_equal(x, eval(e));
+}
+template <typename C1, typename Op1, typename L1, typename R1, typename C2, typename Op2, typename L2, typename R2> bool is_equal(expression_node<C1, Op1, L1, R1> const& e1, expression_node<C2, Op2, L2, R2> const& e2)
+{
+    return is_equal(eval(e1), eval(e2));
+}
+
+template <typename Container, typename Op, typename L, typename R> std::string str(expression_node<Container, Op, L, R> const& e, std::string const& separator, std::string const& begin, std::string const& end)
+{
+    return str(eval(e), separator, begin, end);
+}
+template <typename Container, typename Op, typename L, typename R> std::ostream& operator<<(std::ostream& s, expression_node<Container, Op, L, R> const& e)
+{
+    return s << eval(e);
+}
+
+
+template <typename A, typename>
+expression_node<detail::expression_container_t<A>, expression_negate, detail::expression_operand_t<A>, expression_empty> operator-(A const& a)
+{
+    auto const& ea = detail::expression_operand<A>::get(a);
+    return { ea, expression_empty{}, ea.size(), ea.shape() };
+}
+
+template <typename A, typename B, typename> detail::expression_binary_t<expression_add, A, B> operator+(A const& a, B const& b)
+{
+    return detail::expression_binary<expression_add>(a, b);
+}
+template <typename A, typename> detail::expression_right_scalar_t<expression_add, A, detail::expression_value_t<A> > operator+(A const& a, detail::expression_value_t<A> const& b)
+{
+    return detail::expression_right_scalar<expression_add>(a, b, true);
+}
+template <typename A, typename> detail::expression_left_scalar_t<expression_add, A, detail::expression_value_t<A> > operator+(detail::expression_value_t<A> const& a, A const& b)
+{
+    return detail::expression_left_scalar<expression_add>(a, b);
+}
+
+template <typename A, typename B, typename> detail::expression_binary_t<expression_subtract, A, B> operator-(A const& a, B const& b)
+{
+    return detail::expression_binary<expression_subtract>(a, b);
+}
+template <typename A, typename> detail::expression_right_scalar_t<expression_subtract, A, detail::expression_value_t<A> > operator-(A const& a, detail::expression_value_t<A> const& b)
+{
+    return detail::expression_right_scalar<expression_subtract>(a, b, true);
+}
+template <typename A, typename> detail::expression_left_scalar_t<expression_subtract, A, detail::expression_value_t<A> > operator-(detail::expression_value_t<A> const& a, A const& b)
+{
+    return detail::expression_left_scalar<expression_subtract>(a, b);
+}
+
+template <typename A, typename B, typename> detail::expression_binary_t<expression_multiply, A, B> operator*(A const& a, B const& b)
+{
+    return detail::expression_binary<expression_multiply>(a, b);
+}
+template <typename A, typename> detail::expression_right_scalar_t<expression_multiply, A, float> operator*(A const& a, float b)
+{
+    return detail::expression_right_scalar<expression_multiply>(a, b, false);
+}
+template <typename A, typename> detail::expression_left_scalar_t<expression_multiply, A, float> operator*(float a, A const& b)
+{
+    return detail::expression_left_scalar<expression_multiply>(a, b);
+}
+
+template <typename A, typename B, typename> detail::expression_binary_t<expression_divide, A, B> operator/(A const& a, B const& b)
+{
+    return detail::expression_binary<expression_divide>(a, b);
+}
+template <typename A, typename> detail::expression_right_scalar_t<expression_divide, A, float> operator/(A const& a, float b)
+{
+    return detail::expression_right_scalar<expression_divide>(a, b, true);
+}
+template <typename A, typename> detail::expression_left_scalar_t<expression_divide, A, float> operator/(float a, A const& b)
+{
+    return detail::expression_left_scalar<expression_divide>(a, b);
+}
+
+}
@@ -0,0 +1,68 @@
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/array/array.hpp"
+#include "cgp/core/containers/grid/grid.hpp"
+#include "cgp/geometry/vec/vec3/vec3.hpp"
+#include "benchmark_expression.hpp"
+
+#include <chrono>
+#include <iostream>
+
+
+namespace cgp_test
+{
+	using namespace cgp;
+
+	template <typename F>
+	static double time_ms(F const& f, int N_repeat)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_repeat; ++k)
+			f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / N_repeat;
+	}
+
+	// Evaluation of a + b*s - c with a temporary container for each operator (behavior of non-lazy operators)
+	template <typename Container>
+	static void evaluate_with_temporaries(Container& res, Container const& a, Container const& b, Container const& c, float s)
+	{
+		Container tmp1 = b;
+		tmp1 *= s;
+		Container tmp2 = a;
+		tmp2 += tmp1;
+		tmp2 -= c;
+		res = tmp2;
+	}
+
+	template <typename Container>
+	static void benchmark(std::string const& name, Container const& a, Container const& b, Container const& c, int N_repeat)
+	{
+		Container res = a;
+		Container res_temporaries = a;
+
+		double const t_temporaries = time_ms([&]() { evaluate_with_temporaries(res_temporaries, a, b, c, 0.5f); }, N_repeat);
+		double const t_expression = time_ms([&]() { res = a + b * 0.5f - c; }, N_repeat);
+		assert_cgp_no_msg(is_equal(res, res_temporaries));
+
+		std::cout << name << " - a + b*0.5f - c on " << a.size() << " elements: " << t_expression << " ms (" << t_temporaries << " ms with temporaries)" << std::endl;
+	}
+
+	void benchmark_expression()
+	{
+		int const N = 4000000;
+		numarray<vec3> a(N), b(N), c(N);
+		for (int k = 0; k < N; ++k) {
+			a[k] = { float(k), 1.0f, 2.0f };
+			b[k] = { 1.0f, float(k), 0.5f };
+			c[k] = { 0.0f, 1.0f, float(k) };
+		}
+		benchmark("numarray<vec3>", a, b, c, 10);
+
+		grid_3D<float> ga(200), gb(200), gc(200);
+		for (int k = 0; k < ga.size(); ++k) {
+			ga.data[k] = float(k);
+			gb.data[k] = 1.0f;
+			gc.data[k] = 0.5f * float(k);
+		}
+		benchmark("grid_3D<float>", ga, gb, gc, 10);
+	}
+}
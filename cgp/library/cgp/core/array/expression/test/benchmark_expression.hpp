@@ -0,0 +1,8 @@
+#pragma once
+
+namespace cgp_test
+{
+	// Time of a compound expression a + b*0.5f - c on numarray<vec3> and grid_3D<float>
+	//  compared to the same computation with one temporary container per operator
+	void benchmark_expression();
+}
@@ -0,0 +1,68 @@
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/array/array.hpp"
+#include "cgp/core/containers/grid/grid.hpp"
+#include "cgp/geometry/vec/vec3/vec3.hpp"
+#include "test_expression.hpp"
+
+
+namespace cgp_test
+{
+	void test_expression()
+	{
+		using namespace cgp;
+
+		// compound expression evaluated in a single loop
+		{
+			numarray<float> a = { 1,2,3 };
+			numarray<float> b = { 4,5,6 };
+			numarray<float> c = { 1,1,2 };
+			numarray<float> d = a + b * 0.5f - c;
+			assert_cgp_no_msg(is_equal(d, numarray<float>{ 2,3.5f,4 }));
+
+			d = -a + 2.0f / b + 1.0f;
+			assert_cgp_no_msg(is_equal(d, numarray<float>{ 0.5f,-0.6f,-1.6666667f }));
+
+			assert_cgp_no_msg(is_equal(a * b, numarray<float>{ 4,10,18 }));
+			assert_cgp_no_msg(is_equal(numarray<float>{ 4,10,18 }, a * b));
+			assert_cgp_no_msg(str(numarray<int>{ 1,2,3 } * 2.0f) == "2 4 6");
+		}
+
+		// each operation is converted to the element type, as with the direct operators
+		{
+			numarray<int> a = { 1,2,3 };
+			numarray<int> b = a * 0.5f + a * 0.5f;
+			assert_cgp_no_msg(is_equal(b, numarray<int>{ 0,2,2 }));
+		}
+
+		// operands aliasing the result
+		{
+			numarray<vec3> a = { {1,0,0}, {0,1,0} };
+			numarray<vec3> const b = { {1,1,1}, {2,2,2} };
+			a = a + b * 2.0f;
+			assert_cgp_no_msg(is_equal(a, numarray<vec3>{ {3,2,2}, {4,5,4} }));
+			a += b - a;
+			assert_cgp_no_msg(is_equal(a, b));
+			a -= b * 0.5f;
+			a *= b / b;
+			assert_cgp_no_msg(is_equal(a, numarray<vec3>{ {0.5f,0.5f,0.5f}, {1,1,1} }));
+		}
+
+		// grid_2D and grid_3D keep their dimension
+		{
+			grid_2D<float> a(2, 3);
+			a.fill(1.0f);
+			grid_2D<float> b = 2.0f * a + a;
+			assert_cgp_no_msg(is_equal(b.dimension, int2{ 2,3 }));
+			assert_cgp_no_msg(is_equal(b(1, 2), 3.0f));
+
+			grid_3D<float> c(2, 1, 3);
+			c.fill(2.0f);
+			grid_3D<float> d;
+			d = c * c - 1.0f;
+			assert_cgp_no_msg(is_equal(d.dimension, int3{ 2,1,3 }));
+			assert_cgp_no_msg(is_equal(d(1, 0, 2), 3.0f));
+			d /= c + c;
+			assert_cgp_no_msg(is_equal(d(0, 0, 0), 0.75f));
+		}
+	}
+}
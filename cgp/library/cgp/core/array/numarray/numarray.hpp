@@ -1,8 +1,11 @@
 #pragma once
 
 #include "cgp/core/base/base.hpp"
+#include "cgp/core/array/expression/expression.hpp"
 
 #include <vector>
+#include <iterator>
+#include <utility>
 #include <iostream>
 
 /* ************************************************** */
@@ -16,6 +19,7 @@ namespace cgp
  *
  * The numarray structure is a wrapper around an std::vector with additional convenient functionalities
  * - Overloaded operators + - * / as well as common outputs
+ *   (the operators return lazy expressions evaluated in a single loop when assigned, see expression.hpp)
  * - Strict bound checking with operator [] and () (unless cgp_NO_DEBUG is defined)
  *
  * Numarray follows the main syntax than std::vector
@@ -33,6 +37,13 @@ struct numarray
     numarray(int size);                     // numarray with a given size 
     numarray(std::initializer_list<T> arg); // Inline initialization using { } 
     numarray(std::vector<T> const& arg);    // Direct initialization from std::vector 
+    numarray(std::vector<T>&& arg);         // Initialization taking the memory of the std::vector (no copy)
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, numarray<T> >::value>::type>
+    numarray(E const& expression);          // Evaluation of an expression (ex. numarray<float> c = a + 2.0f*b;)
+
+    /** Evaluation of an expression in the current container (a single loop without temporary) */
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, numarray<T> >::value>::type>
+    numarray<T>& operator=(E const& expression);
 
     /** Similar to matlab linespace 
     * Linear interpolation between p1 and p2 along N variable */
@@ -48,6 +59,17 @@ struct numarray
     numarray<T>& push_back(T const& value);
     /** Add an numarray of elements at the end of the container */
     numarray<T>& push_back(numarray<T> const& value);
+    /** Same as push_back, moving the values instead of copying them */
+    numarray<T>& push_back(T&& value);
+    numarray<T>& push_back(numarray<T>&& value);
+    /** Construct an element at the end of the container from the arguments of its constructor, and return it (similar to vector.emplace_back()) */
+    template <typename... Args> T& emplace_back(Args&&... args);
+
+    /** Capacity management (similar to std::vector)
+    * reserve(N) allocates the memory for N elements without changing the size: the following push_back do not reallocate until the size exceeds N */
+    int capacity() const;
+    numarray<T>& reserve(int capacity);
+    numarray<T>& shrink_to_fit();
     /** Remove all elements of the container, new size is 0 (similar to vector.clear()) */
     numarray<T>& clear();
     /** Fill the container with the same element (from index 0 to size-1) */
@@ -113,31 +135,32 @@ template <typename T> T average(numarray<T> const& a);
 
 
 /** Math operators
- * Common mathematical operations between numarrays, and scalar or element values. */
-template <typename T> numarray<T>  operator-(numarray<T> const& a);
-
+ * Common mathematical operations between numarrays, and scalar or element values.
+ * The operators + - * / (defined in expression.hpp) return expressions evaluated when assigned to a numarray. */
 template <typename T> numarray<T>& operator+=(numarray<T>& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator+=(numarray<T>& a, T const& b);
-template <typename T> numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator+(numarray<T> const& a, T const& b); // Componentwise sum: a[i]+b 
-template <typename T> numarray<T>  operator+(T const& a, numarray<T> const& b); // Componentwise sum: a+b[i]
-
 template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator-=(numarray<T>& a, T const& b);
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator-(numarray<T> const& a, T const& b); // Componentwise substraction: a[i]-b 
-template <typename T> numarray<T>  operator-(T const& a, numarray<T> const& b); // Componentwise substraction: a-b[i] 
-
 template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator*=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b);
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b);
-
 template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b);
 template <typename T> numarray<T>& operator/=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b);
+
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator+=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator-=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator*=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator/=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b);
+
+template <typename T>
+struct expression_container<numarray<T> >
+{
+    static constexpr bool enabled = true;
+    using value_type = T;
+    using shape_type = int;
+    static T const* data(numarray<T> const& a) { return a.data.data(); }
+    static int size(numarray<T> const& a) { return a.size(); }
+    static int shape(numarray<T> const& a) { return a.size(); }
+};
 
 
 }
@@ -171,6 +194,29 @@ numarray<T>::numarray(const std::vector<T>& arg)
     :data(arg)
 {}
 
+template <typename T>
+numarray<T>::numarray(std::vector<T>&& arg)
+    :data(std::move(arg))
+{}
+
+template <typename T>
+template <typename E, typename>
+numarray<T>::numarray(E const& expression)
+    :data(expression.size())
+{
+    expression_evaluate(data.data(), expression);
+}
+
+template <typename T>
+template <typename E, typename>
+numarray<T>& numarray<T>::operator=(E const& expression)
+{
+    // The expression is element-wise: the operands can alias the current buffer, which keeps its size
+    resize(expression.size());
+    expression_evaluate(data.data(), expression);
+    return *this;
+}
+
 template <typename T>
 int numarray<T>::size() const
 {
@@ -203,8 +249,54 @@ numarray<T>& numarray<T>::push_back(T const& value)
 template <typename T>
 numarray<T>& numarray<T>::push_back(numarray<T> const& value)
 {
-    for(T const& element : value)
-        data.push_back(element);
+    data.insert(data.end(), value.data.begin(), value.data.end());
+    return *this;
+}
+
+template <typename T>
+numarray<T>& numarray<T>::push_back(T&& value)
+{
+    data.push_back(std::move(value));
+    return *this;
+}
+
+template <typename T>
+numarray<T>& numarray<T>::push_back(numarray<T>&& value)
+{
+    // Take the memory of value when the current buffer would need to be reallocated anyway
+    if (data.empty() && data.capacity() < value.data.size())
+        data = std::move(value.data);
+    else
+        data.insert(data.end(), std::make_move_iterator(value.data.begin()), std::make_move_iterator(value.data.end()));
+    return *this;
+}
+
+template <typename T>
+template <typename... Args>
+T& numarray<T>::emplace_back(Args&&... args)
+{
+    data.emplace_back(std::forward<Args>(args)...);
+    return data.back();
+}
+
+template <typename T>
+int numarray<T>::capacity() const
+{
+    return int(data.capacity());
+}
+
+template <typename T>
+numarray<T>& numarray<T>::reserve(int capacity)
+{
+    assert_cgp_no_msg(capacity>=0);
+    data.reserve(capacity);
+    return *this;
+}
+
+template <typename T>
+numarray<T>& numarray<T>::shrink_to_fit()
+{
+    data.shrink_to_fit();
     return *this;
 }
 
@@ -461,42 +553,6 @@ numarray<T>& operator+=(numarray<T>& a, T const& b)
     return a;
 }
 
-template <typename T>
-numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-numarray<T>  operator+(numarray<T> const& a, T const& b)
-{
-    numarray<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-numarray<T>  operator+(T const& a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a+b[k];
-    return res;
-}
-
-template <typename T> numarray<T>  operator-(numarray<T> const& a)
-{
-    int const N = a.size();
-    numarray<T> b(N);
-    for(int k=0; k<N; ++k)
-        b[k] = -a[k];
-    return b;
-}
-
-
 template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b)
 {
     assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
@@ -515,26 +571,6 @@ template <typename T> numarray<T>& operator-=(numarray<T>& a, T const& b)
         a[k] -= b;
     return a;
 }
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res -= b;
-    return res;
-}
-template <typename T> numarray<T>  operator-(numarray<T> const& a, T const& b)
-{
-    numarray<T> res = a;
-    res -= b;
-    return res;
-}
-template <typename T> numarray<T>  operator-(T const& a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a-b[k];
-    return res;
-}
 
 
 template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b)
@@ -547,16 +583,6 @@ template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const&
         a[k] *= b[k];
     return a;
 }
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res *= b;
-    return res;
-}
-
-
-
-
 template <typename T> numarray<T>& operator*=(numarray<T>& a, float b)
 {
     int const N = a.size();
@@ -564,22 +590,6 @@ template <typename T> numarray<T>& operator*=(numarray<T>& a, float b)
         a[k] *= b;
     return a;
 }
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b)
-{
-    int const N = a.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a[k]*b;
-    return res;
-}
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a*b[k];
-    return res;
-}
 
 template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b)
 {
@@ -599,17 +609,35 @@ template <typename T> numarray<T>& operator/=(numarray<T>& a, float b)
         a[k] /= b;
     return a;
 }
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b)
+
+
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator+=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b)
+{
+    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
+    assert_cgp(a.size()==b.size(), "Size do not agree");
+    expression_evaluate_add(a.data.data(), b);
+    return a;
+}
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator-=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b)
 {
-    numarray<T> res = a;
-    res /= b;
-    return res;
+    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
+    assert_cgp(a.size()==b.size(), "Size do not agree");
+    expression_evaluate_subtract(a.data.data(), b);
+    return a;
 }
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b)
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator*=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b)
 {
-    numarray<T> res = a;
-    res /= b;
-    return res;
+    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
+    assert_cgp(a.size()==b.size(), "Size do not agree");
+    expression_evaluate_multiply(a.data.data(), b);
+    return a;
+}
+template <typename T, typename Op, typename L, typename R> numarray<T>& operator/=(numarray<T>& a, expression_node<numarray<T>, Op, L, R> const& b)
+{
+    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
+    assert_cgp(a.size()==b.size(), "Size do not agree");
+    expression_evaluate_divide(a.data.data(), b);
+    return a;
 }
 
 
@@ -102,5 +102,31 @@ namespace cgp_test
 			assert_cgp_no_msg(cgp::is_equal(a[5], 8.2f));
 		}
 
+
+		// test reserve, emplace_back and move
+		{
+			cgp::numarray<int> a;
+			a.reserve(10);
+			assert_cgp_no_msg(a.size() == 0 && a.capacity() >= 10);
+			int const* buffer = a.data.data();
+			for (int k = 0; k < 10; ++k)
+				a.emplace_back(k);
+			assert_cgp_no_msg(a.data.data() == buffer);
+			assert_cgp_no_msg(a[9] == 9);
+
+			a.resize(2);
+			a.shrink_to_fit();
+			assert_cgp_no_msg(a.size() == 2 && a.capacity() == 2);
+
+			cgp::numarray<cgp::numarray<int>> b;
+			cgp::numarray<int> c = { 1,2,3 };
+			int const* buffer_c = c.data.data();
+			b.push_back(std::move(c));
+			assert_cgp_no_msg(b.size() == 1 && b[0].data.data() == buffer_c);
+
+			cgp::numarray<cgp::numarray<int>> d = { {4},{5,6} };
+			b.push_back(std::move(d));
+			assert_cgp_no_msg(b.size() == 3 && b[2].size() == 2);
+		}
 	}
 }
\ No newline at end of file
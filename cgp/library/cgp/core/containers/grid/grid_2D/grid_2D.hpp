@@ -32,6 +32,12 @@ struct grid_2D
     grid_2D(int size);                // Build a grid_2D of squared dimension (size,size)
     grid_2D(int2 const& size);        // Build a grid_2D with specified dimension
     grid_2D(int size_1, int size_2);  // Build a grid_2D with specified dimension
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, grid_2D<T> >::value>::type>
+    grid_2D(E const& expression);  // Evaluation of an expression (ex. grid_2D<float> c = a + 2.0f*b;)
+
+    /** Evaluation of an expression in the current container (a single loop without temporary) */
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, grid_2D<T> >::value>::type>
+    grid_2D<T>& operator=(E const& expression);
 
     /** Direct build a grid_2D from a given 1D-buffer and its 2D-dimension
     * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2 */
@@ -96,30 +102,35 @@ template <typename T> std::string str(grid_2D<T> const& v, std::string const& se
 template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b);
 
 /** Math operators
- * Common mathematical operations between buffers, and scalar or element values. */
+ * Common mathematical operations between buffers, and scalar or element values.
+ * The operators + - * / (defined in expression.hpp) return expressions evaluated when assigned to a grid_2D. */
 template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b);
-
 template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b);
 
 template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b);
 template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b);
 
 template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b);
 template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b);
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b);
 
 template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b);
 template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b);
+
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator+=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator-=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator*=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator/=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b);
+
+template <typename T>
+struct expression_container<grid_2D<T> >
+{
+    static constexpr bool enabled = true;
+    using value_type = T;
+    using shape_type = int2;
+    static T const* data(grid_2D<T> const& a) { return a.data.data.data(); }
+    static int size(grid_2D<T> const& a) { return a.size(); }
+    static int2 shape(grid_2D<T> const& a) { return a.dimension; }
+};
 
 
 
@@ -162,6 +173,23 @@ grid_2D<T>::grid_2D(int size_1, int size_2)
     assert_cgp_no_msg(size_1>=0 && size_2>=0);
 }
 
+template <typename T>
+template <typename E, typename>
+grid_2D<T>::grid_2D(E const& expression)
+    :dimension(expression.shape()),data(expression.size())
+{
+    expression_evaluate(data.data.data(), expression);
+}
+
+template <typename T>
+template <typename E, typename>
+grid_2D<T>& grid_2D<T>::operator=(E const& expression)
+{
+    resize(expression.shape());
+    expression_evaluate(data.data.data(), expression);
+    return *this;
+}
+
 
 
 template <typename T>
@@ -378,111 +406,77 @@ template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
 template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b)
 {
     a.data += b;
-}
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
-
-}
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
+    return a;
 }
 template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b)
 {
     a.data -= b;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
+    return a;
 }
 template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b)
 {
     a.data *= b;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
+    return a;
 }
 template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b)
 {
     a.data /= b;
+    return a;
+}
+
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator+=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b)
+{
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_add(a.data.data.data(), b);
+    return a;
 }
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b)
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator-=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b)
 {
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_subtract(a.data.data.data(), b);
+    return a;
+}
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator*=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b)
+{
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_multiply(a.data.data.data(), b);
+    return a;
 }
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b)
+template <typename T, typename Op, typename L, typename R> grid_2D<T>& operator/=(grid_2D<T>& a, expression_node<grid_2D<T>, Op, L, R> const& b)
 {
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_divide(a.data.data.data(), b);
+    return a;
 }
 
 
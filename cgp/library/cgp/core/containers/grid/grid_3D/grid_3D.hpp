@@ -30,6 +30,12 @@ struct grid_3D
     grid_3D(int size);         // Generate a grid of dimension size x size x size
     grid_3D(int3 const& size); // Generate a grid of dimension size.x size.y size.z
     grid_3D(int size_1, int size_2, int size_3); // Generate a grid of dimension size_1 x size_2 x size_3
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, grid_3D<T> >::value>::type>
+    grid_3D(E const& expression);  // Evaluation of an expression (ex. grid_3D<float> c = a + 2.0f*b;)
+
+    /** Evaluation of an expression in the current container (a single loop without temporary) */
+    template <typename E, typename = typename std::enable_if<std::is_same<typename E::container, grid_3D<T> >::value>::type>
+    grid_3D<T>& operator=(E const& expression);
 
     /** Direct build a grid_3D from a given 1D-buffer and its 3D-dimension
     * \note: the size of the 3D-buffer must satisfy arg.size = size_1 * size_2 * size_3 */
@@ -83,27 +89,31 @@ template <typename T> std::string str(grid_3D<T> const& v, std::string const& se
 
 template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b);
 template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b);
 
 template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b);
 template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b);
 
 template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b);
 template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b);
 
 template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b);
 template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b);
+
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator+=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator-=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator*=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b);
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator/=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b);
+
+template <typename T>
+struct expression_container<grid_3D<T> >
+{
+    static constexpr bool enabled = true;
+    using value_type = T;
+    using shape_type = int3;
+    static T const* data(grid_3D<T> const& a) { return a.data.data.data(); }
+    static int size(grid_3D<T> const& a) { return a.size(); }
+    static int3 shape(grid_3D<T> const& a) { return a.dimension; }
+};
 
 }
 
@@ -143,6 +153,23 @@ grid_3D<T>::grid_3D(int size_1, int size_2, int size_3)
     assert_cgp_no_msg(size_1>=0 && size_2>=0 && size_3>=0);
 }
 
+template <typename T>
+template <typename E, typename>
+grid_3D<T>::grid_3D(E const& expression)
+    :dimension(expression.shape()),data(expression.size())
+{
+    expression_evaluate(data.data.data(), expression);
+}
+
+template <typename T>
+template <typename E, typename>
+grid_3D<T>& grid_3D<T>::operator=(E const& expression)
+{
+    resize(expression.shape());
+    expression_evaluate(data.data.data(), expression);
+    return *this;
+}
+
 template <typename T>
 int grid_3D<T>::size() const
 {
@@ -365,117 +392,77 @@ template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
 template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b)
 {
     a.data += b;
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
-
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
+    return a;
 }
 template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b)
 {
     a.data -= b;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
+    return a;
 }
 template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b)
 {
     a.data *= b;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
+    return a;
 }
 
 template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b)
 {
     assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
+    return a;
 }
 template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b)
 {
     a.data /= b;
+    return a;
 }
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b)
+
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator+=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b)
 {
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_add(a.data.data.data(), b);
+    return a;
+}
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator-=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b)
+{
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_subtract(a.data.data.data(), b);
+    return a;
 }
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b)
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator*=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b)
 {
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_multiply(a.data.data.data(), b);
+    return a;
 }
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b)
+template <typename T, typename Op, typename L, typename R> grid_3D<T>& operator/=(grid_3D<T>& a, expression_node<grid_3D<T>, Op, L, R> const& b)
 {
-    grid_3D<T> res(b.dimension);
-    res.data = a/b.data;
-    return res;
+    assert_cgp( is_equal(a.dimension,b.shape()), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.shape()) );
+    assert_cgp(a.size()>0, "Size must be >0");
+    expression_evaluate_divide(a.data.data.data(), b);
+    return a;
 }
 
 
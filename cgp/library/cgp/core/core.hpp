@@ -4,3 +4,5 @@
 #include "array/array.hpp"
 #include "containers/containers.hpp"
 #include "files/files.hpp"
+#include "parallel/parallel.hpp"
+#include "simd/simd.hpp"
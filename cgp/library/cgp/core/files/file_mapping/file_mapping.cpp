@@ -0,0 +1,154 @@
+#include "file_mapping.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace cgp
+{
+	file_mapping::file_mapping()
+		:mapped_data(nullptr), mapped_size(0), opened(false)
+#ifdef _WIN32
+		, file_handle(nullptr), mapping_handle(nullptr)
+#endif
+	{}
+
+	file_mapping::file_mapping(std::string const& filename)
+		:file_mapping()
+	{
+		open(filename);
+	}
+
+	file_mapping::~file_mapping()
+	{
+		close();
+	}
+
+	file_mapping::file_mapping(file_mapping&& other)
+		:file_mapping()
+	{
+		*this = std::move(other);
+	}
+
+	file_mapping& file_mapping::operator=(file_mapping&& other)
+	{
+		if (this != &other) {
+			close();
+			std::swap(mapped_data, other.mapped_data);
+			std::swap(mapped_size, other.mapped_size);
+			std::swap(opened, other.opened);
+#ifdef _WIN32
+			std::swap(file_handle, other.file_handle);
+			std::swap(mapping_handle, other.mapping_handle);
+#endif
+		}
+		return *this;
+	}
+
+	bool file_mapping::is_open() const { return opened; }
+	char const* file_mapping::data() const { return mapped_data; }
+	size_t file_mapping::size() const { return mapped_size; }
+
+#ifdef _WIN32
+	bool file_mapping::open(std::string const& filename)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size)) {
+			CloseHandle(file);
+			return false;
+		}
+
+		opened = true;
+		file_handle = file;
+		if (file_size.QuadPart == 0) // Empty files cannot be mapped
+			return true;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr) {
+			if (mapping != nullptr)
+				CloseHandle(mapping);
+			close();
+			return false;
+		}
+
+		mapping_handle = mapping;
+		mapped_data = static_cast<char const*>(view);
+		mapped_size = size_t(file_size.QuadPart);
+		return true;
+	}
+
+	void file_mapping::close()
+	{
+		if (mapped_data != nullptr)
+			UnmapViewOfFile(mapped_data);
+		if (mapping_handle != nullptr)
+			CloseHandle(mapping_handle);
+		if (file_handle != nullptr)
+			CloseHandle(file_handle);
+
+		mapped_data = nullptr;
+		mapped_size = 0;
+		opened = false;
+		file_handle = nullptr;
+		mapping_handle = nullptr;
+	}
+#else
+	bool file_mapping::open(std::string const& filename)
+	{
+		close();
+
+		int const fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat stat_buf;
+		if (fstat(fd, &stat_buf) != 0) {
+			::close(fd);
+			return false;
+		}
+
+		size_t const file_size = size_t(stat_buf.st_size);
+		if (file_size > 0) {
+			void* const view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view == MAP_FAILED) {
+				::close(fd);
+				return false;
+			}
+			mapped_data = static_cast<char const*>(view);
+			mapped_size = file_size;
+		}
+
+		// The mapping remains valid after closing the file descriptor
+		::close(fd);
+		opened = true;
+		return true;
+	}
+
+	void file_mapping::close()
+	{
+		if (mapped_data != nullptr)
+			munmap(const_cast<char*>(mapped_data), mapped_size);
+
+		mapped_data = nullptr;
+		mapped_size = 0;
+		opened = false;
+	}
+#endif
+}
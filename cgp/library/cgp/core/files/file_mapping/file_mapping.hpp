@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace cgp
+{
+	/** Read-only memory mapping of a file
+	* The content of the file is accessible as a contiguous array of bytes without copy (the pages are loaded by the OS on access).
+	* The mapping is released when the structure is destroyed. */
+	struct file_mapping
+	{
+		file_mapping();
+		explicit file_mapping(std::string const& filename);
+		~file_mapping();
+
+		file_mapping(file_mapping&& other);
+		file_mapping& operator=(file_mapping&& other);
+		file_mapping(file_mapping const&) = delete;
+		file_mapping& operator=(file_mapping const&) = delete;
+
+		/** Map the file. Return false if the file cannot be opened or mapped.
+		* Note: An empty file is considered as valid, with data()==nullptr and size()==0 */
+		bool open(std::string const& filename);
+		void close();
+
+		bool is_open() const;
+		char const* data() const;
+		size_t size() const;
+
+	private:
+		char const* mapped_data;
+		size_t mapped_size;
+		bool opened;
+#ifdef _WIN32
+		void* file_handle;
+		void* mapping_handle;
+#endif
+	};
+}
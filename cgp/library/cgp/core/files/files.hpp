@@ -2,6 +2,7 @@
 
 
 #include "cgp/core/array/array.hpp"
+#include "file_mapping/file_mapping.hpp"
 
 #include <string>
 #include <sstream>
@@ -0,0 +1,177 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgp
+{
+	// Persistent pool of worker threads waiting for a range to process
+	//  A single job is processed at a time. The ranges of the job are obtained by the threads from a shared atomic counter.
+	struct parallel_thread_pool
+	{
+		parallel_thread_pool();
+		~parallel_thread_pool();
+
+		void resize(int N_worker);
+		void run(int N, std::function<void(int, int)> const& f, int grain_size);
+
+	private:
+		void stop_workers();
+		void worker_loop(unsigned long long generation_start);
+		void process_ranges();
+
+		std::vector<std::thread> workers;
+
+		std::mutex mutex_submit; // serializes the concurrent calls to run()
+		std::mutex mutex;
+		std::condition_variable condition_start;
+		std::condition_variable condition_done;
+
+		// Current job
+		std::function<void(int, int)> const* job = nullptr;
+		int job_size = 0;
+		int job_grain_size = 1;
+		std::atomic<int> next_index;
+		int active_workers = 0;
+		unsigned long long generation = 0;
+		bool stop = false;
+	};
+
+	static thread_local bool is_inside_parallel_for = false;
+
+	static parallel_thread_pool& thread_pool()
+	{
+		static parallel_thread_pool pool;
+		return pool;
+	}
+
+	static int& number_of_threads()
+	{
+		static int N_thread = std::max(1, int(std::thread::hardware_concurrency()));
+		return N_thread;
+	}
+
+	int parallel_number_of_threads()
+	{
+		return number_of_threads();
+	}
+
+	void parallel_set_number_of_threads(int N_thread)
+	{
+		number_of_threads() = std::max(1, N_thread);
+	}
+
+	void parallel_for(int N, std::function<void(int, int)> const& f, int grain_size)
+	{
+		if (N <= 0)
+			return;
+		grain_size = std::max(1, grain_size);
+
+		// Serial execution for small ranges, single thread, or nested calls
+		if (N <= grain_size || number_of_threads() == 1 || is_inside_parallel_for) {
+			f(0, N);
+			return;
+		}
+
+		thread_pool().run(N, f, grain_size);
+	}
+
+
+	parallel_thread_pool::parallel_thread_pool()
+		:next_index(0)
+	{}
+
+	parallel_thread_pool::~parallel_thread_pool()
+	{
+		stop_workers();
+	}
+
+	void parallel_thread_pool::stop_workers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		condition_start.notify_all();
+		for (auto& worker : workers)
+			worker.join();
+		workers.clear();
+		stop = false;
+	}
+
+	void parallel_thread_pool::resize(int N_worker)
+	{
+		if (int(workers.size()) == N_worker)
+			return;
+
+		stop_workers();
+		for (int k = 0; k < N_worker; ++k)
+			workers.push_back(std::thread(&parallel_thread_pool::worker_loop, this, generation));
+	}
+
+	void parallel_thread_pool::run(int N, std::function<void(int, int)> const& f, int grain_size)
+	{
+		std::lock_guard<std::mutex> lock_submit(mutex_submit);
+
+		// The calling thread counts as one of the threads
+		resize(number_of_threads() - 1);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &f;
+			job_size = N;
+			job_grain_size = grain_size;
+			next_index = 0;
+			active_workers = int(workers.size());
+			generation++;
+		}
+		condition_start.notify_all();
+
+		process_ranges();
+
+		// Wait for all workers to finish their current range
+		std::unique_lock<std::mutex> lock(mutex);
+		condition_done.wait(lock, [this] { return active_workers == 0; });
+		job = nullptr;
+	}
+
+	void parallel_thread_pool::process_ranges()
+	{
+		bool const previous_status = is_inside_parallel_for;
+		is_inside_parallel_for = true;
+
+		int const N = job_size;
+		int const grain_size = job_grain_size;
+		for (int k_begin = next_index.fetch_add(grain_size); k_begin < N; k_begin = next_index.fetch_add(grain_size))
+			(*job)(k_begin, std::min(k_begin + grain_size, N));
+
+		is_inside_parallel_for = previous_status;
+	}
+
+	void parallel_thread_pool::worker_loop(unsigned long long generation_start)
+	{
+		unsigned long long generation_done = generation_start;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition_start.wait(lock, [&] { return stop || generation != generation_done; });
+				if (stop)
+					return;
+				generation_done = generation;
+			}
+
+			process_ranges();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				active_workers--;
+			}
+			condition_done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <functional>
+
+namespace cgp
+{
+	// Number of threads used by parallel_for (including the calling thread)
+	//  Default value is the number of hardware threads. Setting 1 disables multithreading.
+	int parallel_number_of_threads();
+	void parallel_set_number_of_threads(int N_thread);
+
+	/** Call f(k_begin, k_end) on consecutive ranges covering [0,N[ using a persistent pool of threads
+	* - The ranges (of size grain_size, except for the last one) are dynamically distributed to the threads as soon as they become idle.
+	* - The calling thread also processes ranges, and the function only returns once the full interval has been processed.
+	* - Each index is processed exactly once. The order of processing between ranges is not specified: f must only write to data associated to its own range.
+	* - Calls from within f (nested parallel_for) are executed serially by the current thread. */
+	void parallel_for(int N, std::function<void(int, int)> const& f, int grain_size = 256);
+}
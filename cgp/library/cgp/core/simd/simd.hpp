@@ -0,0 +1,85 @@
+#pragma once
+
+// Minimal wrapper around SIMD registers of floats used by the batched kernels of cgp
+//  The width of simd_float depends on the instruction set enabled at compile time:
+//   - AVX  (ex. -mavx or /arch:AVX) : 8 floats
+//   - SSE2 (default on x86-64)       : 4 floats
+//   - otherwise                      : 1 float (scalar fallback)
+//  Define CGP_NO_SIMD to force the scalar fallback.
+//
+//  Typical use (N elements, remaining elements processed with the same code on the scalar type):
+//    for (k = 0; k + simd_float::size <= N; k += simd_float::size) { simd_float a = simd_float::load(&x[k]); ... }
+
+#if !defined(CGP_NO_SIMD) && defined(__AVX__)
+#define CGP_SIMD_AVX
+#include <immintrin.h>
+#elif !defined(CGP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CGP_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+namespace cgp
+{
+	// Scalar version - used as fallback, and for the remaining elements of a loop
+	struct simd_float_scalar
+	{
+		enum { size = 1 };
+		float v;
+
+		static simd_float_scalar load(float const* p) { return { *p }; }
+		static simd_float_scalar broadcast(float a) { return { a }; }
+		void store(float* p) const { *p = v; }
+	};
+	inline simd_float_scalar operator+(simd_float_scalar a, simd_float_scalar b) { return { a.v + b.v }; }
+	inline simd_float_scalar operator-(simd_float_scalar a, simd_float_scalar b) { return { a.v - b.v }; }
+	inline simd_float_scalar operator*(simd_float_scalar a, simd_float_scalar b) { return { a.v * b.v }; }
+	inline simd_float_scalar operator/(simd_float_scalar a, simd_float_scalar b) { return { a.v / b.v }; }
+	inline simd_float_scalar sqrt(simd_float_scalar a) { return { std::sqrt(a.v) }; }
+	inline simd_float_scalar min(simd_float_scalar a, simd_float_scalar b) { return { std::min(a.v, b.v) }; }
+	inline simd_float_scalar max(simd_float_scalar a, simd_float_scalar b) { return { std::max(a.v, b.v) }; }
+
+
+#if defined(CGP_SIMD_AVX)
+	struct simd_float
+	{
+		enum { size = 8 };
+		__m256 v;
+
+		static simd_float load(float const* p) { return { _mm256_loadu_ps(p) }; }
+		static simd_float broadcast(float a) { return { _mm256_set1_ps(a) }; }
+		void store(float* p) const { _mm256_storeu_ps(p, v); }
+	};
+	inline simd_float operator+(simd_float a, simd_float b) { return { _mm256_add_ps(a.v, b.v) }; }
+	inline simd_float operator-(simd_float a, simd_float b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	inline simd_float operator*(simd_float a, simd_float b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	inline simd_float operator/(simd_float a, simd_float b) { return { _mm256_div_ps(a.v, b.v) }; }
+	inline simd_float sqrt(simd_float a) { return { _mm256_sqrt_ps(a.v) }; }
+	inline simd_float min(simd_float a, simd_float b) { return { _mm256_min_ps(a.v, b.v) }; }
+	inline simd_float max(simd_float a, simd_float b) { return { _mm256_max_ps(a.v, b.v) }; }
+
+#elif defined(CGP_SIMD_SSE)
+	struct simd_float
+	{
+		enum { size = 4 };
+		__m128 v;
+
+		static simd_float load(float const* p) { return { _mm_loadu_ps(p) }; }
+		static simd_float broadcast(float a) { return { _mm_set1_ps(a) }; }
+		void store(float* p) const { _mm_storeu_ps(p, v); }
+	};
+	inline simd_float operator+(simd_float a, simd_float b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline simd_float operator-(simd_float a, simd_float b) { return { _mm_sub_ps(a.v, b.v) }; }
+	inline simd_float operator*(simd_float a, simd_float b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline simd_float operator/(simd_float a, simd_float b) { return { _mm_div_ps(a.v, b.v) }; }
+	inline simd_float sqrt(simd_float a) { return { _mm_sqrt_ps(a.v) }; }
+	inline simd_float min(simd_float a, simd_float b) { return { _mm_min_ps(a.v, b.v) }; }
+	inline simd_float max(simd_float a, simd_float b) { return { _mm_max_ps(a.v, b.v) }; }
+
+#else
+	using simd_float = simd_float_scalar;
+#endif
+
+}
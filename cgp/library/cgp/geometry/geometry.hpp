@@ -3,6 +3,7 @@
 #include "vec/vec.hpp"
 #include "mat/mat.hpp"
 #include "transform/transform.hpp"
+#include "vec/vec3_array/vec3_array.hpp"
 #include "shape/shape.hpp"
 #include "quaternion/quaternion.hpp"
 #include "interpolation/interpolation.hpp"
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/simd/simd.hpp"
+
+#include "bounding_volume.hpp"
+
+namespace cgp
+{
+	bounding_sphere bounding_sphere_compute(vec3 const* position, int N)
+	{
+		bounding_sphere s;
+		if (N <= 0)
+			return s;
+
+		vec3 p_min = position[0];
+		vec3 p_max = position[0];
+		for (int k = 1; k < N; ++k) {
+			vec3 const& p = position[k];
+			p_min = { std::min(p_min.x, p.x), std::min(p_min.y, p.y), std::min(p_min.z, p.z) };
+			p_max = { std::max(p_max.x, p.x), std::max(p_max.y, p.y), std::max(p_max.z, p.z) };
+		}
+
+		s.center = (p_min + p_max) / 2.0f;
+		float radius2 = 0.0f;
+		for (int k = 0; k < N; ++k)
+			radius2 = std::max(radius2, dot(position[k] - s.center, position[k] - s.center));
+		s.radius = std::sqrt(radius2);
+		return s;
+	}
+	bounding_sphere bounding_sphere_compute(numarray<vec3> const& position)
+	{
+		return bounding_sphere_compute(position.data.data(), int(position.size()));
+	}
+
+	bounding_sphere operator*(affine const& T, bounding_sphere const& s)
+	{
+		if (!s.valid())
+			return s;
+		float const scaling_max = std::max(std::max(std::abs(T.scaling_xyz.x), std::abs(T.scaling_xyz.y)), std::abs(T.scaling_xyz.z));
+		return bounding_sphere{ T * s.center, std::abs(T.scaling) * scaling_max * s.radius };
+	}
+	bounding_sphere operator*(affine_rts const& T, bounding_sphere const& s)
+	{
+		if (!s.valid())
+			return s;
+		return bounding_sphere{ T * s.center, std::abs(T.scaling) * s.radius };
+	}
+
+
+	frustum_planes::frustum_planes()
+	{
+		for (int k = 0; k < 6; ++k) {
+			a[k] = 0.0f; b[k] = 0.0f; c[k] = 0.0f; d[k] = 1.0f;
+		}
+	}
+
+	// Planes extracted from the rows of the matrix: a point p is inside the clip volume if -w <= x,y,z <= w
+	//  Each inequality row_3.p +/- row_i.p >= 0 is a plane in world space
+	frustum_planes::frustum_planes(mat4 const& M)
+	{
+		for (int k = 0; k < 6; ++k) {
+			int const row = k / 2;
+			float const sign = (k % 2 == 0) ? 1.0f : -1.0f;
+			float const pa = M.at(3, 0) + sign * M.at(row, 0);
+			float const pb = M.at(3, 1) + sign * M.at(row, 1);
+			float const pc = M.at(3, 2) + sign * M.at(row, 2);
+			float const pd = M.at(3, 3) + sign * M.at(row, 3);
+
+			float const n = std::sqrt(pa * pa + pb * pb + pc * pc);
+			assert_cgp(n > 1e-8f, "Degenerated frustum plane in the matrix projection*view");
+			a[k] = pa / n; b[k] = pb / n; c[k] = pc / n; d[k] = pd / n;
+		}
+	}
+
+	float frustum_planes::distance(int k, vec3 const& p) const
+	{
+		return a[k] * p.x + b[k] * p.y + c[k] * p.z + d[k];
+	}
+
+	bool is_visible(frustum_planes const& frustum, bounding_sphere const& s)
+	{
+		if (!s.valid())
+			return true;
+		for (int k = 0; k < 6; ++k)
+			if (frustum.distance(k, s.center) + s.radius < 0.0f)
+				return false;
+		return true;
+	}
+
+
+	// The sphere is visible if min_k (distance(k, center) + radius) >= 0
+	//  The minimum is computed on SIMD registers and its sign is tested on each element
+	template <typename F>
+	static int frustum_cull_block(char* visible, frustum_planes const& frustum, float const* x, float const* y, float const* z, float const* r, int k)
+	{
+		int const W = F::size;
+		F const X = F::load(x + k), Y = F::load(y + k), Z = F::load(z + k), R = F::load(r + k);
+		F m = F::broadcast(frustum.a[0]) * X + F::broadcast(frustum.b[0]) * Y + F::broadcast(frustum.c[0]) * Z + F::broadcast(frustum.d[0]);
+		for (int p = 1; p < 6; ++p)
+			m = min(m, F::broadcast(frustum.a[p]) * X + F::broadcast(frustum.b[p]) * Y + F::broadcast(frustum.c[p]) * Z + F::broadcast(frustum.d[p]));
+
+		float margin[W];
+		(m + R).store(margin);
+
+		int N_visible = 0;
+		for (int i = 0; i < W; ++i) {
+			char const v = (margin[i] >= 0.0f || r[k + i] < 0.0f) ? 1 : 0;
+			visible[k + i] = v;
+			N_visible += v;
+		}
+		return N_visible;
+	}
+
+	int frustum_cull(char* visible, frustum_planes const& frustum, float const* center_x, float const* center_y, float const* center_z, float const* radius, int N)
+	{
+		int N_visible = 0;
+		int k = 0;
+		for (; k + simd_float::size <= N; k += simd_float::size)
+			N_visible += frustum_cull_block<simd_float>(visible, frustum, center_x, center_y, center_z, radius, k);
+		for (; k < N; ++k)
+			N_visible += frustum_cull_block<simd_float_scalar>(visible, frustum, center_x, center_y, center_z, radius, k);
+		return N_visible;
+	}
+}
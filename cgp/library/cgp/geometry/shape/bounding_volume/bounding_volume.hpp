@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cgp/geometry/vec/vec.hpp"
+#include "cgp/geometry/mat/mat.hpp"
+#include "cgp/geometry/transform/affine/affine.hpp"
+#include "cgp/core/array/numarray/numarray.hpp"
+
+namespace cgp
+{
+	// Sphere containing a shape
+	//  A negative radius designates an unknown extent: the shape is considered as always visible
+	struct bounding_sphere
+	{
+		vec3 center = { 0,0,0 };
+		float radius = -1.0f;
+
+		bool valid() const { return radius >= 0.0f; }
+	};
+
+	// Sphere centered on the middle of the axis-aligned bounding box of the positions
+	bounding_sphere bounding_sphere_compute(vec3 const* position, int N);
+	bounding_sphere bounding_sphere_compute(numarray<vec3> const& position);
+
+	// Sphere containing the transformed sphere (the radius is scaled by the largest scaling factor)
+	bounding_sphere operator*(affine const& T, bounding_sphere const& s);
+	bounding_sphere operator*(affine_rts const& T, bounding_sphere const& s);
+
+
+	// The 6 planes of the view frustum defined by the matrix (projection * view)
+	//  Plane k: a[k] x + b[k] y + c[k] z + d[k] = 0, with a normal of unit norm pointing inside the frustum
+	//  The coefficients are stored per component to be broadcasted in the batched test.
+	struct frustum_planes
+	{
+		float a[6];
+		float b[6];
+		float c[6];
+		float d[6];
+
+		frustum_planes();
+		explicit frustum_planes(mat4 const& projection_view);
+
+		// Signed distance from the point p to the plane k (positive inside)
+		float distance(int k, vec3 const& p) const;
+	};
+
+	// True if the sphere intersects the frustum (conservative test: may be true for a sphere near a corner of the frustum)
+	bool is_visible(frustum_planes const& frustum, bounding_sphere const& s);
+
+	// Batched test of N spheres stored per component (center_x[k], center_y[k], center_z[k], radius[k])
+	//  Set visible[k] to 1 if the sphere k intersects the frustum, 0 otherwise. Returns the number of visible spheres.
+	//  Same result as is_visible() on each sphere, several spheres being tested per SIMD instruction (see simd_float).
+	int frustum_cull(char* visible, frustum_planes const& frustum, float const* center_x, float const* center_y, float const* center_z, float const* radius, int N);
+}
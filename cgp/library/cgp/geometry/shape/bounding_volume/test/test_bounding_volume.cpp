@@ -0,0 +1,60 @@
+#include "test_bounding_volume.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/geometry/transform/projection/projection.hpp"
+#include "../bounding_volume.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_bounding_volume()
+	{
+		// Sphere of a set of points, and its transformation
+		{
+			numarray<vec3> const position = { {0,0,0}, {2,0,0}, {2,2,0}, {0,2,2} };
+			bounding_sphere const s = bounding_sphere_compute(position);
+			assert_cgp_no_msg(is_equal(s.center, vec3(1, 1, 1)));
+			assert_cgp_no_msg(is_equal(s.radius, std::sqrt(3.0f)));
+			assert_cgp_no_msg(!bounding_sphere_compute(numarray<vec3>()).valid());
+
+			affine_rts const T(rotation_transform::from_axis_angle({ 0,0,1 }, 0.5f), { 1,2,3 }, 2.0f);
+			bounding_sphere const s_T = T * s;
+			assert_cgp_no_msg(is_equal(s_T.center, T * s.center));
+			assert_cgp_no_msg(is_equal(s_T.radius, 2.0f * s.radius));
+
+			affine A;
+			A.scaling_xyz = { 1, 3, 0.5f };
+			assert_cgp_no_msg(is_equal((A * s).radius, 3.0f * s.radius));
+		}
+
+		// Camera at the origin looking toward -z
+		frustum_planes const frustum(projection_perspective(Pi / 2, 1.0f, 0.1f, 100.0f));
+		assert_cgp_no_msg(is_visible(frustum, bounding_sphere{ {0,0,-5}, 0.1f }));
+		assert_cgp_no_msg(!is_visible(frustum, bounding_sphere{ {0,0,5}, 1.0f }));
+		assert_cgp_no_msg(!is_visible(frustum, bounding_sphere{ {0,0,-200}, 1.0f }));
+		assert_cgp_no_msg(!is_visible(frustum, bounding_sphere{ {20,0,-5}, 1.0f }));
+		assert_cgp_no_msg(is_visible(frustum, bounding_sphere{ {20,0,-5}, 20.0f }));
+		assert_cgp_no_msg(is_visible(frustum, bounding_sphere{ {20,0,-5}, -1.0f }));
+
+		// The batched test gives the same result as the test of each sphere
+		//  (size that is not a multiple of the SIMD width)
+		int const N = 131;
+		std::vector<float> x(N), y(N), z(N), r(N);
+		for (int k = 0; k < N; ++k) {
+			x[k] = rand_interval(-20, 20); y[k] = rand_interval(-20, 20); z[k] = rand_interval(-20, 20);
+			r[k] = (k % 17 == 0) ? -1.0f : rand_interval(0, 3);
+		}
+		std::vector<char> visible(N);
+		int const N_visible = frustum_cull(visible.data(), frustum, x.data(), y.data(), z.data(), r.data(), N);
+
+		int N_visible_expected = 0;
+		for (int k = 0; k < N; ++k) {
+			bool const expected = is_visible(frustum, bounding_sphere{ {x[k], y[k], z[k]}, r[k] });
+			assert_cgp_no_msg(visible[k] == (expected ? 1 : 0));
+			N_visible_expected += expected ? 1 : 0;
+		}
+		assert_cgp_no_msg(N_visible == N_visible_expected);
+		assert_cgp_no_msg(N_visible > 0 && N_visible < N);
+	}
+}
@@ -0,0 +1,105 @@
+#include "block_min_max.hpp"
+
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	// Number of blocks needed to cover the voxels along an axis of N samples
+	static int number_of_blocks(int N, int block_size)
+	{
+		return N < 2 ? 0 : (N - 2) / block_size + 1;
+	}
+
+	// Compute the min/max of the blocks of the z-indices [bz_begin,bz_end[ within the range [b_min,b_max] (inclusive) along x and y
+	static void compute_blocks(block_min_max_3D& blocks, grid_3D<float> const& field, int3 const& b_min, int3 const& b_max, int bz_begin, int bz_end)
+	{
+		int const B = blocks.block_size;
+		int3 const& N = field.dimension;
+		float const* data = field.data.data.data();
+
+		for (int bz = bz_begin; bz < bz_end; ++bz) {
+			for (int by = b_min.y; by <= b_max.y; ++by) {
+				for (int bx = b_min.x; bx <= b_max.x; ++bx) {
+					int const x_end = std::min((bx + 1) * B, N.x - 1);
+					int const y_end = std::min((by + 1) * B, N.y - 1);
+					int const z_end = std::min((bz + 1) * B, N.z - 1);
+
+					float v_min = data[field.index_to_offset(bx * B, by * B, bz * B)];
+					float v_max = v_min;
+					for (int kz = bz * B; kz <= z_end; ++kz) {
+						for (int ky = by * B; ky <= y_end; ++ky) {
+							float const* row = data + field.index_to_offset(0, ky, kz);
+							for (int kx = bx * B; kx <= x_end; ++kx) {
+								v_min = std::min(v_min, row[kx]);
+								v_max = std::max(v_max, row[kx]);
+							}
+						}
+					}
+					blocks.value_min(bx, by, bz) = v_min;
+					blocks.value_max(bx, by, bz) = v_max;
+				}
+			}
+		}
+	}
+
+	block_min_max_3D::block_min_max_3D()
+		:field_dimension({ 0,0,0 })
+	{}
+
+	block_min_max_3D::block_min_max_3D(grid_3D<float> const& field, int block_size_arg)
+	{
+		build(field, block_size_arg);
+	}
+
+	int3 block_min_max_3D::dimension() const
+	{
+		return value_min.dimension;
+	}
+
+	bool block_min_max_3D::is_active(int bx, int by, int bz, float iso) const
+	{
+		return value_min(bx, by, bz) < iso && value_max(bx, by, bz) >= iso;
+	}
+
+	void block_min_max_3D::build(grid_3D<float> const& field, int block_size_arg)
+	{
+		assert_cgp(block_size_arg > 0, "Block size must be strictly positive");
+		block_size = block_size_arg;
+		field_dimension = field.dimension;
+
+		int3 const Nb = { number_of_blocks(field.dimension.x, block_size), number_of_blocks(field.dimension.y, block_size), number_of_blocks(field.dimension.z, block_size) };
+		value_min.resize(Nb);
+		value_max.resize(Nb);
+		if (Nb.x == 0 || Nb.y == 0 || Nb.z == 0)
+			return;
+
+		int3 const b_max = Nb - int3{ 1,1,1 };
+		parallel_for(Nb.z, [&](int bz_begin, int bz_end) {
+			compute_blocks(*this, field, { 0,0,0 }, b_max, bz_begin, bz_end);
+		}, 1);
+	}
+
+	void block_min_max_3D::update(grid_3D<float> const& field, int3 const& index_min, int3 const& index_max)
+	{
+		assert_cgp(is_equal(field.dimension, field_dimension), "The dimension of the field has changed since the block structure was built (call build instead of update)");
+
+		int3 const Nb = dimension();
+		if (Nb.x == 0 || Nb.y == 0 || Nb.z == 0)
+			return;
+
+		// A sample k is shared by the blocks (k-1)/B and k/B
+		int3 b_min, b_max;
+		for (int k = 0; k < 3; ++k) {
+			b_min[k] = std::max(index_min[k] - 1, 0) / block_size;
+			b_max[k] = std::min(std::max(index_max[k], 0) / block_size, Nb[k] - 1);
+			if (b_min[k] > b_max[k])
+				return;
+		}
+
+		parallel_for(b_max.z - b_min.z + 1, [&](int k_begin, int k_end) {
+			compute_blocks(*this, field, b_min, b_max, b_min.z + k_begin, b_min.z + k_end);
+		}, 1);
+	}
+}
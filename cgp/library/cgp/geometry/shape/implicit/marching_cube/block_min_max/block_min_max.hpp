@@ -0,0 +1,32 @@
+#pragma once
+
+#include "cgp/core/containers/grid/grid.hpp"
+
+namespace cgp {
+
+	/** Coarse acceleration structure storing the min and max values of a grid_3D<float> over blocks of voxels
+	* - A block of index (bx,by,bz) covers the voxels [b*block_size, (b+1)*block_size[ along each axis,
+	*   and therefore the samples [b*block_size, (b+1)*block_size] (the samples at the boundary are shared between neighboring blocks).
+	* - A block can only be crossed by the iso-surface if min < iso <= max. The other blocks are skipped by the marching cube.
+	* - When only a part of the field is modified, call update() on the modified region instead of rebuilding the full structure. */
+	struct block_min_max_3D
+	{
+		int block_size = 8;       // Number of voxels along each side of a block
+		int3 field_dimension;     // Dimension of the sampled field (number of samples)
+		grid_3D<float> value_min; // Min of the field over the samples of each block
+		grid_3D<float> value_max; // Max of the field over the samples of each block
+
+		block_min_max_3D();
+		block_min_max_3D(grid_3D<float> const& field, int block_size = 8);
+
+		// Compute the min/max of all the blocks
+		void build(grid_3D<float> const& field, int block_size = 8);
+		// Recompute the min/max of the blocks containing at least one of the samples in [index_min, index_max] (inclusive bounds)
+		void update(grid_3D<float> const& field, int3 const& index_min, int3 const& index_max);
+
+		// Number of blocks along each axis
+		int3 dimension() const;
+		// Whether the block may contain a voxel crossed by the iso-surface
+		bool is_active(int bx, int by, int bz, float iso) const;
+	};
+}
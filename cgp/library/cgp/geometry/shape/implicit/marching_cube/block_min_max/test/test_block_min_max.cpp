@@ -0,0 +1,57 @@
+#include "test_block_min_max.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../block_min_max.hpp"
+#include "../../indexed/marching_cube_indexed.hpp"
+
+#include <cstring>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static bool is_identical(marching_cube_buffer const& a, marching_cube_buffer const& b)
+	{
+		return a.position.size() == b.position.size() && a.connectivity.size() == b.connectivity.size()
+			&& std::memcmp(a.position.data.data(), b.position.data.data(), a.position.size() * sizeof(vec3)) == 0
+			&& std::memcmp(a.connectivity.data.data(), b.connectivity.data.data(), a.connectivity.size() * sizeof(uint3)) == 0;
+	}
+
+	void test_block_min_max()
+	{
+		// Dimension that is not a multiple of the block size
+		int3 const N = { 29, 21, 26 };
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, N);
+		grid_3D<float> field(N);
+		for (int kz = 0; kz < N.z; ++kz)
+			for (int ky = 0; ky < N.y; ++ky)
+				for (int kx = 0; kx < N.x; ++kx)
+					field(kx, ky, kz) = norm(domain.position({ kx, ky, kz }) - vec3{ 0.3f, 0.0f, 0.0f });
+
+		block_min_max_3D blocks(field, 4);
+		assert_cgp_no_msg(is_equal(blocks.dimension(), int3{ 7, 5, 7 }));
+
+		// The extraction on the active blocks is identical to the full extraction
+		marching_cube_buffer full, sparse;
+		marching_cube(full, field, domain, 0.3f);
+		marching_cube(sparse, field, domain, 0.3f, blocks);
+		assert_cgp_no_msg(full.connectivity.size() > 0);
+		assert_cgp_no_msg(is_identical(full, sparse));
+
+		// Local modification of the field (including samples on the boundary of the blocks and of the grid)
+		int3 const index_min = { 20, 8, 20 }, index_max = { 28, 16, 25 };
+		for (int kz = index_min.z; kz <= index_max.z; ++kz)
+			for (int ky = index_min.y; ky <= index_max.y; ++ky)
+				for (int kx = index_min.x; kx <= index_max.x; ++kx)
+					field(kx, ky, kz) = norm(domain.position({ kx, ky, kz }) - vec3{ 0.7f, 0.0f, 0.7f }) - 0.1f;
+		blocks.update(field, index_min, index_max);
+
+		block_min_max_3D const rebuilt(field, 4);
+		assert_cgp_no_msg(is_equal(blocks.value_min.data, rebuilt.value_min.data));
+		assert_cgp_no_msg(is_equal(blocks.value_max.data, rebuilt.value_max.data));
+
+		marching_cube(full, field, domain, 0.3f);
+		marching_cube(sparse, field, domain, 0.3f, blocks);
+		assert_cgp_no_msg(is_identical(full, sparse));
+	}
+}
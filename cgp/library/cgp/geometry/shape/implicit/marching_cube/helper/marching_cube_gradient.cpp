@@ -0,0 +1,31 @@
+#include "marching_cube_gradient.hpp"
+
+namespace cgp
+{
+	vec3 marching_cube_gradient(float const* field, int3 const& dimension, int3 const& index, vec3 const& voxel_length)
+	{
+		size_t const offset = index.x + size_t(dimension.x) * (index.y + size_t(dimension.y) * index.z);
+		size_t const stride[3] = { 1, size_t(dimension.x), size_t(dimension.x) * dimension.y };
+
+		vec3 gradient;
+		for (int k = 0; k < 3; ++k) {
+			int const k0 = index[k] > 0 ? index[k] - 1 : index[k];
+			int const k1 = index[k] < dimension[k] - 1 ? index[k] + 1 : index[k];
+			if (k0 == k1) {
+				gradient[k] = 0.0f;
+				continue;
+			}
+			float const f0 = field[offset - (index[k] - k0) * stride[k]];
+			float const f1 = field[offset + (k1 - index[k]) * stride[k]];
+			gradient[k] = (f1 - f0) / ((k1 - k0) * voxel_length[k]);
+		}
+		return gradient;
+	}
+
+	vec3 marching_cube_edge_normal(float const* field, int3 const& dimension, int3 const& index0, int3 const& index1, float alpha, vec3 const& voxel_length)
+	{
+		vec3 const g0 = marching_cube_gradient(field, dimension, index0, voxel_length);
+		vec3 const g1 = marching_cube_gradient(field, dimension, index1, voxel_length);
+		return normalize(-((1 - alpha) * g0 + alpha * g1), vec3{ 0,0,1 });
+	}
+}
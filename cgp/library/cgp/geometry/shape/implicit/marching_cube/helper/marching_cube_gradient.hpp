@@ -0,0 +1,14 @@
+#pragma once
+
+#include "cgp/geometry/vec/vec.hpp"
+
+namespace cgp {
+
+	// Gradient of the field at the grid sample of given index using central differences (one-sided differences on the border of the grid)
+	//  voxel_length is the distance between two consecutive samples along each axis
+	vec3 marching_cube_gradient(float const* field, int3 const& dimension, int3 const& index, vec3 const& voxel_length);
+
+	// Unit normal of the iso-surface at the vertex interpolated at (1-alpha) index0 + alpha index1 on a grid edge
+	//  The normal is oriented toward decreasing values of the field, consistently with the orientation of the triangles of the marching cube.
+	vec3 marching_cube_edge_normal(float const* field, int3 const& dimension, int3 const& index0, int3 const& index1, float alpha, vec3 const& voxel_length);
+}
@@ -0,0 +1,312 @@
+#include "marching_cube_indexed.hpp"
+
+#include "cgp/core/parallel/parallel.hpp"
+#include "cgp/geometry/shape/mesh/mesh.hpp"
+#include "../helper/marching_cubes_lut.hpp"
+#include "../helper/marching_cube_gradient.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	// Read-only description of the grid shared by all the slabs
+	struct marching_cube_grid
+	{
+		float const* field;
+		float iso;
+		int Nx, Ny, Nz;
+		vec3 domain_min;
+		vec3 domain_length;
+		vec3 d; // relative size of a voxel
+		vec3 voxel_length;
+
+		// Offset between the two extremities of an edge along the direction dir (0:x, 1:y, 2:z)
+		int step(int dir) const { return dir == 0 ? 1 : (dir == 1 ? Nx : Nx * Ny); }
+		bool is_inside(int offset) const { return field[offset] < iso; }
+
+		vec3 grid_position(int kx, int ky, int kz) const
+		{
+			return { domain_min.x + (kx * d.x) * domain_length.x, domain_min.y + (ky * d.y) * domain_length.y, domain_min.z + (kz * d.z) * domain_length.z };
+		}
+		
+		// Position of the vertex on the edge starting at the grid sample (kx,ky,kz) along the direction dir
+		vec3 edge_vertex(int kx, int ky, int kz, int dir) const
+		{
+			int const offset = kx + Nx * (ky + Ny * kz);
+			float const v0 = field[offset] - iso;
+			float const v1 = field[offset + step(dir)] - iso;
+			float const alpha = (0 - v0) / (v1 - v0);
+
+			vec3 const p0 = grid_position(kx, ky, kz);
+			vec3 const p1 = grid_position(kx + (dir == 0), ky + (dir == 1), kz + (dir == 2));
+			return (1 - alpha) * p0 + alpha * p1;
+		}
+
+		// Normal of the vertex on the edge starting at the grid sample (kx,ky,kz) along the direction dir, computed from the gradient of the field
+		vec3 edge_normal(int kx, int ky, int kz, int dir) const
+		{
+			int const offset = kx + Nx * (ky + Ny * kz);
+			float const v0 = field[offset] - iso;
+			float const v1 = field[offset + step(dir)] - iso;
+			float const alpha = (0 - v0) / (v1 - v0);
+
+			return marching_cube_edge_normal(field, { Nx, Ny, Nz }, { kx, ky, kz }, { kx + (dir == 0), ky + (dir == 1), kz + (dir == 2) }, alpha, voxel_length);
+		}
+
+		// Range of the edge starting points in a grid layer for a given direction
+		int x_max(int dir) const { return dir == 0 ? Nx - 1 : Nx; }
+		int y_max(int dir) const { return dir == 1 ? Ny - 1 : Ny; }
+
+		// Optional activity of the blocks of voxels (nullptr: all the voxels are processed)
+		unsigned char const* block_active = nullptr;
+		int block_size = 1;
+		int3 block_dimension;
+
+		// Call f(kx_begin, kx_end) on the ranges of the row (ky,kz) that lie in active blocks, the row being [0,x_end[
+		//  A sample (or the edge starting at it) is assigned to the block containing the voxel of same index,
+		//  the last samples of the grid being assigned to the last block. A crossed edge is therefore always in an active block.
+		template <typename F>
+		void for_each_active_range(int ky, int kz, int x_end, F const& f) const
+		{
+			if (block_active == nullptr) {
+				f(0, x_end);
+				return;
+			}
+			int const by = std::min(ky / block_size, block_dimension.y - 1);
+			int const bz = std::min(kz / block_size, block_dimension.z - 1);
+			unsigned char const* active = block_active + block_dimension.x * (by + block_dimension.y * bz);
+
+			int bx = 0;
+			while (bx < block_dimension.x) {
+				if (active[bx] == 0) { bx++; continue; }
+				int const bx_begin = bx;
+				while (bx < block_dimension.x && active[bx] != 0) bx++;
+				int const kx_end = bx == block_dimension.x ? x_end : std::min(bx * block_size, x_end);
+				f(bx_begin * block_size, kx_end);
+			}
+		}
+	};
+
+	// Number of triangles generated by each of the 256 voxel configurations
+	static std::array<int, 256> marching_cube_lut_triangle_count()
+	{
+		std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
+		std::array<int, 256> count;
+		for (int type = 0; type < 256; ++type) {
+			int k = 0;
+			while (triTable[type][k] != -1) k++;
+			count[type] = k / 3;
+		}
+		return count;
+	}
+
+	// Number of edges of direction dir in the grid layer kz crossed by the iso-surface
+	static int count_layer_edges(marching_cube_grid const& grid, int kz, int dir)
+	{
+		int counter = 0;
+		int const step = grid.step(dir);
+		for (int ky = 0; ky < grid.y_max(dir); ++ky) {
+			int const offset_row = grid.Nx * (ky + grid.Ny * kz);
+			grid.for_each_active_range(ky, kz, grid.x_max(dir), [&](int kx_begin, int kx_end) {
+				for (int kx = kx_begin; kx < kx_end; ++kx)
+					counter += grid.is_inside(offset_row + kx) != grid.is_inside(offset_row + kx + step);
+			});
+		}
+		return counter;
+	}
+
+	// Store in the slice the index of the vertex lying on each crossed edge of direction dir in the grid layer kz
+	//  The vertices are numbered from the offset of this (layer,direction) in the order of the edges.
+	//  The position (and the normal if not null) of the vertex is computed only if write_vertex is true (only one slab is responsible for each layer).
+	static void index_layer_edges(marching_cube_grid const& grid, int kz, int dir, int first_index, int* slice, vec3* position, vec3* normal, bool write_vertex)
+	{
+		int counter = first_index;
+		int const step = grid.step(dir);
+		for (int ky = 0; ky < grid.y_max(dir); ++ky) {
+			int const offset_row = grid.Nx * (ky + grid.Ny * kz);
+			grid.for_each_active_range(ky, kz, grid.x_max(dir), [&](int kx_begin, int kx_end) {
+				for (int kx = kx_begin; kx < kx_end; ++kx) {
+					if (grid.is_inside(offset_row + kx) != grid.is_inside(offset_row + kx + step)) {
+						slice[kx + grid.Nx * ky] = counter;
+						if (write_vertex) {
+							position[counter] = grid.edge_vertex(kx, ky, kz, dir);
+							if (normal != nullptr)
+								normal[counter] = grid.edge_normal(kx, ky, kz, dir);
+						}
+						counter++;
+					}
+				}
+			});
+		}
+	}
+
+	static void marching_cube_indexed(marching_cube_buffer& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, block_min_max_3D const* blocks, marching_cube_normal normal_type)
+	{
+		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
+
+		static std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
+		static std::array<int, 256> const triangle_count = marching_cube_lut_triangle_count();
+
+		marching_cube_grid grid;
+		grid.field = field.data.data.data();
+		grid.iso = iso;
+		grid.Nx = field.dimension.x; grid.Ny = field.dimension.y; grid.Nz = field.dimension.z;
+		grid.domain_min = domain.center - domain.length / 2.0;
+		grid.domain_length = domain.length;
+		grid.d = { 1 / (grid.Nx - 1.0f), 1 / (grid.Ny - 1.0f), 1 / (grid.Nz - 1.0f) };
+		grid.voxel_length = domain.voxel_length();
+
+		int const Nx = grid.Nx, Ny = grid.Ny, Nz = grid.Nz;
+		if (Nx < 2 || Ny < 2 || Nz < 2) {
+			buffer.position.resize(0); buffer.normal.resize(0); buffer.connectivity.resize(0);
+			return;
+		}
+
+		// Activity of the blocks for this iso-value
+		if (blocks != nullptr) {
+			assert_cgp(is_equal(blocks->field_dimension, field.dimension), "The block_min_max_3D structure doesn't correspond to the dimension of the field");
+			int3 const Nb = blocks->dimension();
+			buffer.block_active.resize(size_t(Nb.x) * Nb.y * Nb.z);
+			for (int bz = 0; bz < Nb.z; ++bz)
+				for (int by = 0; by < Nb.y; ++by)
+					for (int bx = 0; bx < Nb.x; ++bx)
+						buffer.block_active[bx + Nb.x * (by + Nb.y * size_t(bz))] = blocks->is_active(bx, by, bz, iso);
+
+			grid.block_active = buffer.block_active.data();
+			grid.block_size = blocks->block_size;
+			grid.block_dimension = Nb;
+		}
+
+		// Pass 1: Classify the voxels, and count the crossed edges and the triangles of each layer
+		// ******************************************* //
+		buffer.cube_type.resize(size_t(Nx - 1) * (Ny - 1) * (Nz - 1));
+		buffer.vertex_offset.assign(3 * Nz + 1, 0);
+		buffer.triangle_offset.assign(Nz, 0);
+
+		parallel_for(Nz, [&](int kz_begin, int kz_end) {
+			for (int kz = kz_begin; kz < kz_end; ++kz)
+			{
+				for (int dir = 0; dir < 3; ++dir)
+					buffer.vertex_offset[3 * kz + dir + 1] = (dir == 2 && kz == Nz - 1) ? 0 : count_layer_edges(grid, kz, dir);
+
+				if (kz == Nz - 1)
+					continue;
+
+				int counter_triangle = 0;
+				std::array<int, 8> const offset_cube = { 0, 1, 1 + Nx, Nx, Nx * Ny, 1 + Nx * Ny, 1 + Nx + Nx * Ny, Nx + Nx * Ny };
+				for (int ky = 0; ky < Ny - 1; ++ky) {
+					grid.for_each_active_range(ky, kz, Nx - 1, [&](int kx_begin, int kx_end) {
+						for (int kx = kx_begin; kx < kx_end; ++kx) {
+							int const offset = kx + Nx * (ky + Ny * kz);
+							int type = 0;
+							for (int k = 0; k < 8; ++k)
+								type |= int(grid.is_inside(offset + offset_cube[k])) << k;
+
+							buffer.cube_type[kx + (Nx - 1) * (ky + (Ny - 1) * size_t(kz))] = static_cast<unsigned char>(type);
+							counter_triangle += triangle_count[type];
+						}
+					});
+				}
+				buffer.triangle_offset[kz + 1] = counter_triangle;
+			}
+		}, 1);
+
+		// Exclusive prefix sums give the first index of each layer
+		for (size_t k = 1; k < buffer.vertex_offset.size(); ++k)
+			buffer.vertex_offset[k] += buffer.vertex_offset[k - 1];
+		for (size_t k = 1; k < buffer.triangle_offset.size(); ++k)
+			buffer.triangle_offset[k] += buffer.triangle_offset[k - 1];
+
+		buffer.position.resize(buffer.vertex_offset.back());
+		buffer.connectivity.resize(buffer.triangle_offset.back());
+		bool const gradient_normal = normal_type == marching_cube_normal::gradient;
+		if (gradient_normal)
+			buffer.normal.resize(buffer.vertex_offset.back());
+
+
+		// Pass 2: Compute the vertices and the triangles per slab of voxel layers
+		// ******************************************* //
+
+		// Location of the 12 edges of a voxel: slice (0,1: x,y edges of the bottom layer, 2: z edges, 3,4: x,y edges of the top layer) and offset in the slice
+		std::array<int, 12> const edge_slice = { 0, 1, 0, 1, 3, 4, 3, 4, 2, 2, 2, 2 };
+		std::array<int, 12> const edge_offset = { 0, 1, Nx, 0, 0, 1, Nx, 0, 0, 1, 1 + Nx, Nx };
+
+		int const N_slab = std::min(parallel_number_of_threads(), Nz - 1);
+		buffer.slice.resize(N_slab);
+		for (auto& slice : buffer.slice)
+			slice.resize(5 * size_t(Nx) * Ny);
+
+		parallel_for(N_slab, [&](int slab_begin, int slab_end) {
+			for (int slab = slab_begin; slab < slab_end; ++slab)
+			{
+				int const kz_begin = (slab * (Nz - 1)) / N_slab;
+				int const kz_end = ((slab + 1) * (Nz - 1)) / N_slab;
+
+				int* slice[5];
+				for (int k = 0; k < 5; ++k)
+					slice[k] = buffer.slice[slab].data() + k * size_t(Nx) * Ny;
+				int const* vertex_offset = buffer.vertex_offset.data();
+				vec3* position = buffer.position.data.data();
+				vec3* normal = gradient_normal ? buffer.normal.data.data() : nullptr;
+
+				// The first grid layer of the slab belongs to this slab
+				index_layer_edges(grid, kz_begin, 0, vertex_offset[3 * kz_begin], slice[0], position, normal, true);
+				index_layer_edges(grid, kz_begin, 1, vertex_offset[3 * kz_begin + 1], slice[1], position, normal, true);
+				index_layer_edges(grid, kz_begin, 2, vertex_offset[3 * kz_begin + 2], slice[2], position, normal, true);
+
+				for (int kz = kz_begin; kz < kz_end; ++kz)
+				{
+					// The top grid layer belongs to the next slab, except for the last layer of the grid
+					bool const write_top = kz + 1 < kz_end || kz + 1 == Nz - 1;
+					index_layer_edges(grid, kz + 1, 0, vertex_offset[3 * (kz + 1)], slice[3], position, normal, write_top);
+					index_layer_edges(grid, kz + 1, 1, vertex_offset[3 * (kz + 1) + 1], slice[4], position, normal, write_top);
+
+					// Triangles of the layer of voxels
+					uint3* triangle = buffer.connectivity.data.data() + buffer.triangle_offset[kz];
+					for (int ky = 0; ky < Ny - 1; ++ky) {
+						grid.for_each_active_range(ky, kz, Nx - 1, [&](int kx_begin, int kx_end) {
+							for (int kx = kx_begin; kx < kx_end; ++kx) {
+								int const type = buffer.cube_type[kx + (Nx - 1) * (ky + (Ny - 1) * size_t(kz))];
+								if (type == 0 || type == 255)
+									continue;
+
+								int const offset_slice = kx + Nx * ky;
+								for (int k = 0; triTable[type][k] != -1; k += 3) {
+									int const e0 = triTable[type][k], e1 = triTable[type][k + 1], e2 = triTable[type][k + 2];
+									*triangle = {
+										static_cast<unsigned int>(slice[edge_slice[e0]][offset_slice + edge_offset[e0]]),
+										static_cast<unsigned int>(slice[edge_slice[e1]][offset_slice + edge_offset[e1]]),
+										static_cast<unsigned int>(slice[edge_slice[e2]][offset_slice + edge_offset[e2]]) };
+									triangle++;
+								}
+							}
+						});
+					}
+
+					// The top layer becomes the bottom layer of the next voxel layer
+					std::swap(slice[0], slice[3]);
+					std::swap(slice[1], slice[4]);
+					if (kz + 1 < kz_end)
+						index_layer_edges(grid, kz + 1, 2, vertex_offset[3 * (kz + 1) + 2], slice[2], position, normal, true);
+				}
+			}
+		}, 1);
+
+		if (gradient_normal)
+			return;
+		if (buffer.connectivity.size() > 0)
+			normal_per_vertex(buffer.position, buffer.connectivity, buffer.normal);
+		else
+			buffer.normal.resize(0);
+	}
+
+	void marching_cube(marching_cube_buffer& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, marching_cube_normal normal_type)
+	{
+		marching_cube_indexed(buffer, field, domain, iso, nullptr, normal_type);
+	}
+
+	void marching_cube(marching_cube_buffer& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, block_min_max_3D const& blocks, marching_cube_normal normal_type)
+	{
+		marching_cube_indexed(buffer, field, domain, iso, &blocks, normal_type);
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "cgp/core/containers/grid/grid.hpp"
+#include "cgp/geometry/shape/spatial_domain/spatial_domain.hpp"
+#include "../block_min_max/block_min_max.hpp"
+
+#include <vector>
+
+namespace cgp {
+
+	/** Computation of the per-vertex normals of the marching cube
+	* - triangles: average of the normals of the adjacent triangles (see normal_per_vertex), computed after the extraction
+	* - gradient: normalized gradient of the field (central differences) interpolated along the edge, computed at the same time as the position */
+	enum class marching_cube_normal { triangles, gradient };
+
+	/** Output and reusable storage of the indexed marching cube marching_cube(marching_cube_buffer&, ...)
+	* The extracted mesh has shared vertices: there is one vertex per edge of the grid crossed by the iso-surface.
+	* The buffer is owned by the caller and is expected to be kept from one call to the next (ex. when re-meshing an animated field every frame):
+	*   the memory is only reallocated when the extracted surface becomes larger than all the previous ones. */
+	struct marching_cube_buffer
+	{
+		// Output mesh data
+		numarray<vec3> position;
+		numarray<vec3> normal;
+		numarray<uint3> connectivity;
+
+		// Internal storage reused between calls
+		std::vector<unsigned char> cube_type;   // configuration (0-255) of each voxel
+		std::vector<int> vertex_offset;         // index of the first vertex of each (grid layer, edge direction)
+		std::vector<int> triangle_offset;       // index of the first triangle of each layer of voxels
+		std::vector<std::vector<int> > slice;   // per-slab cache storing the index of the vertex on each edge of two consecutive grid layers
+		std::vector<unsigned char> block_active; // blocks that may be crossed by the iso-surface (when a block_min_max_3D is used)
+	};
+
+	/** Marching cube generating a mesh with shared vertices into a reusable buffer
+	* - The grid is split in slabs along z that are processed in parallel (see parallel_for). The vertices and triangles are
+	*   numbered in a fixed order, so that the result doesn't depend on the number of threads.
+	* - The per-vertex normals are computed either from the triangles, or from the gradient of the field (see marching_cube_normal). */
+	void marching_cube(marching_cube_buffer& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, marching_cube_normal normal_type = marching_cube_normal::triangles);
+
+	/** Same as above, but only visits the blocks of voxels that can contain the iso-value according to the block min/max structure.
+	* The cost becomes proportional to the size of the surface for mostly empty fields. The output is identical to the version without blocks.
+	* The block structure must be up to date with the field (see block_min_max_3D::update). */
+	void marching_cube(marching_cube_buffer& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, block_min_max_3D const& blocks, marching_cube_normal normal_type = marching_cube_normal::triangles);
+}
@@ -0,0 +1,143 @@
+#include "test_marching_cube_indexed.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "../marching_cube_indexed.hpp"
+#include "../../marching_cube.hpp"
+
+#include <cstring>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static bool is_identical(marching_cube_buffer const& a, marching_cube_buffer const& b)
+	{
+		return a.position.size() == b.position.size() && a.normal.size() == b.normal.size() && a.connectivity.size() == b.connectivity.size()
+			&& std::memcmp(a.position.data.data(), b.position.data.data(), a.position.size() * sizeof(vec3)) == 0
+			&& std::memcmp(a.normal.data.data(), b.normal.data.data(), a.normal.size() * sizeof(vec3)) == 0
+			&& std::memcmp(a.connectivity.data.data(), b.connectivity.data.data(), a.connectivity.size() * sizeof(uint3)) == 0;
+	}
+
+	// Two overlapping spheres of radius 0.3 around c0 and c1
+	static grid_3D<float> two_spheres_field(spatial_domain_grid_3D const& domain, vec3 const& c0, vec3 const& c1)
+	{
+		int3 const N = domain.samples;
+		grid_3D<float> field(N);
+		for (int kz = 0; kz < N.z; ++kz)
+			for (int ky = 0; ky < N.y; ++ky)
+				for (int kx = 0; kx < N.x; ++kx) {
+					vec3 const p = domain.position({ kx, ky, kz });
+					field(kx, ky, kz) = std::min(norm(p - c0), norm(p - c1));
+				}
+		return field;
+	}
+
+	static bool is_same_triangle(vec3 const* a, vec3 const* b, float tolerance)
+	{
+		// Same triangle up to a circular permutation of its vertices (the orientation must be kept)
+		for (int shift = 0; shift < 3; ++shift) {
+			bool same = true;
+			for (int k = 0; k < 3 && same; ++k)
+				same = norm(a[k] - b[(k + shift) % 3]) < tolerance;
+			if (same)
+				return true;
+		}
+		return false;
+	}
+
+	// The indexed mesh expanded through its connectivity gives the same triangles as the triangle soup version
+	static void check_same_triangles(marching_cube_buffer const& buffer, grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso)
+	{
+		std::vector<vec3> soup;
+		size_t const N_soup = marching_cube(soup, field.data.data, domain, iso);
+		size_t const N_triangle = buffer.connectivity.size();
+		assert_cgp_no_msg(N_soup == 3 * N_triangle);
+
+		std::vector<vec3> expanded(3 * N_triangle);
+		for (size_t k = 0; k < N_triangle; ++k)
+			for (int i = 0; i < 3; ++i)
+				expanded[3 * k + i] = buffer.position[buffer.connectivity[k][i]];
+
+		// The triangles are not generated in the same order: each soup triangle is matched to a distinct indexed triangle
+		std::vector<bool> used(N_triangle, false);
+		for (size_t k_soup = 0; k_soup < N_triangle; ++k_soup) {
+			bool found = false;
+			for (size_t k = 0; k < N_triangle && !found; ++k) {
+				if (!used[k] && is_same_triangle(&soup[3 * k_soup], &expanded[3 * k], 1e-5f)) {
+					used[k] = true;
+					found = true;
+				}
+			}
+			assert_cgp_no_msg(found);
+		}
+	}
+
+	void test_marching_cube_indexed()
+	{
+		float const iso = 0.3f;
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { 13, 11, 15 });
+		grid_3D<float> const field = two_spheres_field(domain, { -0.2f, 0.0f, 0.1f }, { 0.25f, 0.1f, -0.2f });
+
+		int const N_thread_initial = parallel_number_of_threads();
+
+		// Same triangles as the triangle soup, and identical result for any number of threads
+		marching_cube_buffer reference;
+		for (int N_thread : { 1, 2, 4 }) {
+			parallel_set_number_of_threads(N_thread);
+
+			marching_cube_buffer buffer;
+			marching_cube(buffer, field, domain, iso);
+			assert_cgp_no_msg(buffer.connectivity.size() > 0);
+			check_same_triangles(buffer, field, domain, iso);
+
+			if (N_thread == 1)
+				reference = buffer;
+			assert_cgp_no_msg(is_identical(buffer, reference));
+		}
+
+		// Reused buffer: a larger extraction first, then the small one (twice), gives the same result as a new buffer
+		spatial_domain_grid_3D const domain_large = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { 24, 26, 22 });
+		grid_3D<float> const field_large = two_spheres_field(domain_large, { -0.3f, 0.2f, 0.0f }, { 0.4f, -0.1f, 0.3f });
+		for (int N_thread : { 1, 4 }) {
+			parallel_set_number_of_threads(N_thread);
+
+			marching_cube_buffer buffer;
+			marching_cube(buffer, field_large, domain_large, iso);
+			assert_cgp_no_msg(buffer.connectivity.size() > reference.connectivity.size());
+
+			marching_cube(buffer, field, domain, iso);
+			assert_cgp_no_msg(is_identical(buffer, reference));
+			marching_cube(buffer, field, domain, iso);
+			assert_cgp_no_msg(is_identical(buffer, reference));
+		}
+
+		parallel_set_number_of_threads(N_thread_initial);
+	}
+
+	void test_marching_cube_gradient_normal()
+	{
+		// Sphere of radius 0.6: the field decreases outward (as with a sum of blobs), so the normal points outward
+		vec3 const center = { 0.1f, -0.05f, 0.08f };
+		float const radius = 0.6f;
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { 41, 37, 45 });
+		int3 const N = domain.samples;
+		grid_3D<float> field(N);
+		for (int kz = 0; kz < N.z; ++kz)
+			for (int ky = 0; ky < N.y; ++ky)
+				for (int kx = 0; kx < N.x; ++kx)
+					field(kx, ky, kz) = radius - norm(domain.position({ kx, ky, kz }) - center);
+
+		marching_cube_buffer buffer;
+		marching_cube(buffer, field, domain, 0.0f, marching_cube_normal::gradient);
+		assert_cgp_no_msg(buffer.position.size() > 0);
+		assert_cgp_no_msg(buffer.normal.size() == buffer.position.size());
+
+		for (int k = 0; k < buffer.position.size(); ++k) {
+			vec3 const& p = buffer.position[k];
+			vec3 const& n = buffer.normal[k];
+			assert_cgp_no_msg(std::abs(norm(n) - 1.0f) < 1e-4f);
+			assert_cgp_no_msg(norm(n - (p - center) / norm(p - center)) < 1e-2f);
+		}
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	void test_marching_cube_indexed();
+	void test_marching_cube_gradient_normal();
+}
@@ -2,16 +2,11 @@
 
 #include "cgp/geometry/interpolation/interpolation.hpp"
 #include "helper/marching_cubes_lut.hpp"
-#include <unordered_map>
+#include "helper/marching_cube_gradient.hpp"
 
 namespace cgp
 {
 
-	// Helper structure to hash a pair of index (a,b) as a unique number
-	struct hash_edge {
-		size_t operator()(std::pair<int, int> const& key) const;
-	};
-
 	// Helper structure to store voxels information
 	struct cube_parameters {
 		std::array<size_t, 8> index;
@@ -20,64 +15,24 @@ namespace cgp
 	};
 
 
-	mesh marching_cube(grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso)
+	mesh marching_cube(grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, marching_cube_normal normal_type)
 	{
 		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
 
-		// Compute the marching cube
-		std::vector<vec3> position;
-		std::vector<marching_cube_relative_coordinates> relative;
-		int const N = marching_cube(position, field.data.data, domain, iso, &relative);
-
-
 		// Compute the mesh with non-duplicated vertices
-		mesh m;
-		int const N_triangle = N / 3;
-
-		// Storage avoiding to duplicate vertices at the same position if they are on the same voxel edge
-		std::unordered_map<std::pair<int, int>, int, hash_edge> unique_edge;
-
-		for (int k_tri = 0; k_tri < N_triangle; ++k_tri) {
+		marching_cube_buffer buffer;
+		marching_cube(buffer, field, domain, iso, normal_type);
 
-			uint3 triangle_index;
-			for (int k = 0; k < 3; ++k) {
-
-				int const idx = 3 * k_tri + k;
-
-				// The indices of the edge of the current vertex
-				std::pair<int, int> const edge = { relative[3 * k_tri+k].k0, relative[3 * k_tri+k].k1 };
-
-				// Check if this edge has already been encountered
-				auto const it = unique_edge.find(edge);
-
-				// if it is a new edge, add this vertex as a new one in the mesh
-				if (it == unique_edge.end()) {
-					int const idx_new_vertex = m.position.size(); // create a new vertex index
-					triangle_index[k] = idx_new_vertex; // set the current index to the triangle connectivity
-					m.position.push_back(position[idx]); // add this vertex in the mesh
-					unique_edge[edge] = idx_new_vertex; // add the edge in the unique structure for further check
-				}
-				// if the edge has already been encountered - only reuse the index in the connectivity but do not add the vertex again
-				else {
-					int const idx_existing_vertex = it->second;   // the index that has already be defined
-					triangle_index[k] = idx_existing_vertex;      // set this existing index in the triangle connectivity
-				}
-			}
-			m.connectivity.push_back(triangle_index); // add the new triangle
-			
-			
-		}
+		mesh m;
+		m.position = std::move(buffer.position);
+		m.normal = std::move(buffer.normal);
+		m.connectivity = std::move(buffer.connectivity);
 
 		m.fill_empty_field();
 		return m;
 	}
 
 
-	size_t hash_edge::operator()(std::pair<int, int> const& key) const {
-		return std::hash<int>{}(key.first) ^ std::hash<int>{}(key.second);
-	}
-
-
 	void fill_position(vec3& cube_position, float ux, float uy, float uz, vec3 const& domain_min, vec3 const& domain_length)
 	{
 		cube_position.x = domain_min.x + ux * domain_length.x;
@@ -102,13 +57,14 @@ namespace cgp
 
 
 
-	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative)
+	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative, std::vector<vec3>* normal)
 	{
 		// Table of correspondance between the 256 type of cube and the edges on which new vertices are created
 		static std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
 		// Storage of the order of edge visiting on the cube
 		static std::array<std::pair<int, int>, 12> const lut_edge_order = marching_cube_lut_edge_order();
 		static std::array<int, 256> const edgeTable = marching_cube_lut_edgeTable();
+		static std::array<int3, 8> const lut_offset_cube = marching_cube_lut_offset_cube();
 
 		vec3 const domain_min = domain.center - domain.length / 2.0;
 		vec3 const& domain_length = domain.length;
@@ -121,6 +77,9 @@ namespace cgp
 		float const dy = 1 / (Ny - 1.0f);
 		float const dz = 1 / (Nz - 1.0f);
 
+		int3 const dimension = domain.samples;
+		vec3 const voxel_length = domain.voxel_length();
+
 		size_t counter_position = 0;
 
 		// Marching-Cube
@@ -128,6 +87,7 @@ namespace cgp
 		cube_parameters cube;
 		std::array<vec3, 12> new_vertex;
 		std::array<float, 12> new_vertex_alpha;
+		std::array<vec3, 12> new_vertex_normal;
 
 		std::array<size_t, 8> const offset_cube = { 0, 1, 1+Nx, Nx, Nx*Ny, 1+Nx*Ny, 1+Nx+Nx*Ny, Nx+Nx*Ny };
 
@@ -211,6 +171,18 @@ namespace cgp
 
 
 
+						// Normals from the gradient of the field at the extremities of the edges
+						if (normal != nullptr) {
+							int3 const index_corner_3D = { int(kx), int(ky), int(kz) };
+							for (int k_edge = 0; k_edge < 12; ++k_edge) {
+								if (edgeTable[type] & (1 << k_edge)) {
+									int3 const i0 = index_corner_3D + lut_offset_cube[lut_edge_order[k_edge].first];
+									int3 const i1 = index_corner_3D + lut_offset_cube[lut_edge_order[k_edge].second];
+									new_vertex_normal[k_edge] = marching_cube_edge_normal(field.data(), dimension, i0, i1, new_vertex_alpha[k_edge], voxel_length);
+								}
+							}
+						}
+
 						// Construct the new triangles
 						for (size_t k = 0; triTable[type][k] != -1; k += 3) { // read the table of correspondance for the triangle
 
@@ -247,6 +219,15 @@ namespace cgp
 								(*relative)[counter_position+2].k1 = cube.index[lut_edge_order[idx2].second];
 							}
 
+							if (normal != nullptr) {
+								if (normal->size() < counter_position + 3)
+									normal->resize(1.5 * (counter_position + 3));
+
+								(*normal)[counter_position] = new_vertex_normal[triTable[type][k]];
+								(*normal)[counter_position + 1] = new_vertex_normal[triTable[type][k + 1]];
+								(*normal)[counter_position + 2] = new_vertex_normal[triTable[type][k + 2]];
+							}
+
 							counter_position += 3;
 
 						}
@@ -0,0 +1,128 @@
+#include "mesh_batch.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	void mesh_batch_builder::add(mesh const& m)
+	{
+		meshes.push_back(&m);
+		transforms.push_back(affine_rts());
+		has_transform.push_back(false);
+	}
+	void mesh_batch_builder::add(mesh const& m, affine_rts const& transform)
+	{
+		meshes.push_back(&m);
+		transforms.push_back(transform);
+		has_transform.push_back(true);
+	}
+	void mesh_batch_builder::clear()
+	{
+		meshes.clear();
+		transforms.clear();
+		has_transform.clear();
+	}
+	int mesh_batch_builder::size() const
+	{
+		return int(meshes.size());
+	}
+
+	// Copy the attribute of a mesh in the final buffer, or fill it with the default value if it is missing
+	template <typename T>
+	static void batch_copy_attribute(T* out, numarray<T> const& in, int N, T const& default_value)
+	{
+		if (in.size() == N)
+			std::copy(in.data.begin(), in.data.end(), out);
+		else
+			std::fill(out, out + N, default_value);
+	}
+
+	mesh mesh_batch_builder::build() const
+	{
+		int const N_mesh = size();
+
+		// Offsets of each mesh in the final buffers
+		std::vector<int> vertex_offset(N_mesh + 1, 0);
+		std::vector<int> triangle_offset(N_mesh + 1, 0);
+		bool any_normal = false, any_color = false, any_uv = false;
+		for (int k = 0; k < N_mesh; ++k) {
+			mesh const& m = *meshes[k];
+			int const N = m.position.size();
+			vertex_offset[k + 1] = vertex_offset[k] + N;
+			triangle_offset[k + 1] = triangle_offset[k] + m.connectivity.size();
+			any_normal = any_normal || (N > 0 && m.normal.size() == N);
+			any_color = any_color || (N > 0 && m.color.size() == N);
+			any_uv = any_uv || (N > 0 && m.uv.size() == N);
+		}
+
+		mesh batch;
+		batch.position.resize(vertex_offset[N_mesh]);
+		batch.connectivity.resize(triangle_offset[N_mesh]);
+		if (any_normal) batch.normal.resize(vertex_offset[N_mesh]);
+		if (any_color) batch.color.resize(vertex_offset[N_mesh]);
+		if (any_uv) batch.uv.resize(vertex_offset[N_mesh]);
+
+		parallel_for(N_mesh, [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k) {
+				mesh const& m = *meshes[k];
+				int const N = m.position.size();
+				int const v0 = vertex_offset[k];
+				affine_rts const& T = transforms[k];
+
+				vec3* position = batch.position.data.data() + v0;
+				if (has_transform[k])
+					for (int i = 0; i < N; ++i)
+						position[i] = T * m.position.at(i);
+				else
+					batch_copy_attribute(position, m.position, N, vec3());
+
+				if (any_normal) {
+					vec3* normal = batch.normal.data.data() + v0;
+					if (m.normal.size() == N)
+						batch_copy_attribute(normal, m.normal, N, vec3());
+					else if (N > 0 && m.connectivity.size() > 0) {
+						numarray<vec3> const n = normal_per_vertex(m.position, m.connectivity);
+						batch_copy_attribute(normal, n, N, vec3());
+					}
+					if (has_transform[k]) {
+						// Normals only follow the rotation (the scaling is uniform), and are flipped by a negative scaling
+						float const sign = T.scaling < 0 ? -1.0f : 1.0f;
+						for (int i = 0; i < N; ++i)
+							normal[i] = sign * (T.rotation * normal[i]);
+					}
+				}
+				if (any_color)
+					batch_copy_attribute(batch.color.data.data() + v0, m.color, N, vec3{ 1.0f, 1.0f, 1.0f });
+				if (any_uv)
+					batch_copy_attribute(batch.uv.data.data() + v0, m.uv, N, vec2{ 0.0f, 0.0f });
+
+				uint3* connectivity = batch.connectivity.data.data() + triangle_offset[k];
+				unsigned int const offset = static_cast<unsigned int>(v0);
+				int const N_triangle = m.connectivity.size();
+				for (int i = 0; i < N_triangle; ++i) {
+					uint3 const& tri = m.connectivity.at(i);
+					connectivity[i] = { tri.x + offset, tri.y + offset, tri.z + offset };
+				}
+			}
+		}, 1);
+
+		return batch;
+	}
+
+	mesh mesh_batch(numarray<mesh> const& meshes, numarray<affine_rts> const& transforms)
+	{
+		assert_cgp(transforms.size() == 0 || transforms.size() == meshes.size(), "The number of transforms (" + str(transforms.size()) + ") must be 0 or equal to the number of meshes (" + str(meshes.size()) + ")");
+
+		mesh_batch_builder builder;
+		for (int k = 0; k < meshes.size(); ++k) {
+			if (transforms.size() > 0)
+				builder.add(meshes[k], transforms[k]);
+			else
+				builder.add(meshes[k]);
+		}
+		return builder.build();
+	}
+}
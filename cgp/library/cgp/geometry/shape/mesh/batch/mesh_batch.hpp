@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../structure/mesh.hpp"
+#include "cgp/geometry/transform/affine/affine_rts/affine_rts.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	/** Merge a set of meshes into a single one (ex. batching of static geometry drawn with a single mesh_drawable)
+	* - The meshes are referenced when added: they must remain valid until build() is called.
+	* - An optional affine_rts is applied to the position and normal of each mesh.
+	* - The size of the final mesh is computed first, the buffers are allocated once, and the meshes are copied in parallel (see parallel_for).
+	* - A per-vertex attribute that is missing in some meshes (empty buffer) is filled as in mesh::fill_empty_field for these meshes,
+	*   an attribute that is missing in all meshes remains empty.
+	*
+	* Typical use:
+	*   mesh_batch_builder batch;
+	*   for (...) batch.add(tree, affine_rts(rotation_transform(), p, 1.0f));
+	*   mesh forest = batch.build(); */
+	struct mesh_batch_builder
+	{
+		void add(mesh const& m);
+		void add(mesh const& m, affine_rts const& transform);
+		void clear();
+		int size() const;
+
+		mesh build() const;
+
+	private:
+		std::vector<mesh const*> meshes;
+		std::vector<affine_rts> transforms;
+		std::vector<bool> has_transform;
+	};
+
+	/** Merge the meshes (with an optional transform per mesh, either empty or of the same size as meshes) */
+	mesh mesh_batch(numarray<mesh> const& meshes, numarray<affine_rts> const& transforms = {});
+}
@@ -0,0 +1,120 @@
+#include "test_mesh_batch.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "../mesh_batch.hpp"
+#include "cgp/geometry/shape/mesh/primitive/mesh_primitive.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	template <typename T>
+	static bool is_same_array(numarray<T> const& a, numarray<T> const& b)
+	{
+		if (a.size() != b.size())
+			return false;
+		for (int k = 0; k < a.size(); ++k)
+			if (!is_equal(a[k], b[k]))
+				return false;
+		return true;
+	}
+	static bool is_same_mesh(mesh const& a, mesh const& b)
+	{
+		if (a.connectivity.size() != b.connectivity.size())
+			return false;
+		for (int k = 0; k < a.connectivity.size(); ++k)
+			if (a.connectivity[k].x != b.connectivity[k].x || a.connectivity[k].y != b.connectivity[k].y || a.connectivity[k].z != b.connectivity[k].z)
+				return false;
+		return is_same_array(a.position, b.position) && is_same_array(a.normal, b.normal) && is_same_array(a.color, b.color) && is_same_array(a.uv, b.uv);
+	}
+
+	// Reference: per-mesh loop filling the missing attributes, applying the transform, and concatenating with mesh::push_back
+	static mesh mesh_batch_reference(numarray<mesh> const& meshes, numarray<affine_rts> const& transforms)
+	{
+		bool any_normal = false, any_color = false, any_uv = false;
+		for (mesh const& m : meshes) {
+			int const N = m.position.size();
+			any_normal = any_normal || (N > 0 && m.normal.size() == N);
+			any_color = any_color || (N > 0 && m.color.size() == N);
+			any_uv = any_uv || (N > 0 && m.uv.size() == N);
+		}
+
+		mesh batch;
+		for (int k = 0; k < meshes.size(); ++k) {
+			mesh m = meshes[k];
+			int const N = m.position.size();
+			if (m.normal.size() != N)
+				m.normal = normal_per_vertex(m.position, m.connectivity);
+			if (m.color.size() != N)
+				m.color = numarray<vec3>(N).fill({ 1,1,1 });
+			if (m.uv.size() != N)
+				m.uv = numarray<vec2>(N).fill({ 0,0 });
+
+			if (transforms.size() > 0) {
+				affine_rts const& T = transforms[k];
+				float const sign = T.scaling < 0 ? -1.0f : 1.0f;
+				for (int i = 0; i < N; ++i) {
+					m.position[i] = T * m.position[i];
+					m.normal[i] = sign * (T.rotation * m.normal[i]);
+				}
+			}
+
+			if (!any_normal) m.normal.clear();
+			if (!any_color) m.color.clear();
+			if (!any_uv) m.uv.clear();
+			batch.push_back(m);
+		}
+		return batch;
+	}
+
+	void test_mesh_batch()
+	{
+		// Full mesh, mesh without normal (computed from the connectivity), mesh without uv, degenerate triangles,
+		//  vertices without triangle, and empty meshes
+		mesh torus = mesh_primitive_torus(1.0f, 0.2f, { 0,0,0 }, { 0,0,1 }, 30, 10);
+		mesh grid = mesh_primitive_grid();
+		grid.normal.clear();
+		mesh cube = mesh_primitive_cube();
+		cube.uv.clear();
+		mesh degenerate;
+		degenerate.position = { {0,0,0}, {1,0,0}, {0,1,0}, {2,0,0} };
+		degenerate.connectivity = { {0,1,2}, {0,0,1}, {0,1,3} };
+		mesh points;
+		points.position = { {1,2,3}, {4,5,6} };
+		mesh const empty;
+
+		numarray<mesh> const meshes = { torus, empty, grid, degenerate, cube, points, empty };
+		numarray<affine_rts> transforms;
+		for (int k = 0; k < meshes.size(); ++k)
+			transforms.push_back(affine_rts(rotation_transform::from_axis_angle(normalize(vec3(1, k, 2)), 0.3f * k), { float(k),1,-2 }, k == 3 ? -0.5f : 1.0f + 0.1f * k));
+
+		int const N_thread_initial = parallel_number_of_threads();
+		for (int N_thread : { 1, 4 }) {
+			parallel_set_number_of_threads(N_thread);
+			assert_cgp_no_msg(is_same_mesh(mesh_batch(meshes), mesh_batch_reference(meshes, {})));
+			assert_cgp_no_msg(is_same_mesh(mesh_batch(meshes, transforms), mesh_batch_reference(meshes, transforms)));
+		}
+		parallel_set_number_of_threads(N_thread_initial);
+
+		// Attributes missing in all meshes remain empty
+		mesh const b = mesh_batch({ degenerate, points });
+		assert_cgp_no_msg(b.position.size() == 6 && b.connectivity.size() == 3);
+		assert_cgp_no_msg(b.normal.size() == 0 && b.color.size() == 0 && b.uv.size() == 0);
+		assert_cgp_no_msg(b.connectivity[2].x == 0 && b.connectivity[2].z == 3);
+
+		// Empty meshes only, and no mesh
+		mesh const b_empty = mesh_batch({ empty, empty });
+		assert_cgp_no_msg(b_empty.position.size() == 0 && b_empty.connectivity.size() == 0);
+		mesh_batch_builder builder;
+		assert_cgp_no_msg(builder.build().position.size() == 0);
+
+		// The builder references the meshes
+		builder.add(torus);
+		builder.add(points, transforms[1]);
+		assert_cgp_no_msg(builder.size() == 2);
+		assert_cgp_no_msg(is_same_mesh(builder.build(), mesh_batch_reference({ torus, points }, { affine_rts(), transforms[1] })));
+		builder.clear();
+		assert_cgp_no_msg(builder.size() == 0);
+	}
+}
@@ -0,0 +1,253 @@
+#include "binary.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/files/files.hpp"
+#include "../obj/obj.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cgp
+{
+	static uint32_t const mesh_binary_version = 1;
+	static char const mesh_binary_magic[8] = { 'C','G','P','M','E','S','H','\0' };
+	static size_t const mesh_binary_alignment = 64;
+
+	// Header at the beginning of the file (all values are little-endian)
+	struct mesh_binary_header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t endianness;     // 0x01020304 written by the host
+		uint64_t source_hash;
+		uint64_t source_size;
+		uint32_t N_element[5];   // position, normal, color, uv, connectivity
+		uint32_t padding;
+		uint64_t offset[5];      // offset in bytes of each block from the beginning of the file
+	};
+	static_assert(sizeof(mesh_binary_header) == 96, "Unexpected size of mesh_binary_header");
+	static_assert(sizeof(vec3) == 12 && sizeof(vec2) == 8 && sizeof(uint3) == 12, "The binary mesh format expects packed vectors");
+
+	static size_t const element_size[5] = { sizeof(vec3), sizeof(vec3), sizeof(vec3), sizeof(vec2), sizeof(uint3) };
+
+	static bool is_little_endian()
+	{
+		uint32_t const value = 1;
+		unsigned char byte;
+		std::memcpy(&byte, &value, 1);
+		return byte == 1;
+	}
+
+	static size_t align_offset(size_t offset)
+	{
+		return (offset + mesh_binary_alignment - 1) / mesh_binary_alignment * mesh_binary_alignment;
+	}
+
+	// Write the file, returns false if the file cannot be opened or written
+	static bool write_binary(std::string const& filename, mesh const& m, uint64_t source_hash, uint64_t source_size)
+	{
+
+		mesh_binary_header header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, mesh_binary_magic, sizeof(header.magic));
+		header.version = mesh_binary_version;
+		header.endianness = 0x01020304;
+		header.source_hash = source_hash;
+		header.source_size = source_size;
+
+		void const* block[5] = { m.position.data.data(), m.normal.data.data(), m.color.data.data(), m.uv.data.data(), m.connectivity.data.data() };
+		int const N[5] = { m.position.size(), m.normal.size(), m.color.size(), m.uv.size(), m.connectivity.size() };
+		size_t offset = align_offset(sizeof(header));
+		for (int k = 0; k < 5; ++k) {
+			header.N_element[k] = uint32_t(N[k]);
+			header.offset[k] = offset;
+			offset = align_offset(offset + N[k] * element_size[k]);
+		}
+
+		std::ofstream stream(filename, std::ios::out | std::ios::binary);
+		if (!stream.is_open())
+			return false;
+
+		char const zeros[mesh_binary_alignment] = {};
+		stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		size_t position = sizeof(header);
+		for (int k = 0; k < 5; ++k) {
+			stream.write(zeros, std::streamsize(header.offset[k] - position));
+			stream.write(static_cast<char const*>(block[k]), std::streamsize(N[k] * element_size[k]));
+			position = header.offset[k] + N[k] * element_size[k];
+		}
+		stream.write(zeros, std::streamsize(offset - position));
+		stream.close();
+
+		return !stream.fail();
+	}
+
+	void mesh_save_file_binary(std::string const& filename, mesh const& m, uint64_t source_hash, uint64_t source_size)
+	{
+		assert_cgp(is_little_endian(), "The binary mesh format is only supported on little-endian systems");
+		bool const success = write_binary(filename, m, source_hash, source_size);
+		assert_cgp(success, "Error while writing file " + str(filename));
+	}
+
+	bool mesh_binary_mapping::open(std::string const& filename)
+	{
+		close();
+		if (!is_little_endian() || !file.open(filename))
+			return false;
+
+		mesh_binary_header header;
+		if (file.size() < sizeof(header)) {
+			close();
+			return false;
+		}
+		std::memcpy(&header, file.data(), sizeof(header));
+		bool valid = std::memcmp(header.magic, mesh_binary_magic, sizeof(header.magic)) == 0 && header.version == mesh_binary_version && header.endianness == 0x01020304;
+		// The block must be in the file: offset + size <= file size, written without overflow of the sum
+		for (int k = 0; valid && k < 5; ++k)
+			valid = header.offset[k] % mesh_binary_alignment == 0 && header.N_element[k] <= 0x7fffffff
+				&& header.offset[k] <= file.size() && header.N_element[k] * element_size[k] <= file.size() - header.offset[k];
+		if (!valid) {
+			close();
+			return false;
+		}
+
+		char const* data = file.data();
+		position = reinterpret_cast<vec3 const*>(data + header.offset[0]);
+		normal = reinterpret_cast<vec3 const*>(data + header.offset[1]);
+		color = reinterpret_cast<vec3 const*>(data + header.offset[2]);
+		uv = reinterpret_cast<vec2 const*>(data + header.offset[3]);
+		connectivity = reinterpret_cast<uint3 const*>(data + header.offset[4]);
+
+		N_position = int(header.N_element[0]);
+		N_normal = int(header.N_element[1]);
+		N_color = int(header.N_element[2]);
+		N_uv = int(header.N_element[3]);
+		N_connectivity = int(header.N_element[4]);
+
+		source_hash = header.source_hash;
+		source_size = header.source_size;
+		return true;
+	}
+
+	void mesh_binary_mapping::open(mesh const& m)
+	{
+		close();
+		storage = m;
+
+		position = storage.position.data.data();
+		normal = storage.normal.data.data();
+		color = storage.color.data.data();
+		uv = storage.uv.data.data();
+		connectivity = storage.connectivity.data.data();
+
+		N_position = storage.position.size();
+		N_normal = storage.normal.size();
+		N_color = storage.color.size();
+		N_uv = storage.uv.size();
+		N_connectivity = storage.connectivity.size();
+	}
+
+	void mesh_binary_mapping::close()
+	{
+		*this = mesh_binary_mapping();
+	}
+
+	template <typename T>
+	static void copy_block(numarray<T>& a, T const* data, int N)
+	{
+		a.data.assign(data, data + N);
+	}
+
+	mesh mesh_binary_mapping::to_mesh() const
+	{
+		mesh m;
+		copy_block(m.position, position, N_position);
+		copy_block(m.normal, normal, N_normal);
+		copy_block(m.color, color, N_color);
+		copy_block(m.uv, uv, N_uv);
+		copy_block(m.connectivity, connectivity, N_connectivity);
+		return m;
+	}
+
+	mesh mesh_load_file_binary(std::string const& filename)
+	{
+		assert_file_exist(filename);
+
+		mesh_binary_mapping mapping;
+		bool const valid = mapping.open(filename);
+		assert_cgp(valid, "File " + str(filename) + " is not a valid binary mesh (version " + str(mesh_binary_version) + ")");
+
+		return mapping.to_mesh();
+	}
+
+	uint64_t mesh_binary_hash(char const* data, size_t size)
+	{
+		// Process the data per 8-byte words with a multiply-xorshift mixing (same idea as the finalizer of MurmurHash3)
+		uint64_t const m = 0xff51afd7ed558ccdULL;
+		uint64_t h = 0x9e3779b97f4a7c15ULL ^ (size * m);
+
+		size_t k = 0;
+		for (; k + 8 <= size; k += 8) {
+			uint64_t word;
+			std::memcpy(&word, data + k, 8);
+			word *= m;
+			word ^= word >> 32;
+			h = (h ^ word) * m;
+		}
+		uint64_t tail = 0;
+		if (size > k)
+			std::memcpy(&tail, data + k, size - k);
+		h = (h ^ (tail * m)) * m;
+
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	// Map the cache file, after regenerating it if it doesn't correspond to the current content of the obj file
+	static mesh_binary_mapping map_cache_obj(std::string const& filename, std::string const& cache_filename_arg)
+	{
+		assert_file_exist(filename);
+		std::string const cache_filename = cache_filename_arg.empty() ? filename + ".cgpmesh" : cache_filename_arg;
+
+		mesh_binary_mapping mapping;
+		uint64_t source_hash = 0;
+		uint64_t source_size = 0;
+		{
+			file_mapping const source(filename);
+			assert_cgp(source.is_open(), "Cannot open file " + str(filename));
+			source_size = source.size();
+			source_hash = mesh_binary_hash(source.data(), source.size());
+
+			// The cache is used if the size and the hash of the source are the same
+			if (mapping.open(cache_filename) && mapping.source_size == source_size && mapping.source_hash == source_hash)
+				return mapping;
+		}
+
+		mapping.close();
+		mesh const m = mesh_load_file_obj(filename);
+
+		// The loaded mesh is used directly if the cache cannot be written or read back
+		if (!is_little_endian() || !write_binary(cache_filename, m, source_hash, source_size) || !mapping.open(cache_filename)) {
+			warning_cgp("Cannot write the binary mesh cache " + str(cache_filename), "The mesh " + str(filename) + " is used without cache");
+			std::remove(cache_filename.c_str());
+			mapping.open(m);
+		}
+		return mapping;
+	}
+
+	mesh mesh_load_file_obj_cached(std::string const& filename, std::string const& cache_filename)
+	{
+		mesh_binary_mapping const mapping = map_cache_obj(filename, cache_filename);
+		if (!mapping.file.is_open())
+			return mapping.storage;
+		return mapping.to_mesh();
+	}
+
+	mesh_binary_mapping mesh_map_file_obj_cached(std::string const& filename, std::string const& cache_filename)
+	{
+		return map_cache_obj(filename, cache_filename);
+	}
+}
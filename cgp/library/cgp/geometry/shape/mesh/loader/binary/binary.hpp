@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../../structure/mesh.hpp"
+#include "cgp/core/files/file_mapping/file_mapping.hpp"
+
+#include <cstdint>
+
+namespace cgp
+{
+	/** Binary mesh format (.cgpmesh)
+	* - A fixed-size header (magic, version, number of elements, offset of each block) followed by the blocks position, normal, color, uv, connectivity.
+	* - Each block is stored contiguously as little-endian floats/unsigned int, and starts at an offset aligned on 64 bytes,
+	*   so that the file can be used directly from a memory mapping (see mesh_binary_mapping).
+	* - The header also stores the size and the hash of the content of the source file the mesh was generated from (0 if none). */
+
+	/** Save the mesh in the binary format */
+	void mesh_save_file_binary(std::string const& filename, mesh const& m, uint64_t source_hash = 0, uint64_t source_size = 0);
+	/** Load a mesh saved in the binary format */
+	mesh mesh_load_file_binary(std::string const& filename);
+
+
+	/** Binary mesh file mapped in memory: the per-vertex data and the connectivity are read directly from the mapped pages without any copy */
+	struct mesh_binary_mapping
+	{
+		file_mapping file;
+		// Data used instead of the file when the binary cache cannot be written (see mesh_map_file_obj_cached): the pointers then designate this mesh
+		mesh storage;
+
+		vec3 const* position = nullptr;
+		vec3 const* normal = nullptr;
+		vec3 const* color = nullptr;
+		vec2 const* uv = nullptr;
+		uint3 const* connectivity = nullptr;
+
+		int N_position = 0;
+		int N_normal = 0;
+		int N_color = 0;
+		int N_uv = 0;
+		int N_connectivity = 0;
+
+		uint64_t source_hash = 0;
+		uint64_t source_size = 0;
+
+		/** Map the file and check its header. Return false if the file doesn't exist or is not a valid binary mesh of the current version. */
+		bool open(std::string const& filename);
+		/** Use the data of the mesh (stored in the structure) instead of a file */
+		void open(mesh const& m);
+		void close();
+
+		/** Copy the data in a mesh */
+		mesh to_mesh() const;
+	};
+
+
+	/** Hash of a sequence of bytes, used to identify the content of a source file */
+	uint64_t mesh_binary_hash(char const* data, size_t size);
+
+	/** Load an obj file through a binary cache
+	* - The cache file (default: filename + ".cgpmesh") is used if it has been generated from the same content of the obj file.
+	* - Otherwise the obj file is loaded (see mesh_load_file_obj, including the filling of the empty fields), and the cache is written.
+	*   If the cache cannot be written (ex. read-only directory), a warning is displayed and the loaded mesh is used directly.
+	* The cache holds the fully filled mesh, so that neither the parsing of the obj nor the computation of the normals are done again. */
+	mesh mesh_load_file_obj_cached(std::string const& filename, std::string const& cache_filename = "");
+
+	/** Same as mesh_load_file_obj_cached, but maps the cache in memory instead of copying it in a mesh (ex. to be sent directly to a mesh_drawable) */
+	mesh_binary_mapping mesh_map_file_obj_cached(std::string const& filename, std::string const& cache_filename = "");
+}
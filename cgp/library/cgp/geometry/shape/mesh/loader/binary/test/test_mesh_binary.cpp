@@ -0,0 +1,123 @@
+#include "test_mesh_binary.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../binary.hpp"
+#include "../../obj/obj.hpp"
+#include "cgp/geometry/shape/mesh/primitive/mesh_primitive.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	template <typename T>
+	static bool is_same_block(numarray<T> const& a, T const* b, int N)
+	{
+		return int(a.size()) == N && (N == 0 || std::memcmp(a.data.data(), b, N * sizeof(T)) == 0);
+	}
+
+	// Bitwise comparison of the mesh with the mapped data
+	static bool is_same_mesh(mesh const& m, mesh_binary_mapping const& mapping)
+	{
+		return is_same_block(m.position, mapping.position, mapping.N_position)
+			&& is_same_block(m.normal, mapping.normal, mapping.N_normal)
+			&& is_same_block(m.color, mapping.color, mapping.N_color)
+			&& is_same_block(m.uv, mapping.uv, mapping.N_uv)
+			&& is_same_block(m.connectivity, mapping.connectivity, mapping.N_connectivity);
+	}
+	static bool is_same_mesh(mesh const& a, mesh const& b)
+	{
+		mesh_binary_mapping mapping;
+		mapping.open(b);
+		return is_same_mesh(a, mapping);
+	}
+
+	static std::string read_bytes(std::string const& filename)
+	{
+		std::ifstream stream(filename, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+	static void write_bytes(std::string const& filename, std::string const& bytes)
+	{
+		std::ofstream stream(filename, std::ios::binary);
+		stream.write(bytes.data(), std::streamsize(bytes.size()));
+	}
+
+	// Return true if the header modified by f is accepted
+	template <typename F>
+	static bool open_modified(std::string const& bytes, std::string const& filename, F const& f)
+	{
+		std::string modified = bytes;
+		f(modified);
+		write_bytes(filename, modified);
+		mesh_binary_mapping mapping;
+		return mapping.open(filename);
+	}
+
+	void test_mesh_binary()
+	{
+		std::string const filename = "test_mesh_binary.obj";
+		std::string const cache = filename + ".cgpmesh";
+		save_file_obj(filename, mesh_primitive_torus(1.0f, 0.25f, { 0,0,0 }, { 0,0,1 }, 40, 20));
+		std::remove(cache.c_str());
+		mesh const reference = mesh_load_file_obj(filename);
+
+		// Round trip: the cache is written at the first call, and mapped at the second one
+		{
+			mesh const m = mesh_load_file_obj_cached(filename);
+			assert_cgp_no_msg(is_same_mesh(m, reference));
+			assert_cgp_no_msg(read_bytes(cache).size() > 0);
+
+			mesh_binary_mapping const mapping = mesh_map_file_obj_cached(filename);
+			assert_cgp_no_msg(mapping.file.is_open());
+			assert_cgp_no_msg(is_same_mesh(reference, mapping));
+			assert_cgp_no_msg(is_same_mesh(reference, mesh_load_file_binary(cache)));
+		}
+
+		// The cache cannot be written: the parsed mesh is used directly
+		{
+			std::string const cache_unwritable = "test_mesh_binary_missing_directory/mesh.cgpmesh";
+			mesh_binary_mapping const mapping = mesh_map_file_obj_cached(filename, cache_unwritable);
+			assert_cgp_no_msg(!mapping.file.is_open());
+			assert_cgp_no_msg(is_same_mesh(reference, mapping));
+			assert_cgp_no_msg(is_same_mesh(reference, mesh_load_file_obj_cached(filename, cache_unwritable)));
+		}
+
+		// Corrupted or truncated headers are rejected
+		{
+			std::string const bytes = read_bytes(cache);
+			std::string const corrupted = "test_mesh_binary_corrupted.cgpmesh";
+			size_t const N_offset = 32;      // N_element[5]
+			size_t const offset_offset = 56; // offset[5]
+
+			assert_cgp_no_msg(open_modified(bytes, corrupted, [](std::string&) {}));
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [](std::string& b) { b[0] = 'X'; }));
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [](std::string& b) { b.resize(50); }));
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [](std::string& b) { b.resize(b.size() - 64); }));
+
+			// Number of elements larger than the file
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [=](std::string& b) {
+				uint32_t const N = 0x7fffffff;
+				std::memcpy(&b[N_offset], &N, sizeof(N));
+			}));
+			// Offset after the end of the file
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [=](std::string& b) {
+				uint64_t const offset = (b.size() / 64 + 1) * 64;
+				std::memcpy(&b[offset_offset], &offset, sizeof(offset));
+			}));
+			// Offset such that offset + size overflows
+			assert_cgp_no_msg(!open_modified(bytes, corrupted, [=](std::string& b) {
+				uint64_t const offset = ~uint64_t(63);
+				std::memcpy(&b[offset_offset], &offset, sizeof(offset));
+			}));
+			std::remove(corrupted.c_str());
+		}
+
+		std::remove(cache.c_str());
+		std::remove(filename.c_str());
+	}
+}
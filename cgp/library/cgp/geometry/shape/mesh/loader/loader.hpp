@@ -1,3 +1,4 @@
 #pragma once
 
-#include "obj/obj.hpp"
\ No newline at end of file
+#include "obj/obj.hpp"
+#include "binary/binary.hpp"
\ No newline at end of file
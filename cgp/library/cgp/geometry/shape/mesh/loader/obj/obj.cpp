@@ -10,7 +10,8 @@
 #include "cgp/core/base/base.hpp"
 #include "cgp/core/files/files.hpp"
 
-#include <map>
+#include <algorithm>
+#include <cstring>
 
 #include <fstream>
 #include <sstream>
@@ -18,100 +19,97 @@
 namespace cgp
 {
 
-    void mesh_save_file_obj(std::string const& filename, mesh const& m)
+    static char* obj_format_vec3_line(char* out, char const* prefix, size_t prefix_size, vec3 const& p)
     {
-        std::ofstream stream(filename, std::ofstream::out);
-        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
-
-        for (int k = 0; k < m.position.size(); ++k)
-            stream << "v " << m.position[k].x << " " << m.position[k].y <<" " << m.position[k].z << std::endl;
-        for (int k = 0; k < m.uv.size(); ++k)
-            stream << "vt " << m.uv[k].x <<" " << m.uv[k].y << std::endl;
-        for (int k = 0; k < m.normal.size(); ++k)
-            stream << "vn " << m.normal[k].x << " " << m.normal[k].y <<" " << m.normal[k].z << std::endl;
-
-        for (int k = 0; k < m.connectivity.size(); ++k) {
-            std::string const u0 = str(m.connectivity[k][0]+1);
-            std::string const u1 = str(m.connectivity[k][1]+1);
-            std::string const u2 = str(m.connectivity[k][2]+1);
-            std::string const f0 = u0 + "/" + u0 + "/" + u0;
-            std::string const f1 = u1 + "/" + u1 + "/" + u1;
-            std::string const f2 = u2 + "/" + u2 + "/" + u2;
-
-            stream << "f " << f0 << " " << f1 << " " << f2 << std::endl;
-        }
+        std::memcpy(out, prefix, prefix_size);
+        out += prefix_size;
+        out = loader::obj_format(out, p.x); *out++ = ' ';
+        out = loader::obj_format(out, p.y); *out++ = ' ';
+        out = loader::obj_format(out, p.z); *out++ = '\n';
+        return out;
+    }
+
+    void save_file_obj(std::string const& filename, mesh const& m)
+    {
+        loader::obj_output_stream stream(filename);
+
+        loader::obj_write_lines(stream, m.position.size(), 64, [&m](int k, char* out) {
+            return obj_format_vec3_line(out, "v ", 2, m.position[k]); });
+        loader::obj_write_lines(stream, m.uv.size(), 64, [&m](int k, char* out) {
+            *out++ = 'v'; *out++ = 't'; *out++ = ' ';
+            out = loader::obj_format(out, m.uv[k].x); *out++ = ' ';
+            out = loader::obj_format(out, m.uv[k].y); *out++ = '\n';
+            return out; });
+        loader::obj_write_lines(stream, m.normal.size(), 64, [&m](int k, char* out) {
+            return obj_format_vec3_line(out, "vn ", 3, m.normal[k]); });
+
+        // f u0/u0/u0 u1/u1/u1 u2/u2/u2
+        loader::obj_write_lines(stream, m.connectivity.size(), 128, [&m](int k, char* out) {
+            *out++ = 'f';
+            for (int i = 0; i < 3; ++i) {
+                *out++ = ' ';
+                char* const start = out;
+                out = loader::obj_format(out, m.connectivity[k][i] + 1);
+                size_t const N = size_t(out - start);
+                *out++ = '/'; std::memcpy(out, start, N); out += N;
+                *out++ = '/'; std::memcpy(out, start, N); out += N;
+            }
+            *out++ = '\n';
+            return out; });
 
         stream.close();
     }
 
     void save_file_obj(std::string const& filename, std::vector<vec3> const& position, std::vector<vec3> const& normal)
     {
-        std::ofstream stream(filename, std::ofstream::out);
-        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
-
-        for (int k = 0; k < position.size(); ++k)
-            stream << "v " << position[k].x << " " << position[k].y <<" " << position[k].z << std::endl;
-        for (int k = 0; k < normal.size(); ++k)
-            stream << "vn " << normal[k].x << " " << normal[k].y <<" " << normal[k].z << std::endl;
-
-        for (int k = 0; k < position.size()/3; k++) {
-            std::string const u0 = str(3*k+1);
-            std::string const u1 = str(3*k+2);
-            std::string const u2 = str(3*k+3);
-            std::string const f0 = u0 + "//" + u0;
-            std::string const f1 = u1 + "//" + u1;
-            std::string const f2 = u2 + "//" + u2;
-
-            stream << "f " << f0 << " " << f1 << " " << f2 << std::endl;
-        }
+        loader::obj_output_stream stream(filename);
+
+        loader::obj_write_lines(stream, int(position.size()), 64, [&position](int k, char* out) {
+            return obj_format_vec3_line(out, "v ", 2, position[k]); });
+        loader::obj_write_lines(stream, int(normal.size()), 64, [&normal](int k, char* out) {
+            return obj_format_vec3_line(out, "vn ", 3, normal[k]); });
+
+        // f u0//u0 u1//u1 u2//u2
+        loader::obj_write_lines(stream, int(position.size() / 3), 128, [](int k, char* out) {
+            *out++ = 'f';
+            for (int i = 0; i < 3; ++i) {
+                *out++ = ' ';
+                char* const start = out;
+                out = loader::obj_format(out, unsigned(3 * k + i + 1));
+                size_t const N = size_t(out - start);
+                *out++ = '/'; *out++ = '/'; std::memcpy(out, start, N); out += N;
+            }
+            *out++ = '\n';
+            return out; });
 
         stream.close();
     }
 
 
-// Comparator of triplet of integer for std::map
-struct comparator_int3 {
-    long int N; // number of vertices
-
-    comparator_int3(int N_arg=0) :N(N_arg) {}
+// Indices (texture, normal) of a face vertex, used to merge the face vertices sharing the same position
+struct obj_vertex_key
+{
+    int texture;
+    int normal;
 
-    // compute a<b
-    bool operator()(int3 const& a, int3 const& b) const
-    {
-        long int const offset_a = long(a[0]) + N*(long(a[1]) + N*long(a[2]));
-        long int const offset_b = long(b[0]) + N*(long(b[1]) + N*long(b[2]));
-        return offset_a < offset_b;
-    }
+    bool operator==(obj_vertex_key const& other) const { return texture == other.texture && normal == other.normal; }
+    bool operator<(obj_vertex_key const& other) const { return normal < other.normal || (normal == other.normal && texture < other.texture); }
 };
 
-
-static numarray<numarray_stack<int3,3>> triangulate_faces(numarray<numarray<int3>> faces);
-
-
-static std::pair<mesh, std::map<int3, int, comparator_int3>>
-    make_unique_parameter_per_value(numarray<vec3> const& positions,
-                                    numarray<vec2> const& texture_uv,
-                                    numarray<vec3> const& normals,
-                                    numarray<numarray_stack<int3,3>> const& faces,
-                                    loader::obj_type const type);
-
-
-mesh mesh_load_file_obj(const std::string& filename)
-{
-    numarray<numarray<int>> vertex_correspondance;
-     mesh m = mesh_load_file_obj(filename, vertex_correspondance);
-     m.fill_empty_field();
-     return m;
-}
-mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
+// Load the mesh from the file mapped in memory, and fill the correspondance with the vertices of the file if it is not null
+static mesh load_file_obj(const std::string& filename, numarray<numarray<int> >* vertex_correspondance)
 {
     assert_file_exist(filename);
 
-    // Load parameters
-    numarray<vec3> positions = loader::obj_read_positions(filename);
-    numarray<vec2> texture_uv = loader::obj_read_texture_uv(filename);
-    numarray<vec3> normals = loader::obj_read_normals(filename);
+    file_mapping const file(filename);
+    assert_cgp(file.is_open(), "Cannot open file "+str(filename));
 
+    loader::obj_content content;
+    loader::obj_parse(content, file.data(), file.size());
+
+    numarray<vec3> const& positions = content.position;
+    numarray<vec2> const& texture_uv = content.texture_uv;
+    numarray<vec3> const& normals = content.normal;
     assert_cgp(positions.size()>0, str("File ")+filename+" has 0 vertices");
 
     // set obj type
@@ -122,101 +120,114 @@ mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& v
         type = loader::obj_type::vertex_texture;
     else if( normals.size()>0 )
         type = loader::obj_type::vertex_normal;
+    bool const has_uv = type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_texture;
+    bool const has_normal = type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_normal;
 
-    // Load connectivity and triangulate
-    numarray<numarray_stack<int3,3>> faces = triangulate_faces( loader::obj_read_faces(filename, type) );
+    // Triangulate the faces (fan from the first vertex), and set unique per-vertex value for texture and normals (duplicate vertices if necessary)
+    size_t N_triangle = 0;
+    for (int k_face = 0; k_face < content.face_size.size(); ++k_face)
+        N_triangle += std::max(content.face_size[k_face] - 2, 0);
 
-    // Set unique per-vertex value for texture and normals (duplicate vertices if necessary)
     mesh m;
-    std::map<int3, int, comparator_int3> connectivity_map;
-    std::tie(m,connectivity_map) = make_unique_parameter_per_value(positions, texture_uv, normals, faces, type);
-
-    // Retrieve correspondance between initial vertices in files and new ones
-    vertex_correspondance.resize(positions.size());
-    for(auto const& it : connectivity_map)
+    m.connectivity.reserve(int(N_triangle));
+
+    // Two face vertices are merged if they have the same indices (v,t,n)
+    //  The vertices of the mesh sharing the same position v of the file are chained from vertex_head[v], and compared with their key (t,n).
+    //  The cost is linear in the number of face vertices (the chains only contain the different uv/normals used with one position).
+    //  The per-vertex buffers of the mesh are filled once the number of vertices is known, so that they are allocated only once.
+    std::vector<int> vertex_head(positions.size(), -1); // last vertex of the mesh created for each position of the file
+    std::vector<int> vertex_next;                       // previous vertex created with the same position (-1 if none)
+    std::vector<int> vertex_position;                   // position of the file of each vertex of the mesh
+    std::vector<obj_vertex_key> vertex_key;             // key of each vertex of the mesh
+    vertex_next.reserve(positions.size());
+    vertex_position.reserve(positions.size());
+    vertex_key.reserve(positions.size());
+
+    int offset_face = 0;
+    for (int k_face = 0; k_face < content.face_size.size(); ++k_face)
     {
-        int const vertex_in = it.first[0];
-        int const vertex_out = it.second;
+        int const N_polygon = content.face_size[k_face];
+        loader::obj_face_vertex const* polygon = content.face_vertex.data.data() + offset_face;
+        offset_face += N_polygon;
 
-        vertex_correspondance[vertex_in].push_back(vertex_out);
+        for (int k = 0; k < N_polygon - 2; ++k)
+        {
+            int3 const tri[3] = { loader::obj_face_index(polygon[0], type), loader::obj_face_index(polygon[k+1], type), loader::obj_face_index(polygon[k+2], type) };
+            uint3 new_triangle_index;
+            for (int i = 0; i < 3; ++i)
+            {
+                int3 const& index = tri[i];
+                int const idx_position = index[0];
+                assert_cgp_no_msg( idx_position>=0 && idx_position<int(positions.size()));
+
+                obj_vertex_key const key = { index[1], index[2] };
+                int vertex = vertex_head[idx_position];
+                while (vertex != -1 && !(vertex_key[vertex] == key))
+                    vertex = vertex_next[vertex];
+
+                if (vertex == -1) {
+                    vertex = int(vertex_key.size());
+                    vertex_key.push_back(key);
+                    vertex_position.push_back(idx_position);
+                    vertex_next.push_back(vertex_head[idx_position]);
+                    vertex_head[idx_position] = vertex;
+                }
+                new_triangle_index[i] = vertex;
+            }
+            m.connectivity.push_back(new_triangle_index);
+        }
     }
 
-    return m;
-}
-
-
-numarray<numarray_stack<int3,3>> triangulate_faces(numarray<numarray<int3>> faces)
-{
-    numarray<numarray_stack<int3,3>> faces_triangulation;
-    size_t const N_face = faces.size();
-    for(size_t k_face=0; k_face<N_face; ++k_face)
-    {
-        numarray<int3> const& current_polygon = faces[k_face];
-        int const N_polygon = int(current_polygon.size());
-
-        for(int k=0; k<N_polygon-2; ++k) {
-            // triangulation
-            int3 const& f0 = current_polygon[0];
-            int3 const& f1 = current_polygon[k+1];
-            int3 const& f2 = current_polygon[k+2];
-
-            faces_triangulation.push_back({f0,f1,f2});
+    int const N_vertex = int(vertex_key.size());
+    m.position.resize(N_vertex);
+    for (int k = 0; k < N_vertex; ++k)
+        m.position.at(k) = positions.at(vertex_position[k]);
+    if (has_uv) {
+        m.uv.resize(N_vertex);
+        for (int k = 0; k < N_vertex; ++k) {
+            int const idx_uv = vertex_key[k].texture;
+            assert_cgp_no_msg( idx_uv>=0 && idx_uv<int(texture_uv.size()) );
+            m.uv.at(k) = texture_uv.at(idx_uv);
+        }
+    }
+    if (has_normal) {
+        m.normal.resize(N_vertex);
+        for (int k = 0; k < N_vertex; ++k) {
+            int const idx_normal = vertex_key[k].normal;
+            assert_cgp_no_msg( idx_normal>=0 && idx_normal<int(normals.size()) );
+            m.normal.at(k) = normals.at(idx_normal);
         }
     }
-    return faces_triangulation;
-}
-
-std::pair<mesh, std::map<int3, int, comparator_int3>>
-    make_unique_parameter_per_value(numarray<vec3> const& positions,
-                                    numarray<vec2> const& texture_uv,
-                                    numarray<vec3> const& normals,
-                                    numarray<numarray_stack<int3,3>> const& faces,
-                                    loader::obj_type const type)
-{
-    mesh m;
-    comparator_int3 comparator(int(positions.size()));
-    std::map<int3, int, comparator_int3> connectivity_map(comparator); // stores map between original face index and final offset
-
 
-    size_t const N_triangle = faces.size();
-    for(size_t k_triangle=0; k_triangle<N_triangle; ++k_triangle)
+    // Retrieve correspondance between initial vertices in files and new ones (sorted by increasing normal index, then texture index)
+    if (vertex_correspondance != nullptr)
     {
-        numarray_stack<int3,3> const& tri = faces[k_triangle];
-        uint3 new_triangle_index;
-        for(int k=0; k<3; ++k)
-        {
-            int3 const& index = tri[k];
-            auto const it = connectivity_map.find( index );
-            if( it==connectivity_map.end() ) {
-
-                size_t const offset = m.position.size();
-                connectivity_map[index] = int(offset);
-                new_triangle_index[k] = int(offset);
-
-                int const idx_position = index[0];
-
-                assert_cgp_no_msg( idx_position<int(positions.size()));
-                m.position.push_back( positions[idx_position] );
-
-                if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_texture) {
-                    int const idx_uv = index[1];
-                    assert_cgp_no_msg( idx_uv<int(texture_uv.size()) );
-                    m.uv.push_back( texture_uv[ idx_uv ] );
-                }
-                if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_normal) {
-                    int const idx_normal = index[2];
-                    assert_cgp_no_msg( idx_normal<int(normals.size()) );
-                    m.normal.push_back( normals[idx_normal] );
-                }
-
-            }
-            else
-                new_triangle_index[k] = it->second;
+        vertex_correspondance->resize(positions.size());
+        std::vector<int> chain;
+        for (int k_position = 0; k_position < positions.size(); ++k_position) {
+            chain.clear();
+            for (int vertex = vertex_head[k_position]; vertex != -1; vertex = vertex_next[vertex])
+                chain.push_back(vertex);
+            std::sort(chain.begin(), chain.end(), [&](int a, int b) { return vertex_key[a] < vertex_key[b]; });
+            (*vertex_correspondance)[k_position].reserve(int(chain.size()));
+            for (int vertex : chain)
+                (*vertex_correspondance)[k_position].push_back(vertex);
         }
-        m.connectivity.push_back(new_triangle_index);
     }
 
-    return {m, connectivity_map};
+    return m;
+}
+
+
+mesh mesh_load_file_obj(const std::string& filename)
+{
+    mesh m = load_file_obj(filename, nullptr);
+    m.fill_empty_field();
+    return m;
+}
+mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
+{
+    return load_file_obj(filename, &vertex_correspondance);
 }
 
 
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "../../structure/mesh.hpp"
+#include "obj_parser/obj_parser.hpp"
+#include "obj_writer/obj_writer.hpp"
 
 namespace cgp
 {
     /** Save a mesh in .obj file
-    * Note that OBJ format doesn't stores per-vertex color */
+    * Note that OBJ format doesn't stores per-vertex color
+    * The file is written through a large buffer, and the lines are formatted in parallel (see loader::obj_write_lines) */
     void save_file_obj(std::string const& filename, mesh const& m);
 
 
@@ -18,6 +21,7 @@ namespace cgp
     *  - .mtl files are not read with this loader (cannot read shading and color)
     *  - Only one mesh is loaded - this parser cannot be used when multiple textures are associated to different objects
     *  - The mesh is triangulated if higher degree polygons are in the file
+    *  - The file is memory-mapped and parsed in a single pass (in parallel for large files, see loader::obj_parse)
     */
     mesh mesh_load_file_obj(std::string const& filename);
 
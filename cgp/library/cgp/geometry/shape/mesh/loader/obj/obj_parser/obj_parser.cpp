@@ -0,0 +1,296 @@
+#include "obj_parser.hpp"
+
+#include "../obj.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace cgp {
+namespace loader {
+
+	// Whitespace characters as defined by std::isspace in the "C" locale (the end of line is handled separately)
+	static bool is_space(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+	static bool is_digit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	// Cursor on a line of the file [it, end[
+	struct obj_line
+	{
+		char const* it;
+		char const* end;
+
+		void skip_space() { while (it < end && is_space(*it)) ++it; }
+		bool at_end() const { return it == end; }
+	};
+
+	// Read a float with the same rules as std::istream >> float (libstdc++ num_get in the "C" locale)
+	//  Return false if no valid value can be extracted (the value is then set to 0), the line should not be read further in this case.
+	static bool read_float(obj_line& line, float& value)
+	{
+		line.skip_space();
+		char const* const begin = line.it;
+		char const* it = begin;
+		char const* const end = line.end;
+
+		bool negative = false;
+		if (it < end && (*it == '+' || *it == '-')) {
+			negative = *it == '-';
+			++it;
+		}
+
+		// Mantissa stored as an integer with a decimal exponent
+		unsigned long long mantissa = 0;
+		int significant_digits = 0;
+		int exponent = 0;
+		bool found_mantissa = false;
+		while (it < end && is_digit(*it)) {
+			found_mantissa = true;
+			if (mantissa != 0 || *it != '0')
+				significant_digits++;
+			if (significant_digits <= 19)
+				mantissa = 10 * mantissa + (*it - '0');
+			else
+				exponent++;
+			++it;
+		}
+		if (it < end && *it == '.') {
+			++it;
+			while (it < end && is_digit(*it)) {
+				found_mantissa = true;
+				if (mantissa != 0 || *it != '0')
+					significant_digits++;
+				if (significant_digits <= 19) {
+					mantissa = 10 * mantissa + (*it - '0');
+					exponent--;
+				}
+				++it;
+			}
+		}
+
+		// The exponent is only considered after a valid mantissa
+		bool valid = found_mantissa;
+		if (found_mantissa && it < end && (*it == 'e' || *it == 'E')) {
+			++it;
+			bool negative_exponent = false;
+			if (it < end && (*it == '+' || *it == '-')) {
+				negative_exponent = *it == '-';
+				++it;
+			}
+			int e = 0;
+			bool found_exponent = false;
+			while (it < end && is_digit(*it)) {
+				found_exponent = true;
+				if (e < 100000)
+					e = 10 * e + (*it - '0');
+				++it;
+			}
+			valid = found_exponent;
+			exponent += negative_exponent ? -e : e;
+		}
+		line.it = it;
+
+		if (!valid) {
+			value = 0.0f;
+			return false;
+		}
+
+		// Fast path: the mantissa and the power of 10 are exactly representable as float, and a single division/multiplication is correctly rounded
+		static float const power_of_ten[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+		if (mantissa < (1ull << 24) && exponent >= -10 && exponent <= 10) {
+			float const m = static_cast<float>(mantissa);
+			float const v = exponent < 0 ? m / power_of_ten[-exponent] : m * power_of_ten[exponent];
+			value = negative ? -v : v;
+			return true;
+		}
+
+		// General case: conversion of the accumulated characters with strtof (the text is not null-terminated)
+		std::string const token(begin, it);
+		value = std::strtof(token.c_str(), nullptr);
+		if (value == std::numeric_limits<float>::infinity() || value == -std::numeric_limits<float>::infinity()) {
+			value = value > 0 ? std::numeric_limits<float>::max() : -std::numeric_limits<float>::max();
+			return false;
+		}
+		return true;
+	}
+
+	// Read an integer as sscanf %d. Return false if there is no digit (the value is then unchanged).
+	static bool read_int(char const*& it, char const* end, int& value)
+	{
+		char const* p = it;
+		bool negative = false;
+		if (p < end && (*p == '+' || *p == '-')) {
+			negative = *p == '-';
+			++p;
+		}
+		if (p == end || !is_digit(*p))
+			return false;
+
+		int v = 0;
+		while (p < end && is_digit(*p)) {
+			v = 10 * v + (*p - '0');
+			++p;
+		}
+		value = negative ? -v : v;
+		it = p;
+		return true;
+	}
+
+	// Read a face vertex in the form v, v/t, v/t/n, or v//n
+	//  The syntax is checked as sscanf would do for the patterns "%d/%d/%d" and "%d//%d": values after a mismatch are not read.
+	static obj_face_vertex read_face_vertex(char const* it, char const* end)
+	{
+		obj_face_vertex vertex = { {0,0,0}, false };
+		if (!read_int(it, end, vertex.index[0]))
+			return vertex;
+		if (it == end || *it != '/')
+			return vertex;
+		++it;
+		if (it < end && *it == '/') {
+			++it;
+			vertex.double_slash = true;
+			read_int(it, end, vertex.index[2]);
+			return vertex;
+		}
+		if (!read_int(it, end, vertex.index[1]))
+			return vertex;
+		if (it == end || *it != '/')
+			return vertex;
+		++it;
+		read_int(it, end, vertex.index[2]);
+		return vertex;
+	}
+
+	static void parse_line(obj_content& content, obj_line line)
+	{
+		line.skip_space();
+		char const* const word = line.it;
+		while (line.it < line.end && !is_space(*line.it))
+			++line.it;
+		size_t const word_size = size_t(line.it - word);
+		if (word_size == 0 || word[0] == '#')
+			return;
+
+		if (word_size == 1 && word[0] == 'v') {
+			vec3 p;
+			for (int k = 0; k < 3 && read_float(line, p[k]); ++k) {}
+			content.position.push_back(p);
+		}
+		else if (word_size == 2 && word[0] == 'v' && word[1] == 't') {
+			vec2 uv;
+			for (int k = 0; k < 2 && read_float(line, uv[k]); ++k) {}
+			content.texture_uv.push_back(uv);
+		}
+		else if (word_size == 2 && word[0] == 'v' && word[1] == 'n') {
+			vec3 n;
+			for (int k = 0; k < 3 && read_float(line, n[k]); ++k) {}
+			content.normal.push_back(n);
+		}
+		else if (word_size == 1 && word[0] == 'f') {
+			int counter = 0;
+			while (true) {
+				line.skip_space();
+				if (line.at_end())
+					break;
+				char const* const token = line.it;
+				while (line.it < line.end && !is_space(*line.it))
+					++line.it;
+				content.face_vertex.push_back(read_face_vertex(token, line.it));
+				counter++;
+			}
+			content.face_size.push_back(counter);
+		}
+	}
+
+	static void parse_chunk(obj_content& content, char const* it, char const* end)
+	{
+		while (it < end) {
+			char const* line_end = static_cast<char const*>(std::memchr(it, '\n', size_t(end - it)));
+			if (line_end == nullptr)
+				line_end = end;
+			parse_line(content, { it, line_end });
+			it = line_end + 1;
+		}
+	}
+
+	void obj_parse(obj_content& content, char const* text, size_t size)
+	{
+		content = obj_content();
+
+		// Chunks of about 1MB that always start at the beginning of a line
+		size_t const chunk_size = size_t(1) << 20;
+		std::vector<char const*> chunk_begin;
+		char const* const text_end = text + size;
+		char const* it = text;
+		while (it < text_end) {
+			chunk_begin.push_back(it);
+			if (size_t(text_end - it) <= chunk_size)
+				break;
+			char const* const next_line = static_cast<char const*>(std::memchr(it + chunk_size, '\n', size_t(text_end - it - chunk_size)));
+			it = next_line == nullptr ? text_end : next_line + 1;
+		}
+		chunk_begin.push_back(text_end);
+
+		int const N_chunk = int(chunk_begin.size()) - 1;
+		if (N_chunk <= 1) {
+			if (N_chunk == 1)
+				parse_chunk(content, text, text_end);
+			return;
+		}
+
+		std::vector<obj_content> chunk_content(N_chunk);
+		parallel_for(N_chunk, [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k)
+				parse_chunk(chunk_content[k], chunk_begin[k], chunk_begin[k + 1]);
+		}, 1);
+
+		// Concatenate the chunks in the order of the file
+		size_t N_position = 0, N_uv = 0, N_normal = 0, N_face_vertex = 0, N_face = 0;
+		for (obj_content const& c : chunk_content) {
+			N_position += c.position.size();
+			N_uv += c.texture_uv.size();
+			N_normal += c.normal.size();
+			N_face_vertex += c.face_vertex.size();
+			N_face += c.face_size.size();
+		}
+		content.position.reserve(int(N_position));
+		content.texture_uv.reserve(int(N_uv));
+		content.normal.reserve(int(N_normal));
+		content.face_vertex.reserve(int(N_face_vertex));
+		content.face_size.reserve(int(N_face));
+		for (obj_content& c : chunk_content) {
+			content.position.push_back(std::move(c.position));
+			content.texture_uv.push_back(std::move(c.texture_uv));
+			content.normal.push_back(std::move(c.normal));
+			content.face_vertex.push_back(std::move(c.face_vertex));
+			content.face_size.push_back(std::move(c.face_size));
+			c = obj_content(); // release the memory of the chunk
+		}
+	}
+
+	int3 obj_face_index(obj_face_vertex const& vertex, obj_type type)
+	{
+		int3 index = { vertex.index[0], 0, 0 };
+		if (type == obj_type::vertex_texture)
+			index[1] = vertex.index[1];
+		else if (type == obj_type::vertex_normal)
+			index[2] = vertex.double_slash ? vertex.index[2] : 0;
+		else if (type == obj_type::vertex_texture_normal) {
+			index[1] = vertex.index[1];
+			index[2] = vertex.double_slash ? 0 : vertex.index[2];
+		}
+
+		for (int k = 0; k < 3; ++k)
+			index[k]--; // obj indices starts at 1
+		return index;
+	}
+}
+}
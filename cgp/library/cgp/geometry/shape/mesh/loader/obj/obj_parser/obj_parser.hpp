@@ -0,0 +1,38 @@
+#pragma once
+
+#include "cgp/core/array/array.hpp"
+#include "cgp/geometry/vec/vec.hpp"
+
+namespace cgp {
+namespace loader {
+
+	enum class obj_type;
+
+	/** Vertex of a face "f" as written in the obj file (ex. 4/2/3, 4//3, 4/2, or 4)
+	* The values are stored as read (starting at 1, and 0 if not defined) as the way to interpret them depends on the type of file
+	* that is only known once the entire file has been read (see obj_face_index). */
+	struct obj_face_vertex
+	{
+		int3 index;        // (position, texture, normal)
+		bool double_slash; // true if the normal is given with the syntax v//n
+	};
+
+	/** Raw content of an obj file */
+	struct obj_content
+	{
+		numarray<vec3> position;
+		numarray<vec2> texture_uv;
+		numarray<vec3> normal;
+		numarray<obj_face_vertex> face_vertex; // vertices of all the faces stored contiguously
+		numarray<int> face_size;               // number of vertices of each face
+	};
+
+	/** Parse the text of an obj file in a single pass (lines "v", "vt", "vn" and "f")
+	* The text is split in chunks of lines that are parsed in parallel (see parallel_for), the result is independent of the number of threads.
+	* The values are identical to the ones read with std::istream (floats) and sscanf (face indices) by the obj_read_* functions. */
+	void obj_parse(obj_content& content, char const* text, size_t size);
+
+	/** Index (position, texture, normal) starting at 0 of a face vertex for a given type of file (-1 if not defined) */
+	int3 obj_face_index(obj_face_vertex const& vertex, obj_type type);
+}
+}
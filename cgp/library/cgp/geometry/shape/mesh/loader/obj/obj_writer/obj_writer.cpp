@@ -0,0 +1,226 @@
+#include "obj_writer.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace cgp {
+namespace loader {
+
+	obj_output_stream::obj_output_stream(std::string const& filename_arg, size_t buffer_size)
+		: filename(filename_arg), file(nullptr), buffer(std::max(buffer_size, size_t(1))), buffer_used(0)
+	{
+		file = std::fopen(filename.c_str(), "wb");
+		assert_cgp(file != nullptr, "Cannot open file " + str(filename));
+
+		// The data is already buffered: avoid the additional copy in the buffer of the FILE
+		std::setvbuf(file, nullptr, _IONBF, 0);
+	}
+
+	obj_output_stream::~obj_output_stream()
+	{
+		if (file != nullptr) {
+			flush();
+			std::fclose(file);
+		}
+	}
+
+	void obj_output_stream::flush()
+	{
+		if (buffer_used > 0) {
+			size_t const written = std::fwrite(buffer.data(), 1, buffer_used, file);
+			assert_cgp(written == buffer_used, "Error while writing file " + str(filename));
+			buffer_used = 0;
+		}
+	}
+
+	void obj_output_stream::write(char const* data, size_t size)
+	{
+		assert_cgp_no_msg(file != nullptr);
+
+		if (buffer_used + size > buffer.size())
+			flush();
+
+		// Large blocks are directly written to the file
+		if (size >= buffer.size()) {
+			size_t const written = std::fwrite(data, 1, size, file);
+			assert_cgp(written == size, "Error while writing file " + str(filename));
+			return;
+		}
+
+		std::memcpy(buffer.data() + buffer_used, data, size);
+		buffer_used += size;
+	}
+
+	void obj_output_stream::close()
+	{
+		if (file == nullptr)
+			return;
+		flush();
+		int const status = std::fclose(file);
+		file = nullptr;
+		assert_cgp(status == 0, "Error while closing file " + str(filename));
+	}
+
+
+	char* obj_format(char* out, unsigned int value)
+	{
+		char digits[10];
+		int N = 0;
+		do {
+			digits[N++] = char('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+
+		while (N > 0)
+			*out++ = digits[--N];
+		return out;
+	}
+
+	// Powers of 10 as double from 10^-50 to 10^50
+	static double power_of_ten(int e)
+	{
+		static double const* table = [] {
+			static double p[101];
+			for (int k = 0; k <= 100; ++k)
+				p[k] = std::pow(10.0, k - 50);
+			return p;
+		}();
+		return table[e + 50];
+	}
+
+	// Fallback for the values where the fast path cannot guarantee the rounding of printf
+	static char* obj_format_printf(char* out, float value)
+	{
+		char text[32];
+		int const N = std::snprintf(text, sizeof(text), "%g", double(value));
+		std::memcpy(out, text, size_t(N));
+		return out + N;
+	}
+
+	char* obj_format(char* out, float value)
+	{
+		if (!std::isfinite(value))
+			return obj_format_printf(out, value);
+
+		if (std::signbit(value)) {
+			*out++ = '-';
+			value = -value;
+		}
+		if (value == 0.0f) {
+			*out++ = '0';
+			return out;
+		}
+
+		// Find the decimal exponent e such that the value is written with 6 significant digits as digits * 10^(e-5)
+		double const x = double(value);
+		int e = int(std::floor(std::log10(x)));
+		double scaled = x * power_of_ten(5 - e);
+		if (scaled >= 999999.5) {
+			e++;
+			scaled = x * power_of_ten(5 - e);
+		}
+		else if (scaled < 99999.5) {
+			e--;
+			scaled = x * power_of_ten(5 - e);
+		}
+
+		// The rounding of printf is exact: use it for the (rare) values too close to a half-way case
+		double const fraction = scaled - std::floor(scaled);
+		if (std::abs(fraction - 0.5) < 1e-6 || scaled < 99999.5 || scaled >= 999999.5)
+			return obj_format_printf(out, value);
+
+		unsigned int digits_value = unsigned(std::floor(scaled + 0.5));
+		char digits[6];
+		for (int k = 5; k >= 0; --k) {
+			digits[k] = char('0' + digits_value % 10);
+			digits_value /= 10;
+		}
+		int N_digits = 6; // significant digits without the trailing zeros
+		while (N_digits > 1 && digits[N_digits - 1] == '0')
+			N_digits--;
+
+		if (e < -4 || e >= 6) {
+			// Scientific notation d.ddddde+XX
+			*out++ = digits[0];
+			if (N_digits > 1) {
+				*out++ = '.';
+				for (int k = 1; k < N_digits; ++k)
+					*out++ = digits[k];
+			}
+			*out++ = 'e';
+			*out++ = e < 0 ? '-' : '+';
+			unsigned int const exponent = unsigned(e < 0 ? -e : e);
+			if (exponent < 10)
+				*out++ = '0';
+			return obj_format(out, exponent);
+		}
+
+		if (e < 0) {
+			// 0.000ddd
+			*out++ = '0';
+			*out++ = '.';
+			for (int k = 0; k < -e - 1; ++k)
+				*out++ = '0';
+			for (int k = 0; k < N_digits; ++k)
+				*out++ = digits[k];
+			return out;
+		}
+
+		// ddd.ddd
+		for (int k = 0; k <= e; ++k)
+			*out++ = digits[k];
+		if (N_digits > e + 1) {
+			*out++ = '.';
+			for (int k = e + 1; k < N_digits; ++k)
+				*out++ = digits[k];
+		}
+		return out;
+	}
+
+
+	void obj_write_lines(obj_output_stream& stream, int N, int max_line_size, std::function<char*(int, char*)> const& format_line)
+	{
+		if (N <= 0)
+			return;
+
+		int const chunk_size = std::min(N, 8192); // number of lines per chunk
+		int const N_chunk = (N + chunk_size - 1) / chunk_size;
+		int const N_thread = parallel_number_of_threads();
+
+		// Chunks formatted at the same time before being written: 2 per thread, within a memory budget of 16MB
+		size_t const memory_budget = size_t(1) << 24;
+		int const N_budget = int(std::max(size_t(1), memory_budget / (size_t(chunk_size) * size_t(max_line_size))));
+		int const N_batch = std::min(std::min(N_chunk, N_budget), N_thread > 1 ? 2 * N_thread : 1);
+
+		// Each buffer is sized from the number of lines of its chunk (the last chunk may be smaller)
+		std::vector<std::vector<char> > buffer(N_batch);
+		std::vector<size_t> buffer_size(N_batch, 0);
+
+		for (int chunk_start = 0; chunk_start < N_chunk; chunk_start += N_batch) {
+			int const N_current = std::min(N_batch, N_chunk - chunk_start);
+			parallel_for(N_current, [&](int b_begin, int b_end) {
+				for (int b = b_begin; b < b_end; ++b) {
+					int const k_begin = (chunk_start + b) * chunk_size;
+					int const k_end = std::min(N, k_begin + chunk_size);
+					size_t const capacity = size_t(k_end - k_begin) * size_t(max_line_size);
+					if (buffer[b].size() < capacity)
+						buffer[b].resize(capacity);
+
+					char* const start = buffer[b].data();
+					char* out = start;
+					for (int k = k_begin; k < k_end; ++k)
+						out = format_line(k, out);
+					buffer_size[b] = size_t(out - start);
+				}
+			}, 1);
+
+			for (int b = 0; b < N_current; ++b)
+				stream.write(buffer[b].data(), buffer_size[b]);
+		}
+	}
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cgp {
+namespace loader {
+
+	/** Output file with a large write buffer, used to export obj files
+	* The data is only sent to the file when the buffer is full (or when the stream is closed), and no flush is done per line. */
+	struct obj_output_stream
+	{
+		explicit obj_output_stream(std::string const& filename, size_t buffer_size = 1 << 22);
+		~obj_output_stream();
+
+		obj_output_stream(obj_output_stream const&) = delete;
+		obj_output_stream& operator=(obj_output_stream const&) = delete;
+
+		void write(char const* data, size_t size);
+		/** Write the remaining data of the buffer and close the file */
+		void close();
+
+	private:
+		void flush();
+
+		std::string filename;
+		FILE* file;
+		std::vector<char> buffer;
+		size_t buffer_used;
+	};
+
+	/** Write the text of the value at position out (without terminal '\0') and return the position after the last character
+	* The float is written with the same characters as the default std::ostream output (printf "%g", 6 significant digits), with at most 15 characters. */
+	char* obj_format(char* out, float value);
+	/** Same as obj_format(float) for an unsigned integer, with at most 10 characters */
+	char* obj_format(char* out, unsigned int value);
+
+	/** Write N lines in the stream, where format_line(k, out) writes the k-th line at position out (at most max_line_size characters) and returns the position after it
+	* The lines are formatted by chunks in parallel (see parallel_for) and the chunks are written in order: the file is identical for any number of threads. */
+	void obj_write_lines(obj_output_stream& stream, int N, int max_line_size, std::function<char*(int, char*)> const& format_line);
+}
+}
@@ -0,0 +1,84 @@
+#include "test_obj_writer.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "../../obj.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// Reference output of the obj export using the default formatting of std::ostream (same as printf "%g")
+	static std::string obj_reference(mesh const& m)
+	{
+		std::ostringstream stream;
+		for (int k = 0; k < m.position.size(); ++k)
+			stream << "v " << m.position[k].x << " " << m.position[k].y << " " << m.position[k].z << "\n";
+		for (int k = 0; k < m.uv.size(); ++k)
+			stream << "vt " << m.uv[k].x << " " << m.uv[k].y << "\n";
+		for (int k = 0; k < m.normal.size(); ++k)
+			stream << "vn " << m.normal[k].x << " " << m.normal[k].y << " " << m.normal[k].z << "\n";
+		for (int k = 0; k < m.connectivity.size(); ++k) {
+			stream << "f";
+			for (int i = 0; i < 3; ++i) {
+				unsigned int const u = m.connectivity[k][i] + 1;
+				stream << " " << u << "/" << u << "/" << u;
+			}
+			stream << "\n";
+		}
+		return stream.str();
+	}
+
+	static std::string read_file(std::string const& filename)
+	{
+		std::ifstream stream(filename, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void test_obj_writer()
+	{
+		// Values written with different notations by "%g": negative, tiny, huge, integral, and values rounded up to the next power of 10
+		std::vector<float> const special = { 0.0f, -0.0f, 1.0f, -1.0f, 100.0f, -123456.0f, 1234567.0f, 1e6f, 999999.5f, 9999995.0f,
+			0.5f, -0.25f, 0.1f, 1e-4f, 9.99999e-5f, 1e-5f, -3.5e-7f, 1e-30f, 1e-40f, 1e10f, -3.4e38f, 3.4028235e38f, 0.000123456789f };
+
+		// More lines than a chunk of obj_write_lines
+		int const N = 20000;
+		mesh m;
+		m.position.resize(N);
+		m.normal.resize(N);
+		m.uv.resize(N);
+		for (int k = 0; k < N; ++k) {
+			float const a = special[k % special.size()];
+			float const b = special[(k / special.size()) % special.size()];
+			m.position[k] = { a, b, rand_interval(-1000.0f, 1000.0f) };
+			m.normal[k] = { rand_interval(-1, 1), a * rand_interval(), float(k) };
+			m.uv[k] = { b, rand_interval() * 1e-3f };
+		}
+		m.connectivity.resize(N / 2);
+		for (int k = 0; k < N / 2; ++k)
+			m.connectivity[k] = { unsigned(k), unsigned(N - 1 - k), unsigned(k) % 10 };
+
+		std::string const reference = obj_reference(m);
+		std::string const filename = "test_obj_writer.obj";
+
+		// The file is identical for any number of threads
+		int const N_thread_initial = parallel_number_of_threads();
+		for (int N_thread : { 1, 4 }) {
+			parallel_set_number_of_threads(N_thread);
+			save_file_obj(filename, m);
+			assert_cgp_no_msg(read_file(filename) == reference);
+		}
+		parallel_set_number_of_threads(N_thread_initial);
+
+		// Empty mesh
+		save_file_obj(filename, mesh());
+		assert_cgp_no_msg(read_file(filename).empty());
+
+		std::remove(filename.c_str());
+	}
+}
@@ -1,5 +1,8 @@
 #pragma once
 
 #include "structure/mesh.hpp"
+#include "topology/topology.hpp"
+#include "normal/normal.hpp"
 #include "primitive/mesh_primitive.hpp"
+#include "batch/mesh_batch.hpp"
 #include "loader/loader.hpp"
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "normal.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "cgp/core/simd/simd.hpp"
+
+#include <limits>
+
+namespace cgp
+{
+	void normal_per_vertex_structure::initialize(numarray<uint3> const& connectivity, int N_vertex)
+	{
+		int const N_tri = connectivity.size();
+
+		// Counting sort of the (vertex, triangle) pairs by vertex - the triangles remain in increasing order for each vertex
+		vertex_triangle_offset.resize(N_vertex + 1);
+		vertex_triangle_offset.fill(0);
+		for (int k_tri = 0; k_tri < N_tri; ++k_tri) {
+			uint3 const& face = connectivity.at(k_tri);
+			assert_cgp(face.x < unsigned(N_vertex) && face.y < unsigned(N_vertex) && face.z < unsigned(N_vertex), "Triangle " + str(k_tri) + " has an index exceeding the number of vertices " + str(N_vertex));
+			vertex_triangle_offset.at(face.x + 1)++;
+			vertex_triangle_offset.at(face.y + 1)++;
+			vertex_triangle_offset.at(face.z + 1)++;
+		}
+		for (int k = 0; k < N_vertex; ++k)
+			vertex_triangle_offset.at(k + 1) += vertex_triangle_offset.at(k);
+
+		vertex_triangle.resize(3 * N_tri);
+		numarray<int> current = vertex_triangle_offset;
+		for (int k_tri = 0; k_tri < N_tri; ++k_tri) {
+			uint3 const& face = connectivity.at(k_tri);
+			vertex_triangle.at(current.at(face.x)++) = k_tri;
+			vertex_triangle.at(current.at(face.y)++) = k_tri;
+			vertex_triangle.at(current.at(face.z)++) = k_tri;
+		}
+
+		triangle_normal.resize(N_tri);
+	}
+
+	void normal_per_vertex_structure::initialize(mesh_topology const& topology)
+	{
+		vertex_triangle_offset = topology.vertex_triangle_offset;
+		vertex_triangle = topology.vertex_triangle;
+		triangle_normal.resize(topology.N_triangle);
+	}
+
+	int normal_per_vertex_structure::number_of_vertex() const
+	{
+		return vertex_triangle_offset.size() > 0 ? vertex_triangle_offset.size() - 1 : 0;
+	}
+	int normal_per_vertex_structure::number_of_triangle() const
+	{
+		return vertex_triangle.size() / 3;
+	}
+
+	// Normals of the triangles [k_begin, k_end[, processed by blocks of S::size triangles
+	//  Same degeneracy criteria as normal_per_vertex: edges of length > 1e-6, and sine of the angle between the edges > 1e-6
+	//  position(i) returns the position of the vertex i
+	template <typename S, typename POSITION>
+	static int triangle_normal_block(vec3* triangle_normal, POSITION const& position, uint3 const* connectivity, int k_begin, int k_end, normal_weight weight)
+	{
+		int const W = S::size;
+		int k = k_begin;
+		for (; k + W <= k_end; k += W)
+		{
+			float e1[3][W], e2[3][W];
+			for (int i = 0; i < W; ++i) {
+				uint3 const& face = connectivity[k + i];
+				vec3 const p0 = position(face.x);
+				vec3 const p1 = position(face.y);
+				vec3 const p2 = position(face.z);
+				e1[0][i] = p1.x - p0.x; e1[1][i] = p1.y - p0.y; e1[2][i] = p1.z - p0.z;
+				e2[0][i] = p2.x - p0.x; e2[1][i] = p2.y - p0.y; e2[2][i] = p2.z - p0.z;
+			}
+
+			S const ax = S::load(e1[0]), ay = S::load(e1[1]), az = S::load(e1[2]);
+			S const bx = S::load(e2[0]), by = S::load(e2[1]), bz = S::load(e2[2]);
+
+			float n[3][W], L1[W], L2[W], Ln[W];
+			(ay * bz - az * by).store(n[0]);
+			(az * bx - ax * bz).store(n[1]);
+			(ax * by - ay * bx).store(n[2]);
+			sqrt(ax * ax + ay * ay + az * az).store(L1);
+			sqrt(bx * bx + by * by + bz * bz).store(L2);
+			S const nx = S::load(n[0]), ny = S::load(n[1]), nz = S::load(n[2]);
+			sqrt(nx * nx + ny * ny + nz * nz).store(Ln);
+
+			for (int i = 0; i < W; ++i) {
+				bool const valid = L1[i] > 1e-6f && L2[i] > 1e-6f && Ln[i] > 1e-6f * L1[i] * L2[i];
+				float const s = !valid ? 0.0f : (weight == normal_weight::uniform ? 1.0f / Ln[i] : 0.5f);
+				triangle_normal[k + i] = { s * n[0][i], s * n[1][i], s * n[2][i] };
+			}
+		}
+		return k;
+	}
+
+	static void assert_structure(normal_per_vertex_structure const& structure, int N, int N_tri)
+	{
+		assert_cgp(structure.number_of_vertex() == N && structure.number_of_triangle() == N_tri, "normal_per_vertex_structure is not initialized for this mesh (" + str(structure.number_of_vertex()) + " vertices and " + str(structure.number_of_triangle()) + " triangles, while the mesh has " + str(N) + " vertices and " + str(N_tri) + " triangles)");
+	}
+
+	// Normal of each triangle (unit, or with a norm equal to its area), then each vertex sums the normals of its triangles
+	//  position(i) returns the position of the vertex i, and set_normal(k, n) stores the normal of the vertex k
+	template <typename POSITION, typename SET_NORMAL>
+	static void normal_per_vertex_gather(int N, uint3 const* tri, int N_tri, POSITION const& position, normal_per_vertex_structure& structure, SET_NORMAL const& set_normal, bool invert, normal_weight weight)
+	{
+		vec3* tri_normal = structure.triangle_normal.data.data();
+		parallel_for(N_tri, [&](int k_begin, int k_end) {
+			int const k = triangle_normal_block<simd_float>(tri_normal, position, tri, k_begin, k_end, weight);
+			triangle_normal_block<simd_float_scalar>(tri_normal, position, tri, k, k_end, weight);
+		}, 4096);
+
+		int const* offset = structure.vertex_triangle_offset.data.data();
+		int const* adjacent = structure.vertex_triangle.data.data();
+		float const sign = invert ? -1.0f : 1.0f;
+		// The sum of area-weighted normals scales with the size of the triangles: only zero sums are not normalized
+		float const L_min = weight == normal_weight::uniform ? 1e-6f : std::numeric_limits<float>::min();
+		parallel_for(N, [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k) {
+				vec3 n = { 0,0,0 };
+				for (int j = offset[k]; j < offset[k + 1]; ++j)
+					n += tri_normal[adjacent[j]];
+
+				float const L = norm(n);
+				if (L > L_min)
+					n /= L;
+				set_normal(k, sign * n);
+			}
+		}, 4096);
+	}
+
+	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, normal_per_vertex_structure& structure, numarray<vec3>& normals, bool invert, normal_weight weight)
+	{
+		int const N = position.size();
+		int const N_tri = connectivity.size();
+		assert_structure(structure, N, N_tri);
+
+		if (normals.size() != N)
+			normals.resize(N);
+		if (N == 0)
+			return;
+
+		vec3 const* p = position.data.data();
+		vec3* n_vertex = normals.data.data();
+		normal_per_vertex_gather(N, connectivity.data.data(), N_tri, [p](unsigned int i) { return p[i]; }, structure,
+			[n_vertex](int k, vec3 const& n) { n_vertex[k] = n; }, invert, weight);
+	}
+
+	void normal_per_vertex(vec3_array const& position, numarray<uint3> const& connectivity, normal_per_vertex_structure& structure, vec3_array& normals, bool invert, normal_weight weight)
+	{
+		int const N = position.size();
+		int const N_tri = connectivity.size();
+		assert_structure(structure, N, N_tri);
+
+		if (normals.size() != N)
+			normals.resize(N);
+		if (N == 0)
+			return;
+
+		float const* px = position.x.data.data(), * py = position.y.data.data(), * pz = position.z.data.data();
+		float* nx = normals.x.data.data(), * ny = normals.y.data.data(), * nz = normals.z.data.data();
+		normal_per_vertex_gather(N, connectivity.data.data(), N_tri, [=](unsigned int i) { return vec3{ px[i], py[i], pz[i] }; }, structure,
+			[=](int k, vec3 const& n) { nx[k] = n.x; ny[k] = n.y; nz[k] = n.z; }, invert, weight);
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../structure/mesh.hpp"
+#include "../topology/topology.hpp"
+#include "cgp/geometry/vec/vec3_array/vec3_array.hpp"
+
+namespace cgp
+{
+	/** Weight of the normal of each triangle in the normal of its vertices */
+	enum class normal_weight {
+		uniform, // same weight for each adjacent triangle (as normal_per_vertex without structure)
+		area     // weight proportional to the area of the triangle
+	};
+
+	/** Data precomputed from the connectivity to update the per-vertex normals in parallel (ex. deforming surface with fixed connectivity)
+	* The triangles adjacent to the vertex k are stored in CSR format in vertex_triangle[vertex_triangle_offset[k] .. vertex_triangle_offset[k+1]-1],
+	*  in increasing order of triangle index. Each vertex gathers the normals of its triangles: no concurrent write is needed. */
+	struct normal_per_vertex_structure
+	{
+		numarray<int> vertex_triangle_offset; // size N_vertex+1
+		numarray<int> vertex_triangle;        // size 3*N_triangle
+		numarray<vec3> triangle_normal;       // temporary normal of each triangle (updated at each call)
+
+		/** Build the adjacency. Must be called again if the connectivity changes. */
+		void initialize(numarray<uint3> const& connectivity, int N_vertex);
+		/** Reuse the vertex to triangle incidence of an existing topology */
+		void initialize(mesh_topology const& topology);
+		int number_of_vertex() const;
+		int number_of_triangle() const;
+	};
+
+	/** Compute the per-vertex normals using the precomputed adjacency (see normal_per_vertex_structure)
+	* - The triangle normals are computed by blocks with SIMD, and the vertices gather their normals in parallel (see parallel_for).
+	* - With normal_weight::uniform the result is the same as normal_per_vertex(position, connectivity, normals_to_fill, invert) up to floating point rounding. */
+	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, normal_per_vertex_structure& structure, numarray<vec3>& normals_to_fill, bool invert = false, normal_weight weight = normal_weight::uniform);
+
+	/** Same as above for positions and normals stored as vec3_array (SoA), with the same result */
+	void normal_per_vertex(vec3_array const& position, numarray<uint3> const& connectivity, normal_per_vertex_structure& structure, vec3_array& normals_to_fill, bool invert = false, normal_weight weight = normal_weight::uniform);
+}
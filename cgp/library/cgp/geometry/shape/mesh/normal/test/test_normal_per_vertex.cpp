@@ -0,0 +1,100 @@
+#include "test_normal_per_vertex.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "../normal.hpp"
+#include "cgp/geometry/shape/mesh/primitive/mesh_primitive.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static bool is_close(numarray<vec3> const& a, numarray<vec3> const& b, float tolerance)
+	{
+		if (a.size() != b.size())
+			return false;
+		for (int k = 0; k < a.size(); ++k)
+			if (norm(a[k] - b[k]) > tolerance)
+				return false;
+		return true;
+	}
+
+	// Reference of the area weighted normals: sum of the cross products of the edges of the adjacent triangles
+	//  The degenerate triangles are ignored (same criteria as normal_per_vertex)
+	static numarray<vec3> normal_per_vertex_area_reference(numarray<vec3> const& position, numarray<uint3> const& connectivity)
+	{
+		numarray<vec3> normal(position.size());
+		for (uint3 const& f : connectivity) {
+			vec3 const e1 = position[f.y] - position[f.x];
+			vec3 const e2 = position[f.z] - position[f.x];
+			vec3 const n = cross(e1, e2);
+			if (norm(e1) > 1e-6f && norm(e2) > 1e-6f && norm(n) > 1e-6f * norm(e1) * norm(e2))
+				for (unsigned int i : f)
+					normal[i] += n;
+		}
+		for (vec3& n : normal)
+			if (norm(n) > 0)
+				n /= norm(n);
+		return normal;
+	}
+
+	// Compare the structure based normals with the serial normal_per_vertex
+	static void check_normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity)
+	{
+		normal_per_vertex_structure structure;
+		structure.initialize(connectivity, position.size());
+
+		numarray<vec3> const reference = normal_per_vertex(position, connectivity);
+		numarray<vec3> normal;
+		normal_per_vertex(position, connectivity, structure, normal);
+		assert_cgp_no_msg(is_close(normal, reference, 1e-5f));
+
+		// Invert, and reuse of the output buffer
+		numarray<vec3> const reference_invert = normal_per_vertex(position, connectivity, true);
+		normal_per_vertex(position, connectivity, structure, normal, true);
+		assert_cgp_no_msg(is_close(normal, reference_invert, 1e-5f));
+
+		// SoA version: same result as numarray<vec3>
+		vec3_array normal_soa;
+		normal_per_vertex(position, connectivity, structure, normal);
+		normal_per_vertex(vec3_array(position), connectivity, structure, normal_soa);
+		assert_cgp_no_msg(is_close(to_numarray(normal_soa), normal, 1e-6f));
+
+		// Area weights
+		normal_per_vertex(position, connectivity, structure, normal, false, normal_weight::area);
+		assert_cgp_no_msg(is_close(normal, normal_per_vertex_area_reference(position, connectivity), 1e-4f));
+	}
+
+	void test_normal_per_vertex()
+	{
+		int const N_thread_initial = parallel_number_of_threads();
+		for (int N_thread : { 1, 4 }) {
+			parallel_set_number_of_threads(N_thread);
+
+			// Deformed surface larger than the blocks of parallel_for
+			mesh m = mesh_primitive_torus(1.0f, 0.3f, { 0,0,0 }, { 0,0,1 }, 200, 50);
+			for (vec3& p : m.position)
+				p += 0.01f * vec3(rand_interval(), rand_interval(), rand_interval());
+			check_normal_per_vertex(m.position, m.connectivity);
+
+			// Degenerate triangles: repeated vertex, aligned vertices, tiny edge, and a vertex without triangle (5)
+			numarray<vec3> const position = { {0,0,0}, {1,0,0}, {0,1,0}, {2,0,0}, {1e-8f,0,0}, {3,3,3} };
+			numarray<uint3> const connectivity = { {0,1,2}, {0,0,1}, {0,1,3}, {0,4,2}, {1,3,2} };
+			check_normal_per_vertex(position, connectivity);
+
+			// Only degenerate triangles: the normals are zero
+			numarray<uint3> const degenerate = { {0,0,0}, {0,1,3} };
+			normal_per_vertex_structure structure;
+			structure.initialize(degenerate, position.size());
+			numarray<vec3> normal;
+			normal_per_vertex(position, degenerate, structure, normal);
+			for (vec3 const& n : normal)
+				assert_cgp_no_msg(norm(n) == 0.0f);
+
+			// Vertices without triangle, and empty mesh
+			check_normal_per_vertex(position, numarray<uint3>());
+			check_normal_per_vertex(numarray<vec3>(), numarray<uint3>());
+		}
+		parallel_set_number_of_threads(N_thread_initial);
+	}
+}
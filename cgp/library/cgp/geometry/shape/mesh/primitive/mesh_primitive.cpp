@@ -4,9 +4,10 @@
 namespace cgp
 {
 
-	static numarray<uint3> connectivity_grid(size_t Nu, size_t Nv)
+	// Append the triangles of a (Nu x Nv) grid of vertices
+	static void connectivity_grid(numarray<uint3>& connectivity, size_t Nu, size_t Nv)
 	{
-		numarray<uint3> connectivity;
+		connectivity.reserve(int(connectivity.size() + 2*(Nu-1)*(Nv-1)));
 		for(size_t ku=0; ku<Nu-1; ++ku) {
 			for(size_t kv=0; kv<Nv-1; ++kv) {
 				unsigned int k00 = static_cast<unsigned int>(kv   + Nv* ku);
@@ -18,7 +19,15 @@ namespace cgp
 				connectivity.push_back(uint3{k00, k11, k01});
 			}
 		}
-		return connectivity;
+	}
+
+	// Allocate once the buffers filled by the primitives
+	static void reserve(mesh& shape, int N_vertex, int N_triangle)
+	{
+		shape.position.reserve(N_vertex);
+		shape.normal.reserve(N_vertex);
+		shape.uv.reserve(N_vertex);
+		shape.connectivity.reserve(N_triangle);
 	}
 
 	mesh mesh_primitive_cylinder(float radius, vec3 const& p0, vec3 const& p1, int Nu, int Nv, bool is_closed)
@@ -31,6 +40,7 @@ namespace cgp
 		rotation_transform const R = rotation_transform::from_vector_transform({0,0,1}, dir);
 
 		mesh shape;
+		reserve(shape, Nu*Nv + (is_closed ? 2*(Nv+1) : 0), 2*(Nu-1)*(Nv-1) + (is_closed ? 2*(Nv-1) : 0));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -55,7 +65,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		if(is_closed){
 			shape.push_back( mesh_primitive_disc(radius, p0, dir, Nv).flip_connectivity() );
@@ -102,6 +112,7 @@ namespace cgp
 		assert_cgp(N>2, "Disc samples ("+str(N)+") must be >2");
 
 		mesh shape;
+		reserve(shape, N+1, N-1);
 
 		rotation_transform const r = rotation_transform::from_vector_transform({0,0,1}, normal);
 
@@ -131,6 +142,7 @@ namespace cgp
 		assert_cgp(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		reserve(shape, Nu*Nv + 2*(Nu-1), 2*(Nu-1)*(Nv-1) + 2*(Nu-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -154,7 +166,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		
 		// poles
@@ -189,6 +201,7 @@ namespace cgp
 		assert_cgp(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		reserve(shape, Nu*Nv + 2*(Nu-1), 2*(Nu-1)*(Nv-1) + 2*(Nu-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -212,7 +225,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		
 		// poles
@@ -249,6 +262,7 @@ namespace cgp
 		assert_cgp(Nv>1, "Grid sample must be >1");
 
 		mesh shape;
+		reserve(shape, Nu*Nv, 2*(Nu-1)*(Nv-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -267,7 +281,7 @@ namespace cgp
 				shape.uv.push_back(uv);
 			}
 		}
-     	shape.connectivity = connectivity_grid(Nu,Nv);
+     	connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.fill_empty_field();
 		shape.flip_connectivity();
 		return shape;
@@ -283,6 +297,7 @@ namespace cgp
 		rotation_transform R = rotation_transform::from_vector_transform({0,0,1}, axis_orientation);
 
 		mesh shape;
+		reserve(shape, Nu*Nv, 2*(Nu-1)*(Nv-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -306,7 +321,7 @@ namespace cgp
 				shape.uv.push_back({u,v});
 			}
 		}
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.fill_empty_field();
 		shape.flip_connectivity();
 		return shape;
@@ -320,6 +335,7 @@ namespace cgp
 
 
 		mesh shape;
+		reserve(shape, Nu*Nv + (Nu-1) + (is_closed_base ? Nu+1 : 0), 2*(Nu-1)*(Nv-1) + (Nu-1) + (is_closed_base ? Nu-1 : 0));
 		rotation_transform R = rotation_transform::from_vector_transform({0,0,1}, axis_direction);
 
 		//base
@@ -342,7 +358,7 @@ namespace cgp
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.flip_connectivity();
 
 		//Extremity
@@ -384,6 +400,7 @@ namespace cgp
 		vec3 p011 = p000 + u*vec3{0,1,1};
 
 		mesh shape;
+		reserve(shape, 6*4, 6*2);
 		shape.push_back(mesh_primitive_quadrangle(p000, p100, p101, p001));
 		shape.push_back(mesh_primitive_quadrangle(p100, p110, p111, p101));
 		shape.push_back(mesh_primitive_quadrangle(p110, p010, p011, p111));
@@ -401,6 +418,7 @@ namespace cgp
 
 
 		mesh shape;
+		reserve(shape, 2*(Nx*Nz + Ny*Nz + Nx*Ny), 4*((Nx-1)*(Nz-1) + (Ny-1)*(Nz-1) + (Nx-1)*(Ny-1)));
 		shape.push_back(mesh_primitive_grid(p000, p100, p101, p001, Nx, Nz));
 		shape.push_back(mesh_primitive_grid(p100, p110, p111, p101, Ny, Nz));
 		shape.push_back(mesh_primitive_grid(p110, p010, p011, p111, Nx, Nz));
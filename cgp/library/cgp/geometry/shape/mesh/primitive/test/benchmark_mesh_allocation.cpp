@@ -0,0 +1,100 @@
+#include "benchmark_mesh_allocation.hpp"
+
+#include "cgp/geometry/shape/mesh/mesh.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace cgp_test
+{
+	using namespace cgp;
+
+	// Number of allocations of a numarray filled with N push_back without reserve
+	template <typename T>
+	static int allocations_without_reserve(int N)
+	{
+		numarray<T> a;
+		int count = 0;
+		int capacity = a.capacity();
+		for (int k = 0; k < N; ++k) {
+			a.push_back(T());
+			if (a.capacity() != capacity) {
+				count++;
+				capacity = a.capacity();
+			}
+		}
+		return count;
+	}
+
+	// A non-empty buffer filled after a reserve of its final size has been allocated only once
+	template <typename T>
+	static int allocations(numarray<T> const& a, std::string const& name)
+	{
+		assert_cgp(a.capacity() == a.size(), name + ": a buffer has been reallocated");
+		return a.size() == 0 ? 0 : 1;
+	}
+
+	static double elapsed_ms(std::chrono::steady_clock::time_point t0)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+	}
+
+	static void display(std::string const& name, mesh const& m, double time_ms)
+	{
+		int const N = m.position.size();
+		int const N_tri = m.connectivity.size();
+		int const after = allocations(m.position, name) + allocations(m.normal, name) + allocations(m.color, name) + allocations(m.uv, name) + allocations(m.connectivity, name);
+		int const before = (after - 1) * allocations_without_reserve<vec3>(N) + allocations_without_reserve<uint3>(N_tri);
+
+		std::cout << name << " - " << N << " vertices, " << N_tri << " triangles: " << after << " allocations (" << before << " without reserve), " << time_ms << " ms" << std::endl;
+	}
+
+	void benchmark_mesh_allocation()
+	{
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			mesh const m = mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 1000, 1000);
+			display("mesh_primitive_grid", m, elapsed_ms(t0));
+		}
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			mesh const m = mesh_primitive_sphere(1.0f, { 0,0,0 }, 1000, 500);
+			display("mesh_primitive_sphere", m, elapsed_ms(t0));
+		}
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			mesh const m = mesh_primitive_cylinder(1.0f, { 0,0,0 }, { 0,0,1 }, 1000, 500, true);
+			display("mesh_primitive_cylinder", m, elapsed_ms(t0));
+		}
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			mesh const m = mesh_primitive_cone(1.0f, 1.0f, { 0,0,0 }, { 0,0,1 }, true, 1000, 500);
+			display("mesh_primitive_cone", m, elapsed_ms(t0));
+		}
+
+		// Loader: the mesh buffers are allocated once from the number of elements read in the file
+		{
+			std::string const filename = "benchmark_mesh_allocation.obj";
+			save_file_obj(filename, mesh_primitive_torus(1.0f, 0.25f, { 0,0,0 }, { 0,0,1 }, 700, 300));
+
+			auto t0 = std::chrono::steady_clock::now();
+			numarray<numarray<int> > correspondance;
+			mesh const m = mesh_load_file_obj(filename, correspondance);
+			display("mesh_load_file_obj", m, elapsed_ms(t0));
+			std::remove(filename.c_str());
+
+			// Append of an array of arrays: copy vs move
+			numarray<numarray<int> > copy, moved;
+			t0 = std::chrono::steady_clock::now();
+			copy.push_back(correspondance);
+			double const t_copy = elapsed_ms(t0);
+			t0 = std::chrono::steady_clock::now();
+			moved.push_back(std::move(correspondance));
+			double const t_move = elapsed_ms(t0);
+			assert_cgp_no_msg(copy.size() == moved.size());
+
+			std::cout << "numarray<numarray<int>>::push_back - " << moved.size() << " elements: copy " << t_copy << " ms, move " << t_move << " ms" << std::endl;
+		}
+	}
+}
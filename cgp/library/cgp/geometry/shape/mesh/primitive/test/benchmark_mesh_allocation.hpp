@@ -0,0 +1,9 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Number of allocations of the buffers of mesh_primitive_* and of the obj loader, compared to the same buffers filled with push_back without reserve
+	//  Also compares the copy and the move of a numarray<numarray<int>> appended to another one
+	void benchmark_mesh_allocation();
+}
@@ -1,6 +1,5 @@
 #include "mesh.hpp"
-
-#include <set>
+#include "../topology/topology.hpp"
 
 namespace cgp
 {
@@ -26,18 +25,27 @@ namespace cgp
 		return *this;
 	}
 
+	template <typename T>
+	static void append(numarray<T>& a, numarray<T> const& b)
+	{
+		a.data.insert(a.data.end(), b.data.begin(), b.data.end());
+	}
+
 	mesh& mesh::push_back(mesh const& to_add)
 	{
 		unsigned int const N_vertex = static_cast<unsigned int>(position.size());
 
-		position.push_back(to_add.position);
-		normal.push_back(to_add.normal);
-		color.push_back(to_add.color);
-		uv.push_back(to_add.uv);
-
+		append(position, to_add.position);
+		append(normal, to_add.normal);
+		append(color, to_add.color);
+		append(uv, to_add.uv);
 
-		for(auto const& tri : to_add.connectivity)
-			connectivity.push_back( tri + uint3{N_vertex,N_vertex,N_vertex} );
+		// Append the connectivity offset by the previous number of vertices (single allocation)
+		int const N_tri = connectivity.size();
+		int const N_tri_add = to_add.connectivity.size();
+		connectivity.resize(N_tri + N_tri_add);
+		for (int k = 0; k < N_tri_add; ++k)
+			connectivity.at(N_tri + k) = to_add.connectivity.at(k) + uint3{ N_vertex,N_vertex,N_vertex };
 
 		return *this;
 	}
@@ -46,10 +54,9 @@ namespace cgp
 	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, numarray<vec3>& normals, bool invert)
 	{
 		size_t const N = position.size();
-		if(normals.size()!=N)
-			normals.resize(N);
-		else
-			normals.fill(vec3{0,0,0});
+		// resize keeps the previous values of a reused array: all the normals are reset
+		normals.resize(N);
+		normals.fill(vec3{0,0,0});
 
 		size_t const N_tri = connectivity.size();
 		for (size_t k_tri = 0; k_tri < N_tri; ++k_tri)
@@ -227,27 +234,16 @@ namespace cgp
 
 	numarray<numarray<int> > connectivity_one_ring(numarray<uint3> const& connectivity)
 	{
-		size_t const N = connectivity.size();
-		numarray<std::set<int> > one_ring;
-		one_ring.resize(N);
-		for (size_t k = 0; k < N; ++k)
-		{
-			uint3 const& tri = connectivity[k];
-			one_ring[ get<0>(tri) ].insert( get<1>(tri) );
-			one_ring[ get<0>(tri) ].insert( get<2>(tri) );
-
-			one_ring[ get<1>(tri) ].insert( get<0>(tri) );
-			one_ring[ get<1>(tri) ].insert( get<2>(tri) );
-
-			one_ring[ get<2>(tri) ].insert( get<0>(tri) );
-			one_ring[ get<2>(tri) ].insert( get<1>(tri) );
-		}
+		mesh_topology topology;
+		topology.build(connectivity);
 
+		int const N = topology.N_vertex;
 		numarray<numarray<int> > one_ring_buffer;
 		one_ring_buffer.resize(N);
-		for(int k=0; k<N; ++k)
-			for(int idx : one_ring[k])
-				one_ring_buffer[k].push_back(idx);
+		for (int k = 0; k < N; ++k) {
+			int const* start = topology.one_ring.data.data() + topology.one_ring_offset[k];
+			one_ring_buffer[k].data.assign(start, start + topology.valence(k));
+		}
 		return one_ring_buffer;
 	}
 }
\ No newline at end of file
@@ -21,7 +21,8 @@ namespace cgp
 		* This function should be called before creating a mesh_drawable if there is empty buffers */
 		mesh& fill_empty_field();
 
-		/** Concatenate the content of another mesh to the current one */
+		/** Concatenate the content of another mesh to the current one
+		* Note: to merge a large number of meshes, prefer mesh_batch_builder that allocates the final buffers once */
 		mesh& push_back(mesh const& to_add);
 		mesh& flip_connectivity();
 		mesh& normal_update();
@@ -38,6 +39,8 @@ namespace cgp
 	bool mesh_check(mesh const& m);
 
 
+	/** Neighbors of each vertex (in increasing order), the size of the array is the number of vertices indexed by the connectivity
+	* Note: prefer using mesh_topology to avoid the allocation of one array per vertex */
 	numarray<numarray<int> > connectivity_one_ring(numarray<uint3> const& connectivity);
 
 	std::string str(mesh const& m);
@@ -0,0 +1,45 @@
+#include "test_mesh_topology.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../topology.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_mesh_topology()
+	{
+		// Square (0,1,2,3) split in two triangles sharing the edge (0,2), and a triangle (2,4,2) with a degenerate edge
+		numarray<uint3> connectivity = { {0,1,2}, {0,2,3}, {2,4,2} };
+
+		mesh_topology topology;
+		topology.build(connectivity);
+		assert_cgp_no_msg(topology.N_vertex == 5);
+		assert_cgp_no_msg(topology.N_triangle == 3);
+
+		// One-ring in increasing order, without the vertex itself
+		assert_cgp_no_msg(topology.valence(0) == 3);
+		assert_cgp_no_msg(topology.one_ring[topology.one_ring_offset[0]] == 1);
+		assert_cgp_no_msg(topology.one_ring[topology.one_ring_offset[0] + 1] == 2);
+		assert_cgp_no_msg(topology.one_ring[topology.one_ring_offset[0] + 2] == 3);
+		assert_cgp_no_msg(topology.valence(2) == 4);
+		assert_cgp_no_msg(topology.valence(4) == 1);
+		assert_cgp_no_msg(topology.number_of_edges() == 6);
+
+		// Incidence
+		assert_cgp_no_msg(topology.vertex_triangle_offset[3] - topology.vertex_triangle_offset[2] == 4);
+		assert_cgp_no_msg(topology.vertex_triangle[topology.vertex_triangle_offset[0]] == 0);
+		assert_cgp_no_msg(topology.vertex_triangle[topology.vertex_triangle_offset[0] + 1] == 1);
+
+		// Half-edge 2->0 of the first triangle (h=2) is opposite to 0->2 of the second one (h=3)
+		assert_cgp_no_msg(topology.opposite[2] == 3);
+		assert_cgp_no_msg(topology.opposite[3] == 2);
+		assert_cgp_no_msg(topology.is_boundary(0));
+		assert_cgp_no_msg(mesh_topology::half_edge_next(2) == 0);
+		assert_cgp_no_msg(mesh_topology::half_edge_triangle(5) == 1);
+
+		// Edge (2,4) is shared by two half-edges of reverse directions in the degenerate triangle
+		assert_cgp_no_msg(topology.opposite[6] == 7);
+		assert_cgp_no_msg(topology.is_boundary(8));
+	}
+}
@@ -0,0 +1,204 @@
+#include "topology.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace cgp
+{
+	// Half-edge stored in the bucket of the smallest vertex of its edge
+	struct topology_half_edge
+	{
+		int vertex; // largest vertex of the edge
+		int h;
+	};
+
+	// Stable sort of a bucket by vertex - insertion sort for the (usual) small buckets
+	static void sort_bucket(topology_half_edge* start, topology_half_edge* end)
+	{
+		if (end - start > 32) {
+			std::stable_sort(start, end, [](topology_half_edge const& u, topology_half_edge const& v) { return u.vertex < v.vertex; });
+			return;
+		}
+		for (topology_half_edge* it = start + 1; it < end; ++it) {
+			topology_half_edge const value = *it;
+			topology_half_edge* j = it;
+			for (; j > start && (j - 1)->vertex > value.vertex; --j)
+				*j = *(j - 1);
+			*j = value;
+		}
+	}
+
+	static void csr_offset_from_count(numarray<int>& offset)
+	{
+		int const N = offset.size() - 1;
+		for (int k = 0; k < N; ++k)
+			offset.at(k + 1) += offset.at(k);
+	}
+
+	void mesh_topology::build(numarray<uint3> const& connectivity, int N_vertex_arg)
+	{
+		N_triangle = connectivity.size();
+		N_vertex = N_vertex_arg;
+		if (N_vertex < 0) {
+			unsigned int max_index = 0;
+			for (int k = 0; k < N_triangle; ++k) {
+				uint3 const& f = connectivity.at(k);
+				max_index = std::max(max_index, std::max(f.x, std::max(f.y, f.z)));
+			}
+			N_vertex = N_triangle > 0 ? int(max_index) + 1 : 0;
+		}
+		int const N_half_edge = 3 * N_triangle;
+
+		auto origin = [&connectivity](int h) { return int(connectivity.at(h / 3)[h % 3]); };
+
+		// Sort the half-edges by undirected edge (a,b), a<=b:
+		//  counting sort by a, then each bucket is sorted by b in parallel (ties kept in increasing half-edge index)
+		numarray<int> bucket_offset;
+		bucket_offset.resize(N_vertex + 1);
+		bucket_offset.fill(0);
+		for (int t = 0; t < N_triangle; ++t) {
+			uint3 const& f = connectivity.at(t);
+			assert_cgp(f.x < unsigned(N_vertex) && f.y < unsigned(N_vertex) && f.z < unsigned(N_vertex), "Triangle " + str(t) + " has an index exceeding the number of vertices " + str(N_vertex));
+			bucket_offset.at(int(std::min(f.x, f.y)) + 1)++;
+			bucket_offset.at(int(std::min(f.y, f.z)) + 1)++;
+			bucket_offset.at(int(std::min(f.z, f.x)) + 1)++;
+		}
+		csr_offset_from_count(bucket_offset);
+
+		std::vector<topology_half_edge> half_edge(N_half_edge);
+		{
+			numarray<int> current = bucket_offset;
+			for (int t = 0; t < N_triangle; ++t) {
+				uint3 const& f = connectivity.at(t);
+				half_edge[current.at(int(std::min(f.x, f.y)))++] = { int(std::max(f.x, f.y)), 3 * t };
+				half_edge[current.at(int(std::min(f.y, f.z)))++] = { int(std::max(f.y, f.z)), 3 * t + 1 };
+				half_edge[current.at(int(std::min(f.z, f.x)))++] = { int(std::max(f.z, f.x)), 3 * t + 2 };
+			}
+		}
+
+		// Number of distinct non-degenerate edges starting in each bucket
+		numarray<int> edge_count;
+		edge_count.resize(N_vertex);
+		int const* offset = bucket_offset.data.data();
+		parallel_for(N_vertex, [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k) {
+				topology_half_edge* const start = half_edge.data() + offset[k];
+				topology_half_edge* const end = half_edge.data() + offset[k + 1];
+				sort_bucket(start, end);
+
+				int count = 0;
+				for (topology_half_edge* it = start; it != end; ++it)
+					if (it->vertex != k && (it == start || it->vertex != (it - 1)->vertex))
+						count++;
+				edge_count.at(k) = count;
+			}
+		}, 1024);
+
+		// Opposite half-edges: an edge shared by exactly two half-edges of reverse directions
+		opposite.resize(N_half_edge);
+		opposite.fill(-1);
+		parallel_for(N_vertex, [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k) {
+				int j = offset[k];
+				while (j < offset[k + 1]) {
+					int j_end = j + 1;
+					while (j_end < offset[k + 1] && half_edge[j_end].vertex == half_edge[j].vertex)
+						j_end++;
+					if (j_end - j == 2) {
+						int const h0 = half_edge[j].h;
+						int const h1 = half_edge[j + 1].h;
+						if (origin(h0) != origin(h1)) {
+							opposite.at(h0) = h1;
+							opposite.at(h1) = h0;
+						}
+					}
+					j = j_end;
+				}
+			}
+		}, 1024);
+
+		// One-ring from the distinct edges (a,b) with a<b - degenerate edges (a,a) are ignored
+		//  Visiting the edges by increasing (a,b) and filling first the neighbors a of each b, then the neighbors b of each a, gives increasing neighbors
+		one_ring_offset.resize(N_vertex + 1);
+		one_ring_offset.fill(0);
+		for (int a = 0; a < N_vertex; ++a) {
+			one_ring_offset.at(a + 1) += edge_count.at(a);
+			for (int j = offset[a]; j < offset[a + 1]; ++j) {
+				int const b = half_edge[j].vertex;
+				if (b != a && (j == offset[a] || b != half_edge[j - 1].vertex))
+					one_ring_offset.at(b + 1)++;
+			}
+		}
+		csr_offset_from_count(one_ring_offset);
+
+		one_ring.resize(one_ring_offset.at(N_vertex));
+		numarray<int> current = one_ring_offset;
+		for (int a = 0; a < N_vertex; ++a) {
+			for (int j = offset[a]; j < offset[a + 1]; ++j) {
+				int const b = half_edge[j].vertex;
+				if (b != a && (j == offset[a] || b != half_edge[j - 1].vertex))
+					one_ring.at(current.at(b)++) = a;
+			}
+		}
+		for (int a = 0; a < N_vertex; ++a) {
+			for (int j = offset[a]; j < offset[a + 1]; ++j) {
+				int const b = half_edge[j].vertex;
+				if (b != a && (j == offset[a] || b != half_edge[j - 1].vertex))
+					one_ring.at(current.at(a)++) = b;
+			}
+		}
+
+		// Vertex to triangle incidence (counting sort keeps the triangles in increasing order)
+		vertex_triangle_offset.resize(N_vertex + 1);
+		vertex_triangle_offset.fill(0);
+		for (int t = 0; t < N_triangle; ++t) {
+			uint3 const& f = connectivity.at(t);
+			vertex_triangle_offset.at(f.x + 1)++;
+			vertex_triangle_offset.at(f.y + 1)++;
+			vertex_triangle_offset.at(f.z + 1)++;
+		}
+		csr_offset_from_count(vertex_triangle_offset);
+
+		vertex_triangle.resize(N_half_edge);
+		current = vertex_triangle_offset;
+		for (int t = 0; t < N_triangle; ++t) {
+			uint3 const& f = connectivity.at(t);
+			vertex_triangle.at(current.at(f.x)++) = t;
+			vertex_triangle.at(current.at(f.y)++) = t;
+			vertex_triangle.at(current.at(f.z)++) = t;
+		}
+	}
+
+	int mesh_topology::valence(int k) const
+	{
+		return one_ring_offset[k + 1] - one_ring_offset[k];
+	}
+	int mesh_topology::number_of_edges() const
+	{
+		return one_ring.size() / 2;
+	}
+	bool mesh_topology::is_boundary(int h) const
+	{
+		return opposite[h] == -1;
+	}
+	int mesh_topology::half_edge_next(int h)
+	{
+		return h % 3 == 2 ? h - 2 : h + 1;
+	}
+	int mesh_topology::half_edge_triangle(int h)
+	{
+		return h / 3;
+	}
+
+	std::string str(mesh_topology const& topology)
+	{
+		return "mesh_topology[N_vertex=" + str(topology.N_vertex) + "][N_triangle=" + str(topology.N_triangle) + "][N_edge=" + str(topology.number_of_edges()) + "]";
+	}
+	std::string type_str(mesh_topology const&)
+	{
+		return "mesh_topology";
+	}
+}
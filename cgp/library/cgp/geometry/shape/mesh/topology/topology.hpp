@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../structure/mesh.hpp"
+
+namespace cgp
+{
+	/** Adjacency information of a triangular mesh stored in contiguous arrays (CSR format)
+	* - One-ring: the neighbors of the vertex k are one_ring[one_ring_offset[k] .. one_ring_offset[k+1]-1], in increasing order
+	* - Incidence: the triangles adjacent to the vertex k are vertex_triangle[vertex_triangle_offset[k] .. vertex_triangle_offset[k+1]-1], in increasing order
+	* - Half-edges: the half-edge h=3*t+i goes from connectivity[t][i] to connectivity[t][(i+1)%3].
+	*   opposite[h] is the half-edge going in the reverse direction in the adjacent triangle, or -1 if the edge is on the boundary
+	*   (or if it is non-manifold / inconsistently oriented: shared by more than two half-edges, or by two half-edges of the same direction)
+	* The structure is built once from the connectivity (sorting the half-edges by edge: counting sort on the first vertex, and sort of each bucket in parallel),
+	* and can be shared by the algorithms working on a fixed connectivity (smoothing, deformation, normals). */
+	struct mesh_topology
+	{
+		int N_vertex = 0;
+		int N_triangle = 0;
+
+		numarray<int> one_ring_offset;        // size N_vertex+1
+		numarray<int> one_ring;               // size 2*N_edge
+		numarray<int> vertex_triangle_offset; // size N_vertex+1
+		numarray<int> vertex_triangle;        // size 3*N_triangle
+		numarray<int> opposite;               // size 3*N_triangle
+
+		/** Build the topology from the connectivity. The number of vertices is deduced from the connectivity (max index+1) if N_vertex<0 */
+		void build(numarray<uint3> const& connectivity, int N_vertex = -1);
+
+		/** Number of neighbors of the vertex k */
+		int valence(int k) const;
+		/** Number of edges (each edge counted once) */
+		int number_of_edges() const;
+		/** True if the half-edge h has no opposite half-edge */
+		bool is_boundary(int h) const;
+
+		/** Half-edge following h in its triangle, and its triangle */
+		static int half_edge_next(int h);
+		static int half_edge_triangle(int h);
+	};
+
+	std::string str(mesh_topology const& topology);
+	std::string type_str(mesh_topology const&);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cgp/geometry/vec/vec.hpp"
+#include "noise_batch/noise_batch.hpp"
 
 namespace cgp
 {
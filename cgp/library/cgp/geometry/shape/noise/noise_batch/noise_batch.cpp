@@ -0,0 +1,284 @@
+#include "noise_batch.hpp"
+
+#include "cgp/core/simd/simd.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include "third_party/src/simplexnoise/simplexnoise1234.hpp"
+
+namespace cgp
+{
+	// Permutation table of simplexnoise1234: the batch version must use the same table to generate the same noise as snoise2/snoise3
+	static unsigned char const* const perm = snoise_permutation();
+
+	// Gradient directions used by grad2 (8 directions) and grad3 (12 directions, 16 entries) of simplexnoise1234
+	//  grad(hash, x,y,z) = gx*x + gy*y + gz*z
+	static float const lut_grad2[8][2] = {
+		{1,2}, {-1,2}, {1,-2}, {-1,-2}, {2,1}, {2,-1}, {-2,1}, {-2,-1} };
+	static float const lut_grad3[16][3] = {
+		{1,1,0}, {-1,1,0}, {1,-1,0}, {-1,-1,0},
+		{1,0,1}, {-1,0,1}, {1,0,-1}, {-1,0,-1},
+		{0,1,1}, {0,-1,1}, {0,1,-1}, {0,-1,-1},
+		{1,1,0}, {0,-1,1}, {-1,1,0}, {0,-1,-1} };
+
+	static int fast_floor(double x)
+	{
+		int const i = static_cast<int>(x);
+		return x < i ? i - 1 : i;
+	}
+
+	// Contribution of a corner of the simplex: max(r2 - |d|^2, 0)^4 * dot(g, d)
+	template <typename S>
+	static S simplex_corner(S r2, S dx, S dy, S gx, S gy)
+	{
+		S t = max(r2 - dx * dx - dy * dy, S::broadcast(0.0f));
+		t = t * t;
+		return t * t * (gx * dx + gy * dy);
+	}
+	template <typename S>
+	static S simplex_corner(S r2, S dx, S dy, S dz, S gx, S gy, S gz)
+	{
+		S t = max(r2 - dx * dx - dy * dy - dz * dz, S::broadcast(0.0f));
+		t = t * t;
+		return t * t * (gx * dx + gy * dy + gz * dz);
+	}
+
+	// 2D simplex noise (snoise2) evaluated on S::size points
+	//  The skew, the cell and the simplex selection are computed per point in double precision, with the same expressions as snoise2,
+	//  so that the points on the boundary of a simplex are attributed to the same simplex. Only the offsets to the corners
+	//  (of order 1) are then converted to float: the falloff and the gradients are evaluated on all the points at once.
+	template <typename S>
+	static S simplex_noise(S x, S y)
+	{
+		enum { W = S::size };
+		double const F2 = 0.366025403;
+		double const G2 = 0.211324865;
+
+		float xf[W], yf[W];
+		x.store(xf); y.store(yf);
+
+		float x0_[W], y0_[W];
+		float i1[W], j1[W];
+		float g[3][2][W];
+		for (int l = 0; l < W; ++l) {
+			double const px = xf[l], py = yf[l];
+			double const s = (px + py) * F2;
+			int const i = fast_floor(px + s);
+			int const j = fast_floor(py + s);
+			double const t = double(i + j) * G2;
+			double const x0 = px - (i - t);
+			double const y0 = py - (j - t);
+			x0_[l] = float(x0); y0_[l] = float(y0);
+
+			int const a = x0 > y0 ? 1 : 0;
+			int const b = 1 - a;
+			i1[l] = float(a); j1[l] = float(b);
+
+			int const ii = i & 255, jj = j & 255;
+			int const h[3] = { perm[ii + perm[jj]], perm[ii + a + perm[jj + b]], perm[ii + 1 + perm[jj + 1]] };
+			for (int c = 0; c < 3; ++c) {
+				g[c][0][l] = lut_grad2[h[c] & 7][0];
+				g[c][1][l] = lut_grad2[h[c] & 7][1];
+			}
+		}
+
+		S const x0 = S::load(x0_), y0 = S::load(y0_);
+		S const x1 = x0 - S::load(i1) + S::broadcast(float(G2));
+		S const y1 = y0 - S::load(j1) + S::broadcast(float(G2));
+		S const x2 = x0 - S::broadcast(float(1.0 - 2.0 * G2));
+		S const y2 = y0 - S::broadcast(float(1.0 - 2.0 * G2));
+
+		S const r2 = S::broadcast(0.5f);
+		S const n0 = simplex_corner(r2, x0, y0, S::load(g[0][0]), S::load(g[0][1]));
+		S const n1 = simplex_corner(r2, x1, y1, S::load(g[1][0]), S::load(g[1][1]));
+		S const n2 = simplex_corner(r2, x2, y2, S::load(g[2][0]), S::load(g[2][1]));
+		return S::broadcast(40.0f) * (n0 + n1 + n2);
+	}
+
+	// 3D simplex noise (snoise3) evaluated on S::size points (same precision split as the 2D version)
+	template <typename S>
+	static S simplex_noise(S x, S y, S z)
+	{
+		enum { W = S::size };
+		double const F3 = 0.333333333;
+		double const G3 = 0.166666667;
+
+		float xf[W], yf[W], zf[W];
+		x.store(xf); y.store(yf); z.store(zf);
+
+		float x0_[W], y0_[W], z0_[W];
+		float o1[3][W], o2[3][W];
+		float g[4][3][W];
+		for (int l = 0; l < W; ++l) {
+			double const px = xf[l], py = yf[l], pz = zf[l];
+			double const s = (px + py + pz) * F3;
+			int const i = fast_floor(px + s);
+			int const j = fast_floor(py + s);
+			int const k = fast_floor(pz + s);
+			double const t = double(i + j + k) * G3;
+			double const x0 = px - (i - t);
+			double const y0 = py - (j - t);
+			double const z0 = pz - (k - t);
+			x0_[l] = float(x0); y0_[l] = float(y0); z0_[l] = float(z0);
+
+			// Order of the coordinates giving the simplex in which the point lies
+			int i1, j1, k1, i2, j2, k2;
+			if (x0 >= y0) {
+				if (y0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+				else if (x0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+				else { i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+			}
+			else {
+				if (y0 < z0) { i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+				else if (x0 < z0) { i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+				else { i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+			}
+			o1[0][l] = float(i1); o1[1][l] = float(j1); o1[2][l] = float(k1);
+			o2[0][l] = float(i2); o2[1][l] = float(j2); o2[2][l] = float(k2);
+
+			int const a = i & 255, b = j & 255, c = k & 255;
+			int const h[4] = {
+				perm[a + perm[b + perm[c]]],
+				perm[a + i1 + perm[b + j1 + perm[c + k1]]],
+				perm[a + i2 + perm[b + j2 + perm[c + k2]]],
+				perm[a + 1 + perm[b + 1 + perm[c + 1]]] };
+			for (int corner = 0; corner < 4; ++corner)
+				for (int d = 0; d < 3; ++d)
+					g[corner][d][l] = lut_grad3[h[corner] & 15][d];
+		}
+
+		S const x0 = S::load(x0_), y0 = S::load(y0_), z0 = S::load(z0_);
+		S const x1 = x0 - S::load(o1[0]) + S::broadcast(float(G3));
+		S const y1 = y0 - S::load(o1[1]) + S::broadcast(float(G3));
+		S const z1 = z0 - S::load(o1[2]) + S::broadcast(float(G3));
+		S const x2 = x0 - S::load(o2[0]) + S::broadcast(float(2.0 * G3));
+		S const y2 = y0 - S::load(o2[1]) + S::broadcast(float(2.0 * G3));
+		S const z2 = z0 - S::load(o2[2]) + S::broadcast(float(2.0 * G3));
+		S const x3 = x0 - S::broadcast(float(1.0 - 3.0 * G3));
+		S const y3 = y0 - S::broadcast(float(1.0 - 3.0 * G3));
+		S const z3 = z0 - S::broadcast(float(1.0 - 3.0 * G3));
+
+		S const r2 = S::broadcast(0.6f);
+		S const n0 = simplex_corner(r2, x0, y0, z0, S::load(g[0][0]), S::load(g[0][1]), S::load(g[0][2]));
+		S const n1 = simplex_corner(r2, x1, y1, z1, S::load(g[1][0]), S::load(g[1][1]), S::load(g[1][2]));
+		S const n2 = simplex_corner(r2, x2, y2, z2, S::load(g[2][0]), S::load(g[2][1]), S::load(g[2][2]));
+		S const n3 = simplex_corner(r2, x3, y3, z3, S::load(g[3][0]), S::load(g[3][1]), S::load(g[3][2]));
+		return S::broadcast(32.0f) * (n0 + n1 + n2 + n3);
+	}
+
+	// Sum of the octaves of noise_perlin evaluated on S::size points
+	template <typename S>
+	static void noise_perlin_octaves(float* values, float const* x, float const* y, int octave, float persistency, float frequency_gain)
+	{
+		S const px = S::load(x), py = S::load(y);
+		S value = S::broadcast(0.0f);
+		float a = 1.0f; // current magnitude
+		float f = 1.0f; // current frequency
+		for (int k = 0; k < octave; k++)
+		{
+			S const n = simplex_noise(px * S::broadcast(f), py * S::broadcast(f));
+			value = value + S::broadcast(a) * (S::broadcast(0.5f) + S::broadcast(0.5f) * n);
+			f *= frequency_gain;
+			a *= persistency;
+		}
+		value.store(values);
+	}
+	template <typename S>
+	static void noise_perlin_octaves(float* values, float const* x, float const* y, float const* z, int octave, float persistency, float frequency_gain)
+	{
+		S const px = S::load(x), py = S::load(y), pz = S::load(z);
+		S value = S::broadcast(0.0f);
+		float a = 1.0f; // current magnitude
+		float f = 1.0f; // current frequency
+		for (int k = 0; k < octave; k++)
+		{
+			S const n = simplex_noise(px * S::broadcast(f), py * S::broadcast(f), pz * S::broadcast(f));
+			value = value + S::broadcast(a) * (S::broadcast(0.5f) + S::broadcast(0.5f) * n);
+			f *= frequency_gain;
+			a *= persistency;
+		}
+		value.store(values);
+	}
+
+	// Serial evaluation on a range of points: full SIMD registers, then the remaining points one by one
+	static void noise_perlin_range(float* values, float const* x, float const* y, int N, int octave, float persistency, float frequency_gain)
+	{
+		int k = 0;
+		for (; k + simd_float::size <= N; k += simd_float::size)
+			noise_perlin_octaves<simd_float>(values + k, x + k, y + k, octave, persistency, frequency_gain);
+		for (; k < N; ++k)
+			noise_perlin_octaves<simd_float_scalar>(values + k, x + k, y + k, octave, persistency, frequency_gain);
+	}
+	static void noise_perlin_range(float* values, float const* x, float const* y, float const* z, int N, int octave, float persistency, float frequency_gain)
+	{
+		int k = 0;
+		for (; k + simd_float::size <= N; k += simd_float::size)
+			noise_perlin_octaves<simd_float>(values + k, x + k, y + k, z + k, octave, persistency, frequency_gain);
+		for (; k < N; ++k)
+			noise_perlin_octaves<simd_float_scalar>(values + k, x + k, y + k, z + k, octave, persistency, frequency_gain);
+	}
+
+
+	void noise_perlin(float* values, float const* x, float const* y, int N, int octave, float persistency, float frequency_gain)
+	{
+		parallel_for(N, [&](int k_begin, int k_end) {
+			noise_perlin_range(values + k_begin, x + k_begin, y + k_begin, k_end - k_begin, octave, persistency, frequency_gain);
+		}, 1024);
+	}
+
+	void noise_perlin(float* values, float const* x, float const* y, float const* z, int N, int octave, float persistency, float frequency_gain)
+	{
+		parallel_for(N, [&](int k_begin, int k_end) {
+			noise_perlin_range(values + k_begin, x + k_begin, y + k_begin, z + k_begin, k_end - k_begin, octave, persistency, frequency_gain);
+		}, 1024);
+	}
+
+	// The grids are processed by rows along x, whose coordinates are generated in small chunks
+	static int const chunk_size = 256;
+
+	void noise_perlin(grid_2D<float>& values, vec2 const& origin, vec2 const& step, int octave, float persistency, float frequency_gain)
+	{
+		int const Nx = values.dimension.x;
+		int const Ny = values.dimension.y;
+		int const grain_size = std::max(1, 1024 / std::max(Nx, 1));
+
+		parallel_for(Ny, [&](int ky_begin, int ky_end) {
+			float x[chunk_size], y[chunk_size];
+			for (int ky = ky_begin; ky < ky_end; ++ky) {
+				for (int kx_begin = 0; kx_begin < Nx; kx_begin += chunk_size) {
+					int const N = std::min(chunk_size, Nx - kx_begin);
+					for (int k = 0; k < N; ++k) {
+						x[k] = origin.x + (kx_begin + k) * step.x;
+						y[k] = origin.y + ky * step.y;
+					}
+					noise_perlin_range(&values(kx_begin, ky), x, y, N, octave, persistency, frequency_gain);
+				}
+			}
+		}, grain_size);
+	}
+
+	void noise_perlin(grid_3D<float>& values, vec3 const& origin, vec3 const& step, int octave, float persistency, float frequency_gain)
+	{
+		int const Nx = values.dimension.x;
+		int const Ny = values.dimension.y;
+		int const Nz = values.dimension.z;
+		int const grain_size = std::max(1, 1024 / std::max(Nx, 1));
+
+		// Each task processes a set of rows (ky,kz)
+		parallel_for(Ny * Nz, [&](int row_begin, int row_end) {
+			float x[chunk_size], y[chunk_size], z[chunk_size];
+			for (int row = row_begin; row < row_end; ++row) {
+				int const ky = row % Ny;
+				int const kz = row / Ny;
+				for (int kx_begin = 0; kx_begin < Nx; kx_begin += chunk_size) {
+					int const N = std::min(chunk_size, Nx - kx_begin);
+					for (int k = 0; k < N; ++k) {
+						x[k] = origin.x + (kx_begin + k) * step.x;
+						y[k] = origin.y + ky * step.y;
+						z[k] = origin.z + kz * step.z;
+					}
+					noise_perlin_range(&values(kx_begin, ky, kz), x, y, z, N, octave, persistency, frequency_gain);
+				}
+			}
+		}, grain_size);
+	}
+}
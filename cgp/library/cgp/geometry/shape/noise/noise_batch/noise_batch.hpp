@@ -0,0 +1,25 @@
+#pragma once
+
+#include "cgp/geometry/vec/vec.hpp"
+#include "cgp/core/containers/grid/grid.hpp"
+
+namespace cgp
+{
+	/** Batch evaluation of noise_perlin over many points
+	* - The simplex noise is evaluated on several points at once (see simd_float), and the points are
+	*   distributed over threads (see parallel_for - set parallel_set_number_of_threads(1) to stay on the calling thread).
+	* - The simplex cell of each point is selected in double precision as in the scalar noise_perlin, only the gradient and falloff
+	*   terms are evaluated in float. The result matches the scalar version within about 1e-6 (for coordinates of order 1 as well as
+	*   several hundreds, see test_noise_batch).
+	* - Unlike the scalar version, negative coordinates are handled by wrapping the noise periodically every 256 units. */
+
+	// values[k] = noise_perlin(vec2{x[k],y[k]}, ...) for k in [0,N[
+	void noise_perlin(float* values, float const* x, float const* y, int N, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+	// values[k] = noise_perlin(vec3{x[k],y[k],z[k]}, ...) for k in [0,N[
+	void noise_perlin(float* values, float const* x, float const* y, float const* z, int N, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+
+	// values(kx,ky) = noise_perlin(origin + vec2{kx,ky} * step, ...) for each element of the grid (the grid must be already allocated)
+	void noise_perlin(grid_2D<float>& values, vec2 const& origin, vec2 const& step, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+	// values(kx,ky,kz) = noise_perlin(origin + vec3{kx,ky,kz} * step, ...) for each element of the grid (the grid must be already allocated)
+	void noise_perlin(grid_3D<float>& values, vec3 const& origin, vec3 const& step, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+}
@@ -0,0 +1,58 @@
+#include "test_noise_batch.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../noise_batch.hpp"
+#include "../../noise.hpp"
+
+#include <cmath>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// The batch evaluation matches the scalar noise_perlin up to the float rounding of the gradient and falloff terms
+	static float const tolerance = 1e-5f;
+
+	void test_noise_batch()
+	{
+		// Arbitrary points (size that is not a multiple of the SIMD width), including points with equal coordinates
+		//  lying on the boundary between simplices
+		int const N = 1003;
+		std::vector<float> x(N), y(N), z(N), values(N);
+		for (int k = 0; k < N; ++k) {
+			x[k] = rand_interval(0.01f, 20.0f); y[k] = rand_interval(0.01f, 20.0f); z[k] = rand_interval(0.01f, 20.0f);
+			if (k % 7 == 0) { y[k] = x[k]; z[k] = x[k]; }
+		}
+		x[0] = 1.09f; y[0] = 1.33f; z[0] = 1.09f;
+
+		for (int octave = 1; octave <= 6; ++octave) {
+			noise_perlin(values.data(), x.data(), y.data(), N, octave, 0.4f, 2.0f);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(std::abs(values[k] - noise_perlin(vec2(x[k], y[k]), octave, 0.4f, 2.0f)) < tolerance);
+
+			noise_perlin(values.data(), x.data(), y.data(), z.data(), N, octave, 0.4f, 2.0f);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(std::abs(values[k] - noise_perlin(vec3(x[k], y[k], z[k]), octave, 0.4f, 2.0f)) < tolerance);
+		}
+
+		// Grids with an origin of equal components
+		for (int octave = 1; octave <= 5; octave += 2) {
+			grid_2D<float> grid_2(37, 23);
+			vec2 const origin_2 = { 1.25f, 1.25f };
+			vec2 const step_2 = { 0.11f, 0.11f };
+			noise_perlin(grid_2, origin_2, step_2, octave);
+			for (int ky = 0; ky < 23; ++ky)
+				for (int kx = 0; kx < 37; ++kx)
+					assert_cgp_no_msg(std::abs(grid_2(kx, ky) - noise_perlin(origin_2 + vec2(kx, ky) * step_2, octave)) < tolerance);
+
+			grid_3D<float> grid_3(19, 11, 7);
+			vec3 const origin_3 = { 1.09f, 1.09f, 1.09f };
+			vec3 const step_3 = { 0.13f, 0.13f, 0.13f };
+			noise_perlin(grid_3, origin_3, step_3, octave);
+			for (int kz = 0; kz < 7; ++kz)
+				for (int ky = 0; ky < 11; ++ky)
+					for (int kx = 0; kx < 19; ++kx)
+						assert_cgp_no_msg(std::abs(grid_3(kx, ky, kz) - noise_perlin(origin_3 + vec3(kx, ky, kz) * step_3, octave)) < tolerance);
+		}
+	}
+}
@@ -5,4 +5,5 @@
 #include "noise/noise.hpp"
 #include "intersection/intersection.hpp"
 #include "implicit/implicit.hpp"
-#include "spatial_domain/spatial_domain.hpp"
\ No newline at end of file
+#include "spatial_domain/spatial_domain.hpp"
+#include "bounding_volume/bounding_volume.hpp"
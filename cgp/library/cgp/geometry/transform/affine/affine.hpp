@@ -2,4 +2,5 @@
 
 #include "affine_rt/affine_rt.hpp"
 #include "affine_rts/affine_rts.hpp"
-#include "affine/affine.hpp"
\ No newline at end of file
+#include "affine/affine.hpp"
+#include "affine_rts_batch/affine_rts_batch.hpp"
\ No newline at end of file
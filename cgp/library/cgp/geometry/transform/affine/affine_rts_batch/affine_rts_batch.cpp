@@ -0,0 +1,254 @@
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/simd/simd.hpp"
+#include "affine_rts_batch.hpp"
+
+namespace cgp
+{
+	affine_rts_soa::affine_rts_soa()
+		:qx(), qy(), qz(), qw(), tx(), ty(), tz(), s()
+	{}
+
+	affine_rts_soa::affine_rts_soa(numarray<affine_rts> const& T)
+	{
+		int const N = T.size();
+		resize(N);
+		for (int k = 0; k < N; ++k)
+			set(k, T.at(k));
+	}
+
+	int affine_rts_soa::size() const
+	{
+		return s.size();
+	}
+
+	affine_rts_soa& affine_rts_soa::resize(int N)
+	{
+		qx.resize(N); qy.resize(N); qz.resize(N); qw.resize(N);
+		tx.resize(N); ty.resize(N); tz.resize(N);
+		s.resize(N);
+		return *this;
+	}
+
+	affine_rts affine_rts_soa::get(int k) const
+	{
+		affine_rts T;
+		T.rotation.data = quaternion(qx[k], qy[k], qz[k], qw[k]);
+		T.translation = { tx[k], ty[k], tz[k] };
+		T.scaling = s[k];
+		return T;
+	}
+
+	void affine_rts_soa::set(int k, affine_rts const& T)
+	{
+		quaternion const& q = T.rotation.data;
+		qx[k] = q.x; qy[k] = q.y; qz[k] = q.z; qw[k] = q.w;
+		tx[k] = T.translation.x; ty[k] = T.translation.y; tz[k] = T.translation.z;
+		s[k] = T.scaling;
+	}
+
+	numarray<affine_rts> to_numarray(affine_rts_soa const& T)
+	{
+		int const N = T.size();
+		numarray<affine_rts> res; res.resize(N);
+		for (int k = 0; k < N; ++k)
+			res.at(k) = T.get(k);
+		return res;
+	}
+
+	std::string type_str(affine_rts_soa const&)
+	{
+		return "affine_rts_soa";
+	}
+
+
+	// Pointers on the components of a set of transforms
+	struct affine_rts_soa_pointer
+	{
+		float* c[8]; // qx, qy, qz, qw, tx, ty, tz, s
+	};
+	static affine_rts_soa_pointer soa_pointer(affine_rts_soa const& T)
+	{
+		affine_rts_soa& t = const_cast<affine_rts_soa&>(T);
+		return { { t.qx.data.data(), t.qy.data.data(), t.qz.data.data(), t.qw.data.data(), t.tx.data.data(), t.ty.data.data(), t.tz.data.data(), t.s.data.data() } };
+	}
+
+	// Composition of the transforms at index k (F::size consecutive transforms)
+	//  The operations follow the same order as the scalar operators (rotation_transform product, and rotation of a vector as q p q^*).
+	template <typename F>
+	static void compose_kernel(affine_rts_soa_pointer const& T, affine_rts_soa_pointer const& T1, affine_rts_soa_pointer const& T2, int k)
+	{
+		F const x1 = F::load(T1.c[0] + k), y1 = F::load(T1.c[1] + k), z1 = F::load(T1.c[2] + k), w1 = F::load(T1.c[3] + k);
+		F const x2 = F::load(T2.c[0] + k), y2 = F::load(T2.c[1] + k), z2 = F::load(T2.c[2] + k), w2 = F::load(T2.c[3] + k);
+
+		// Rotation: q = q1 q2
+		(x1 * w2 + w1 * x2 + y1 * z2 - z1 * y2).store(T.c[0] + k);
+		(y1 * w2 + w1 * y2 + z1 * x2 - x1 * z2).store(T.c[1] + k);
+		(z1 * w2 + w1 * z2 + x1 * y2 - y1 * x2).store(T.c[2] + k);
+		(w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2).store(T.c[3] + k);
+
+		// Rotation of the translation t2: a = q1 (t2,0), then r = a q1^*
+		F const px = F::load(T2.c[4] + k), py = F::load(T2.c[5] + k), pz = F::load(T2.c[6] + k);
+		F const ax = w1 * px + y1 * pz - z1 * py;
+		F const ay = w1 * py + z1 * px - x1 * pz;
+		F const az = w1 * pz + x1 * py - y1 * px;
+		F const aw = F::broadcast(0.0f) - x1 * px - y1 * py - z1 * pz;
+
+		F const rx = ax * w1 - aw * x1 - ay * z1 + az * y1;
+		F const ry = ay * w1 - aw * y1 - az * x1 + ax * z1;
+		F const rz = az * w1 - aw * z1 - ax * y1 + ay * x1;
+
+		// Translation: t = s1 R1 t2 + t1, and scaling: s = s1 s2
+		F const s1 = F::load(T1.c[7] + k);
+		(s1 * rx + F::load(T1.c[4] + k)).store(T.c[4] + k);
+		(s1 * ry + F::load(T1.c[5] + k)).store(T.c[5] + k);
+		(s1 * rz + F::load(T1.c[6] + k)).store(T.c[6] + k);
+		(s1 * F::load(T2.c[7] + k)).store(T.c[7] + k);
+	}
+
+	void compose(affine_rts_soa& T, affine_rts_soa const& T1, affine_rts_soa const& T2)
+	{
+		assert_cgp(T1.size() == T2.size(), "Incompatible size in compose: " + str(T1.size()) + " and " + str(T2.size()));
+		int const N = T1.size();
+		T.resize(N);
+
+		affine_rts_soa_pointer const p = soa_pointer(T), p1 = soa_pointer(T1), p2 = soa_pointer(T2);
+		int k = 0;
+		for (; k + simd_float::size <= N; k += simd_float::size)
+			compose_kernel<simd_float>(p, p1, p2, k);
+		for (; k < N; ++k)
+			compose_kernel<simd_float_scalar>(p, p1, p2, k);
+	}
+
+	// Conversion between a block of n consecutive affine_rts (8 contiguous floats each) and the SoA buffer
+	static_assert(sizeof(affine_rts) == 8 * sizeof(float), "affine_rts is expected to be stored as 8 contiguous floats");
+	static void block_to_soa(affine_rts const* T, int n, affine_rts_soa_pointer const& b)
+	{
+		float const* data = reinterpret_cast<float const*>(T);
+		for (int k = 0; k < n; ++k)
+			for (int c = 0; c < 8; ++c)
+				b.c[c][k] = data[8 * k + c];
+	}
+	static void soa_to_block(affine_rts_soa_pointer const& b, int n, affine_rts* T)
+	{
+		float* data = reinterpret_cast<float*>(T);
+		for (int k = 0; k < n; ++k)
+			for (int c = 0; c < 8; ++c)
+				data[8 * k + c] = b.c[c][k];
+	}
+
+	void compose(numarray<affine_rts>& T, numarray<affine_rts> const& T1, numarray<affine_rts> const& T2)
+	{
+		assert_cgp(T1.size() == T2.size(), "Incompatible size in compose: " + str(T1.size()) + " and " + str(T2.size()));
+		int const N = T1.size();
+		T.resize(N);
+
+		// Process blocks of transforms converted to SoA in a small buffer
+		int const block_size = 64;
+		affine_rts_soa b, b1, b2;
+		b.resize(block_size); b1.resize(block_size); b2.resize(block_size);
+		affine_rts_soa_pointer const p = soa_pointer(b), p1 = soa_pointer(b1), p2 = soa_pointer(b2);
+		for (int k0 = 0; k0 < N; k0 += block_size)
+		{
+			int const n = std::min(block_size, N - k0);
+			block_to_soa(&T1.at(k0), n, p1);
+			block_to_soa(&T2.at(k0), n, p2);
+
+			int k = 0;
+			for (; k + simd_float::size <= n; k += simd_float::size)
+				compose_kernel<simd_float>(p, p1, p2, k);
+			for (; k < n; ++k)
+				compose_kernel<simd_float_scalar>(p, p1, p2, k);
+
+			soa_to_block(p, n, &T.at(k0));
+		}
+	}
+
+
+	// Coefficients of the matrix s R (row major) from the quaternion - same expression as rotation_transform::convert_quaternion_to_matrix
+	template <typename F>
+	static void rotation_matrix(F const& x, F const& y, F const& z, F const& w, F R[9])
+	{
+		F const one = F::broadcast(1.0f), two = F::broadcast(2.0f);
+		R[0] = one - two * (y * y + z * z); R[1] = two * (x * y - w * z); R[2] = two * (x * z + w * y);
+		R[3] = two * (x * y + w * z); R[4] = one - two * (x * x + z * z); R[5] = two * (y * z - w * x);
+		R[6] = two * (x * z - w * y); R[7] = two * (y * z + w * x); R[8] = one - two * (x * x + y * y);
+	}
+
+	// p_out = s (R p) + t for F::size points stored in SoA (px,py,pz)
+	template <typename F>
+	static void transform_kernel(F const R[9], F const& s, F const& tx, F const& ty, F const& tz, F const& px, F const& py, F const& pz, float* out_x, float* out_y, float* out_z)
+	{
+		(s * (R[0] * px + R[1] * py + R[2] * pz) + tx).store(out_x);
+		(s * (R[3] * px + R[4] * py + R[5] * pz) + ty).store(out_y);
+		(s * (R[6] * px + R[7] * py + R[8] * pz) + tz).store(out_z);
+	}
+
+	// Process the points by blocks converted to SoA in a small buffer: function(k0, n, x, y, z, out_x, out_y, out_z)
+	template <typename FUNCTION>
+	static void transform_points_by_block(numarray<vec3>& p_out, numarray<vec3> const& p, FUNCTION const& function)
+	{
+		int const N = p.size();
+		p_out.resize(N);
+
+		int const block_size = 64;
+		float x[block_size], y[block_size], z[block_size];
+		float out_x[block_size], out_y[block_size], out_z[block_size];
+		for (int k0 = 0; k0 < N; k0 += block_size)
+		{
+			int const n = std::min(block_size, N - k0);
+			for (int k = 0; k < n; ++k) {
+				vec3 const& v = p.at(k0 + k);
+				x[k] = v.x; y[k] = v.y; z[k] = v.z;
+			}
+			function(k0, n, x, y, z, out_x, out_y, out_z);
+			for (int k = 0; k < n; ++k)
+				p_out.at(k0 + k) = { out_x[k], out_y[k], out_z[k] };
+		}
+	}
+
+	void transform_points(numarray<vec3>& p_out, affine_rts const& T, numarray<vec3> const& p)
+	{
+		quaternion const& q = T.rotation.data;
+
+		simd_float R[9];
+		rotation_matrix(simd_float::broadcast(q.x), simd_float::broadcast(q.y), simd_float::broadcast(q.z), simd_float::broadcast(q.w), R);
+		simd_float_scalar R1[9];
+		rotation_matrix(simd_float_scalar::broadcast(q.x), simd_float_scalar::broadcast(q.y), simd_float_scalar::broadcast(q.z), simd_float_scalar::broadcast(q.w), R1);
+
+		transform_points_by_block(p_out, p, [&](int, int n, float const* x, float const* y, float const* z, float* out_x, float* out_y, float* out_z)
+		{
+			using F = simd_float;
+			using F1 = simd_float_scalar;
+			int k = 0;
+			for (; k + F::size <= n; k += F::size)
+				transform_kernel(R, F::broadcast(T.scaling), F::broadcast(T.translation.x), F::broadcast(T.translation.y), F::broadcast(T.translation.z),
+					F::load(x + k), F::load(y + k), F::load(z + k), out_x + k, out_y + k, out_z + k);
+			for (; k < n; ++k)
+				transform_kernel(R1, F1::broadcast(T.scaling), F1::broadcast(T.translation.x), F1::broadcast(T.translation.y), F1::broadcast(T.translation.z),
+					F1::load(x + k), F1::load(y + k), F1::load(z + k), out_x + k, out_y + k, out_z + k);
+		});
+	}
+
+	template <typename F>
+	static void transform_kernel_soa(affine_rts_soa_pointer const& T, int k, float const* x, float const* y, float const* z, float* out_x, float* out_y, float* out_z)
+	{
+		F R[9];
+		rotation_matrix(F::load(T.c[0] + k), F::load(T.c[1] + k), F::load(T.c[2] + k), F::load(T.c[3] + k), R);
+		transform_kernel(R, F::load(T.c[7] + k), F::load(T.c[4] + k), F::load(T.c[5] + k), F::load(T.c[6] + k), F::load(x), F::load(y), F::load(z), out_x, out_y, out_z);
+	}
+
+	void transform_points(numarray<vec3>& p_out, affine_rts_soa const& T, numarray<vec3> const& p)
+	{
+		assert_cgp(T.size() == p.size(), "Incompatible size in transform_points: " + str(T.size()) + " transforms and " + str(p.size()) + " points");
+
+		affine_rts_soa_pointer const pT = soa_pointer(T);
+		transform_points_by_block(p_out, p, [&](int k0, int n, float const* x, float const* y, float const* z, float* out_x, float* out_y, float* out_z)
+		{
+			int k = 0;
+			for (; k + simd_float::size <= n; k += simd_float::size)
+				transform_kernel_soa<simd_float>(pT, k0 + k, x + k, y + k, z + k, out_x + k, out_y + k, out_z + k);
+			for (; k < n; ++k)
+				transform_kernel_soa<simd_float_scalar>(pT, k0 + k, x + k, y + k, z + k, out_x + k, out_y + k, out_z + k);
+		});
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "cgp/geometry/transform/affine/affine_rts/affine_rts.hpp"
+#include "cgp/core/array/numarray/numarray.hpp"
+
+namespace cgp
+{
+	/** Set of affine_rts stored as a Structure of Arrays (SoA)
+	* Each component (quaternion, translation, scaling) is stored in its own contiguous array.
+	* This layout is used by the batched kernels below to process several transforms per SIMD instruction (see simd_float). */
+	struct affine_rts_soa
+	{
+		// Rotation as a unit quaternion (x,y,z,w)
+		numarray<float> qx, qy, qz, qw;
+		// Translation
+		numarray<float> tx, ty, tz;
+		// Scaling
+		numarray<float> s;
+
+		affine_rts_soa();
+		affine_rts_soa(numarray<affine_rts> const& T);
+
+		int size() const;
+		affine_rts_soa& resize(int N);
+
+		affine_rts get(int k) const;
+		void set(int k, affine_rts const& T);
+	};
+
+	numarray<affine_rts> to_numarray(affine_rts_soa const& T);
+
+
+	// Batched composition: T[k] = T1[k] * T2[k]
+	//  Same computation as operator*(affine_rts, affine_rts) applied to each pair.
+	void compose(affine_rts_soa& T, affine_rts_soa const& T1, affine_rts_soa const& T2);
+	void compose(numarray<affine_rts>& T, numarray<affine_rts> const& T1, numarray<affine_rts> const& T2);
+
+	// Batched transformation of points by a single transform: p_out[k] = T * p[k]
+	void transform_points(numarray<vec3>& p_out, affine_rts const& T, numarray<vec3> const& p);
+	// Batched transformation of points by one transform per point: p_out[k] = T[k] * p[k]
+	void transform_points(numarray<vec3>& p_out, affine_rts_soa const& T, numarray<vec3> const& p);
+
+	std::string type_str(affine_rts_soa const&);
+}
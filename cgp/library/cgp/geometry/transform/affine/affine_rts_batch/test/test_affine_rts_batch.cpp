@@ -0,0 +1,69 @@
+#include "test_affine_rts_batch.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../affine_rts_batch.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static affine_rts rand_affine_rts()
+	{
+		vec3 const axis = normalize(vec3{ rand_interval(-1,1), rand_interval(-1,1), rand_interval(0.1f,1) });
+		vec3 const translation = { rand_interval(-2,2), rand_interval(-2,2), rand_interval(-2,2) };
+		return affine_rts(rotation_transform::from_axis_angle(axis, rand_interval(-3,3)), translation, rand_interval(0.5f, 2.0f));
+	}
+
+	static bool is_equal_transform(affine_rts const& a, affine_rts const& b)
+	{
+		return is_equal(vec4(a.rotation.data), vec4(b.rotation.data)) && is_equal(a.translation, b.translation) && is_equal(a.scaling, b.scaling);
+	}
+
+	void test_affine_rts_batch()
+	{
+		// Size that is not a multiple of the SIMD width, and larger than the internal block size
+		int const N = 131;
+		numarray<affine_rts> T1, T2;
+		numarray<vec3> p;
+		for (int k = 0; k < N; ++k) {
+			T1.push_back(rand_affine_rts());
+			T2.push_back(rand_affine_rts());
+			p.push_back({ rand_interval(-3,3), rand_interval(-3,3), rand_interval(-3,3) });
+		}
+
+		{
+			affine_rts_soa const soa(T1);
+			assert_cgp_no_msg(soa.size() == N);
+			numarray<affine_rts> const back = to_numarray(soa);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal_transform(back[k], T1[k]));
+		}
+
+		// Batched composition compared to the scalar operator
+		{
+			affine_rts_soa T;
+			compose(T, affine_rts_soa(T1), affine_rts_soa(T2));
+			numarray<affine_rts> T_aos;
+			compose(T_aos, T1, T2);
+			assert_cgp_no_msg(T.size() == N && T_aos.size() == N);
+			for (int k = 0; k < N; ++k) {
+				affine_rts const expected = T1[k] * T2[k];
+				assert_cgp_no_msg(is_equal_transform(T.get(k), expected));
+				assert_cgp_no_msg(is_equal_transform(T_aos[k], expected));
+			}
+		}
+
+		// Batched transformation of points compared to the scalar operator
+		{
+			numarray<vec3> q;
+			transform_points(q, T1[0], p);
+			assert_cgp_no_msg(q.size() == N);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q[k], T1[0] * p[k]));
+
+			transform_points(q, affine_rts_soa(T1), p);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q[k], T1[k] * p[k]));
+		}
+	}
+}
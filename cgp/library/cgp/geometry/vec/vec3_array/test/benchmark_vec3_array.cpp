@@ -0,0 +1,94 @@
+#include "benchmark_vec3_array.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../vec3_array.hpp"
+#include "cgp/geometry/shape/mesh/normal/normal.hpp"
+#include "cgp/geometry/shape/mesh/primitive/mesh_primitive.hpp"
+
+#include <chrono>
+#include <string>
+
+namespace cgp_test
+{
+	using namespace cgp;
+
+	// Average time in ms of f() over N_repeat calls
+	template <typename F>
+	static double time_ms(F const& f, int N_repeat)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_repeat; ++k)
+			f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / N_repeat;
+	}
+
+	static void display(std::string const& name, double aos, double soa)
+	{
+		std::cout << name << ": AoS " << aos << " ms, SoA " << soa << " ms (x" << aos / soa << ")" << std::endl;
+	}
+
+	void benchmark_vec3_array()
+	{
+		int const N = 1000000;
+		int const N_repeat = 20;
+		numarray<vec3> a_aos(N), b_aos(N);
+		for (int k = 0; k < N; ++k) {
+			a_aos[k] = { rand_interval(-3,3), rand_interval(-3,3), rand_interval(-3,3) };
+			b_aos[k] = { rand_interval(-3,3), rand_interval(-3,3), rand_interval(-3,3) };
+		}
+		vec3_array a(a_aos), b(b_aos);
+		std::cout << "vec3_array - " << N << " elements" << std::endl;
+
+		{
+			numarray<float> n_aos(N), n;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) n_aos.at(k) = norm(a_aos.at(k)); }, N_repeat);
+			double const t_soa = time_ms([&]() { norm(n, a); }, N_repeat);
+			display("norm", t_aos, t_soa);
+		}
+		{
+			numarray<float> d_aos(N), d;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) d_aos.at(k) = dot(a_aos.at(k), b_aos.at(k)); }, N_repeat);
+			double const t_soa = time_ms([&]() { dot(d, a, b); }, N_repeat);
+			display("dot", t_aos, t_soa);
+		}
+		{
+			numarray<vec3> c_aos(N);
+			vec3_array c;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) c_aos.at(k) = cross(a_aos.at(k), b_aos.at(k)); }, N_repeat);
+			double const t_soa = time_ms([&]() { cross(c, a, b); }, N_repeat);
+			display("cross", t_aos, t_soa);
+		}
+		{
+			numarray<vec3> u_aos(N);
+			vec3_array u;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) u_aos.at(k) = normalize(a_aos.at(k)); }, N_repeat);
+			double const t_soa = time_ms([&]() { normalize(u, a); }, N_repeat);
+			display("normalize", t_aos, t_soa);
+		}
+		{
+			float const dt = 1e-3f;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) a_aos.at(k) += dt * b_aos.at(k); }, N_repeat);
+			double const t_soa = time_ms([&]() { add_scaled(a, dt, b); }, N_repeat);
+			display("add_scaled (particles)", t_aos, t_soa);
+		}
+		{
+			affine_rts const T(rotation_transform::from_axis_angle(normalize(vec3{ 1,2,3 }), 0.7f), vec3{ 1,-2,0.5f }, 1.5f);
+			numarray<vec3> q_aos(N);
+			vec3_array q;
+			double const t_aos = time_ms([&]() { for (int k = 0; k < N; ++k) q_aos.at(k) = T * a_aos.at(k); }, N_repeat);
+			double const t_soa = time_ms([&]() { transform_points(q, T, a); }, N_repeat);
+			display("transform_points (affine_rts)", t_aos, t_soa);
+		}
+		{
+			mesh const m = mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 500, 500);
+			normal_per_vertex_structure structure;
+			structure.initialize(m.connectivity, m.position.size());
+			vec3_array const p(m.position);
+			numarray<vec3> n_aos;
+			vec3_array n;
+			double const t_aos = time_ms([&]() { normal_per_vertex(m.position, m.connectivity, structure, n_aos); }, N_repeat);
+			double const t_soa = time_ms([&]() { normal_per_vertex(p, m.connectivity, structure, n); }, N_repeat);
+			display("normal_per_vertex (" + str(m.position.size()) + " vertices)", t_aos, t_soa);
+		}
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Compare the batch operations on vec3_array (SoA) with the equivalent loops on numarray<vec3> (AoS)
+	void benchmark_vec3_array();
+}
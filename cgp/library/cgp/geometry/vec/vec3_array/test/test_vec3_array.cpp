@@ -0,0 +1,91 @@
+#include "test_vec3_array.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../vec3_array.hpp"
+#include "cgp/geometry/shape/mesh/normal/normal.hpp"
+#include "cgp/geometry/shape/mesh/primitive/mesh_primitive.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static vec3 rand_vec3()
+	{
+		return { rand_interval(-3,3), rand_interval(-3,3), rand_interval(-3,3) };
+	}
+
+	void test_vec3_array()
+	{
+		// Size that is not a multiple of the SIMD width
+		int const N = 131;
+		numarray<vec3> a_aos, b_aos;
+		for (int k = 0; k < N; ++k) {
+			a_aos.push_back(rand_vec3());
+			b_aos.push_back(rand_vec3());
+		}
+		a_aos[5] = { 0,0,0 }; // zero norm
+
+		vec3_array const a(a_aos), b(b_aos);
+		assert_cgp_no_msg(a.size() == N);
+		assert_cgp_no_msg(is_equal(to_numarray(a), a_aos));
+
+		{
+			numarray<float> n, d;
+			norm(n, a);
+			dot(d, a, b);
+			assert_cgp_no_msg(n.size() == N && d.size() == N);
+			for (int k = 0; k < N; ++k) {
+				assert_cgp_no_msg(is_equal(n[k], norm(a_aos[k])));
+				assert_cgp_no_msg(is_equal(d[k], dot(a_aos[k], b_aos[k])));
+			}
+		}
+
+		{
+			vec3_array c, u;
+			cross(c, a, b);
+			normalize(u, a, vec3{ 1,0,0 });
+			for (int k = 0; k < N; ++k) {
+				assert_cgp_no_msg(is_equal(c.get(k), cross(a_aos[k], b_aos[k])));
+				assert_cgp_no_msg(is_equal(u.get(k), normalize(a_aos[k], vec3{ 1,0,0 })));
+			}
+			assert_cgp_no_msg(is_equal(u.get(5), vec3{ 1,0,0 }));
+
+			// Output aliased with the input
+			vec3_array p = a;
+			add_scaled(p, 0.5f, b);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(p.get(k), a_aos[k] + 0.5f * b_aos[k]));
+		}
+
+		// Transforms compared to the scalar operators
+		{
+			affine_rts const T(rotation_transform::from_axis_angle(normalize(vec3{ 1,2,3 }), 0.7f), vec3{ 1,-2,0.5f }, 1.5f);
+			affine const A(T.rotation, vec3{ 0,1,2 }, 0.8f, vec3{ 1,2,3 });
+			vec3_array q;
+			transform_points(q, T, a);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q.get(k), T * a_aos[k]));
+			transform_points(q, A, a);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q.get(k), A * a_aos[k]));
+			transform_points(q, T.matrix(), a);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q.get(k), T * a_aos[k]));
+			transform_vectors(q, T.rotation, a);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal(q.get(k), T.rotation * a_aos[k]));
+		}
+
+		// Normals computed on the SoA positions are the same as on the AoS ones
+		{
+			mesh const m = mesh_primitive_torus(1.0f, 0.3f, { 0,0,0 }, { 0,0,1 }, 13, 11);
+			normal_per_vertex_structure structure;
+			structure.initialize(m.connectivity, m.position.size());
+			numarray<vec3> n_aos;
+			normal_per_vertex(m.position, m.connectivity, structure, n_aos);
+			vec3_array n;
+			normal_per_vertex(vec3_array(m.position), m.connectivity, structure, n);
+			assert_cgp_no_msg(is_equal(to_numarray(n), n_aos));
+		}
+	}
+}
@@ -0,0 +1,239 @@
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/simd/simd.hpp"
+#include "vec3_array.hpp"
+
+namespace cgp
+{
+	vec3_array::vec3_array()
+		:x(), y(), z()
+	{}
+
+	vec3_array::vec3_array(int N)
+		:x(N), y(N), z(N)
+	{}
+
+	vec3_array::vec3_array(numarray<vec3> const& v)
+	{
+		int const N = v.size();
+		resize(N);
+		for (int k = 0; k < N; ++k)
+			set(k, v.at(k));
+	}
+
+	int vec3_array::size() const
+	{
+		return x.size();
+	}
+
+	vec3_array& vec3_array::resize(int N)
+	{
+		x.resize(N); y.resize(N); z.resize(N);
+		return *this;
+	}
+
+	vec3_array& vec3_array::clear()
+	{
+		x.clear(); y.clear(); z.clear();
+		return *this;
+	}
+
+	vec3 vec3_array::get(int k) const
+	{
+		return { x.at(k), y.at(k), z.at(k) };
+	}
+
+	void vec3_array::set(int k, vec3 const& v)
+	{
+		x.at(k) = v.x; y.at(k) = v.y; z.at(k) = v.z;
+	}
+
+	numarray<vec3> to_numarray(vec3_array const& v)
+	{
+		numarray<vec3> res;
+		to_numarray(res, v);
+		return res;
+	}
+
+	void to_numarray(numarray<vec3>& out, vec3_array const& v)
+	{
+		int const N = v.size();
+		out.resize(N);
+		for (int k = 0; k < N; ++k)
+			out.at(k) = v.get(k);
+	}
+
+	std::string type_str(vec3_array const&)
+	{
+		return "vec3_array";
+	}
+
+
+	// Pointers on the coordinates of a vec3_array
+	struct vec3_array_pointer
+	{
+		float* x;
+		float* y;
+		float* z;
+	};
+	static vec3_array_pointer soa_pointer(vec3_array const& v)
+	{
+		vec3_array& w = const_cast<vec3_array&>(v);
+		return { w.x.data.data(), w.y.data.data(), w.z.data.data() };
+	}
+
+	// Call kernel<F>(k) on blocks of simd_float::size elements, then on the remaining elements one by one
+	template <typename KERNEL>
+	static void batch(int N, KERNEL const& kernel)
+	{
+		int k = 0;
+		for (; k + simd_float::size <= N; k += simd_float::size)
+			kernel(simd_float(), k);
+		for (; k < N; ++k)
+			kernel(simd_float_scalar(), k);
+	}
+
+	static void assert_same_size(vec3_array const& a, vec3_array const& b, std::string const& function)
+	{
+		assert_cgp(a.size() == b.size(), "Incompatible size in " + function + ": " + str(a.size()) + " and " + str(b.size()));
+	}
+
+
+	void norm(numarray<float>& out, vec3_array const& v)
+	{
+		int const N = v.size();
+		out.resize(N);
+		vec3_array_pointer const p = soa_pointer(v);
+		float* n = out.data.data();
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			F const x = F::load(p.x + k), y = F::load(p.y + k), z = F::load(p.z + k);
+			sqrt(x * x + y * y + z * z).store(n + k);
+		});
+	}
+
+	void dot(numarray<float>& out, vec3_array const& a, vec3_array const& b)
+	{
+		assert_same_size(a, b, "dot");
+		int const N = a.size();
+		out.resize(N);
+		vec3_array_pointer const pa = soa_pointer(a), pb = soa_pointer(b);
+		float* d = out.data.data();
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			(F::load(pa.x + k) * F::load(pb.x + k) + F::load(pa.y + k) * F::load(pb.y + k) + F::load(pa.z + k) * F::load(pb.z + k)).store(d + k);
+		});
+	}
+
+	void cross(vec3_array& out, vec3_array const& a, vec3_array const& b)
+	{
+		assert_same_size(a, b, "cross");
+		int const N = a.size();
+		out.resize(N);
+		vec3_array_pointer const p = soa_pointer(out), pa = soa_pointer(a), pb = soa_pointer(b);
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			F const ax = F::load(pa.x + k), ay = F::load(pa.y + k), az = F::load(pa.z + k);
+			F const bx = F::load(pb.x + k), by = F::load(pb.y + k), bz = F::load(pb.z + k);
+			(ay * bz - az * by).store(p.x + k);
+			(az * bx - ax * bz).store(p.y + k);
+			(ax * by - ay * bx).store(p.z + k);
+		});
+	}
+
+	void normalize(vec3_array& out, vec3_array const& v, vec3 const& default_zero_norm)
+	{
+		int const N = v.size();
+		out.resize(N);
+		vec3_array_pointer const p = soa_pointer(out), pv = soa_pointer(v);
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			int const W = F::size;
+			F const x = F::load(pv.x + k), y = F::load(pv.y + k), z = F::load(pv.z + k);
+			float n[W];
+			sqrt(x * x + y * y + z * z).store(n);
+			(x / F::load(n)).store(p.x + k);
+			(y / F::load(n)).store(p.y + k);
+			(z / F::load(n)).store(p.z + k);
+			for (int i = 0; i < W; ++i) {
+				if (n[i] < 1e-5f) {
+					p.x[k + i] = default_zero_norm.x; p.y[k + i] = default_zero_norm.y; p.z[k + i] = default_zero_norm.z;
+				}
+			}
+		});
+	}
+
+	void add_scaled(vec3_array& a, float s, vec3_array const& b)
+	{
+		assert_same_size(a, b, "add_scaled");
+		int const N = a.size();
+		vec3_array_pointer const pa = soa_pointer(a), pb = soa_pointer(b);
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			F const S = F::broadcast(s);
+			(F::load(pa.x + k) + S * F::load(pb.x + k)).store(pa.x + k);
+			(F::load(pa.y + k) + S * F::load(pb.y + k)).store(pa.y + k);
+			(F::load(pa.z + k) + S * F::load(pb.z + k)).store(pa.z + k);
+		});
+	}
+
+
+	// out_i = s_i (M_i0 x + M_i1 y + M_i2 z) + t_i for each row i
+	//  The scaling and the translation are applied as in the operators affine_rts * vec3 and affine * vec3.
+	static void transform_batch(vec3_array& out, float const M[9], vec3 const& s, vec3 const& t, vec3_array const& v)
+	{
+		int const N = v.size();
+		out.resize(N);
+		vec3_array_pointer const p = soa_pointer(out), pv = soa_pointer(v);
+		batch(N, [&](auto f, int k) {
+			using F = decltype(f);
+			F const x = F::load(pv.x + k), y = F::load(pv.y + k), z = F::load(pv.z + k);
+			F const rx = F::broadcast(M[0]) * x + F::broadcast(M[1]) * y + F::broadcast(M[2]) * z;
+			F const ry = F::broadcast(M[3]) * x + F::broadcast(M[4]) * y + F::broadcast(M[5]) * z;
+			F const rz = F::broadcast(M[6]) * x + F::broadcast(M[7]) * y + F::broadcast(M[8]) * z;
+			(F::broadcast(s.x) * rx + F::broadcast(t.x)).store(p.x + k);
+			(F::broadcast(s.y) * ry + F::broadcast(t.y)).store(p.y + k);
+			(F::broadcast(s.z) * rz + F::broadcast(t.z)).store(p.z + k);
+		});
+	}
+
+	template <typename MAT>
+	static void linear_part(MAT const& M, float L[9])
+	{
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+				L[3 * i + j] = M.at(i, j);
+	}
+
+	void transform_points(vec3_array& out, mat4 const& M, vec3_array const& p)
+	{
+		float L[9];
+		linear_part(M, L);
+		transform_batch(out, L, { 1,1,1 }, { M.at(0,3), M.at(1,3), M.at(2,3) }, p);
+	}
+
+	void transform_points(vec3_array& out, affine_rts const& T, vec3_array const& p)
+	{
+		float R[9];
+		linear_part(T.rotation.matrix(), R);
+		transform_batch(out, R, { T.scaling, T.scaling, T.scaling }, T.translation, p);
+	}
+
+	void transform_points(vec3_array& out, affine const& T, vec3_array const& p)
+	{
+		float R[9];
+		linear_part(T.rotation.matrix(), R);
+		transform_batch(out, R, T.scaling_xyz * T.scaling, T.translation, p);
+	}
+
+	void transform_vectors(vec3_array& out, mat3 const& M, vec3_array const& v)
+	{
+		float L[9];
+		linear_part(M, L);
+		transform_batch(out, L, { 1,1,1 }, { 0,0,0 }, v);
+	}
+
+	void transform_vectors(vec3_array& out, rotation_transform const& R, vec3_array const& v)
+	{
+		transform_vectors(out, R.matrix(), v);
+	}
+}
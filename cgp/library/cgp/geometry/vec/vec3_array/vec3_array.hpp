@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cgp/core/array/numarray/numarray.hpp"
+#include "cgp/geometry/vec/vec3/vec3.hpp"
+#include "cgp/geometry/mat/mat.hpp"
+#include "cgp/geometry/transform/transform.hpp"
+
+namespace cgp
+{
+	/** Set of vec3 stored as a Structure of Arrays (SoA)
+	* Each coordinate is stored in its own contiguous array of floats, while numarray<vec3> interleaves them (x,y,z,x,y,z,...).
+	* The batch functions below process several vectors per SIMD instruction (see simd_float) on this layout.
+	* Typical use: per-particle or per-vertex data updated at every frame, converted to numarray<vec3> only when needed (ex. upload to the GPU). */
+	struct vec3_array
+	{
+		numarray<float> x, y, z;
+
+		vec3_array();
+		explicit vec3_array(int N);
+		vec3_array(numarray<vec3> const& v);
+
+		int size() const;
+		vec3_array& resize(int N);
+		vec3_array& clear();
+
+		vec3 get(int k) const;
+		void set(int k, vec3 const& v);
+	};
+
+	numarray<vec3> to_numarray(vec3_array const& v);
+	void to_numarray(numarray<vec3>& out, vec3_array const& v);
+
+	std::string type_str(vec3_array const&);
+
+
+	/** Batch operations - The output is resized to the size of the input, and can be one of the inputs.
+	* The results are the ones of the functions on vec3 applied to each element (up to floating point rounding for the transforms). */
+
+	// out[k] = norm(v[k])
+	void norm(numarray<float>& out, vec3_array const& v);
+	// out[k] = dot(a[k], b[k])
+	void dot(numarray<float>& out, vec3_array const& a, vec3_array const& b);
+	// out[k] = cross(a[k], b[k])
+	void cross(vec3_array& out, vec3_array const& a, vec3_array const& b);
+	// out[k] = normalize(v[k], default_zero_norm) - vectors with a norm smaller than 1e-5 are replaced by default_zero_norm
+	void normalize(vec3_array& out, vec3_array const& v, vec3 const& default_zero_norm = vec3{ 0,0,1 });
+	// a[k] += s * b[k] (ex. explicit integration of particles: add_scaled(p, dt, v))
+	void add_scaled(vec3_array& a, float s, vec3_array const& b);
+
+	// Transformation of positions: out[k] = M * p[k] with homogeneous coordinate w=1 (the last row of M is ignored)
+	void transform_points(vec3_array& out, mat4 const& M, vec3_array const& p);
+	void transform_points(vec3_array& out, affine_rts const& T, vec3_array const& p);
+	void transform_points(vec3_array& out, affine const& T, vec3_array const& p);
+	// Transformation of vectors: out[k] = M * v[k]
+	void transform_vectors(vec3_array& out, mat3 const& M, vec3_array const& v);
+	void transform_vectors(vec3_array& out, rotation_transform const& R, vec3_array const& v);
+}
@@ -62,18 +62,26 @@ namespace cgp
 
 	void curve_drawable::send_opengl_uniform(bool expected) const
 	{
-		opengl_uniform(shader, "color", color, expected);
-		opengl_uniform(shader, "model", model.matrix(), expected);
+		opengl_uniform_layout const& layout = shader.uniform_layout();
+		opengl_uniform(layout.color, color, expected);
+		opengl_uniform(layout.model, model.matrix(), expected);
 	}
 
 
 	void draw(curve_drawable const& drawable, environment_generic_structure const& environment)
+	{
+		GLint const first = 0;
+		GLsizei const count = GLsizei(drawable.vbo_position.size);
+		draw(drawable, environment, &first, &count, 1);
+	}
+
+	void draw(curve_drawable const& drawable, environment_generic_structure const& environment, GLint const* first, GLsizei const* count, int N_range)
 	{
 		// Initial clean check
 		// ********************************** //
 		// If there is not vertices or not triangles, returns
 		//  (no error + does not display anything)
-		if (drawable.vbo_position.size == 0)
+		if (drawable.vbo_position.size == 0 || N_range == 0)
 			return;
 
 		// Set the current shader
@@ -93,11 +101,12 @@ namespace cgp
 		// Prepare for draw call
 		// ********************************** //
 		glBindVertexArray(drawable.vao); opengl_check;
-		if (drawable.display_type == curve_drawable_display_type::Curve) {
-			glDrawArrays(GL_LINE_STRIP, 0, drawable.vbo_position.size); opengl_check;
+		GLenum const mode = drawable.display_type == curve_drawable_display_type::Curve ? GL_LINE_STRIP : GL_LINES;
+		if (N_range == 1) {
+			glDrawArrays(mode, first[0], count[0]); opengl_check;
 		}
 		else {
-			glDrawArrays(GL_LINES, 0, drawable.vbo_position.size); opengl_check;
+			glMultiDrawArrays(mode, first, count, N_range); opengl_check;
 		}
 
 
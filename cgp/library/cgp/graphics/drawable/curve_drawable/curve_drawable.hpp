@@ -40,6 +40,8 @@ namespace cgp
 	};
 
 	void draw(curve_drawable const& drawable, environment_generic_structure const& environment);
+	// Draw only the N_range ranges of vertices [first[k], first[k]+count[k][ of the VBO (single call to glMultiDrawArrays)
+	void draw(curve_drawable const& drawable, environment_generic_structure const& environment, GLint const* first, GLsizei const* count, int N_range);
 
 }
 
@@ -2,10 +2,12 @@
 
 #include "material/material.hpp"
 #include "mesh_drawable/mesh_drawable.hpp"
+#include "mesh_drawable_instanced/mesh_drawable_instanced.hpp"
 #include "curve_drawable/curve_drawable.hpp"
 #include "special_drawable/special_drawable.hpp"
 #include "environment/environment.hpp"
 #include "hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "render_queue/render_queue.hpp"
 
 //#include "shading_parameters/shading_parameters.hpp"
 //#include "mesh_wireframe_drawable/mesh_wireframe_drawable.hpp"
@@ -15,6 +17,7 @@
 //#include "segments_drawable/segments_drawable.hpp"
 //#include "trajectory_drawable/trajectory_drawable.hpp"
 //#include "hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "render_queue/render_queue.hpp"
 //#include "spatial_domain_grid_drawable/spatial_domain_grid_drawable.hpp"
 //#include "triangle_soup_drawable/triangle_soup_drawable.hpp"
 //#include "skybox_drawable/skybox_drawable.hpp"
@@ -1,167 +1,336 @@
 #include "cgp/core/base/base.hpp"
 #include "hierarchy_mesh_drawable.hpp"
 
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
 namespace cgp
 {
 
-    static void assert_valid_hierarchy(hierarchy_mesh_drawable const& hierarchy);
+    static int find_parent_index(hierarchy_mesh_drawable const& hierarchy, hierarchy_mesh_drawable_node const& node);
+    static unsigned int name_hash_value(char const* name, size_t length);
+    static int name_lookup(hierarchy_mesh_drawable const& hierarchy, char const* name, size_t length);
+    static void name_table_insert(std::vector<int>& table, unsigned int hash, int index);
+    [[noreturn]] static void error_name_not_found(hierarchy_mesh_drawable const& hierarchy, char const* name);
+    static void update_instancing_groups(hierarchy_mesh_drawable& hierarchy);
 
-    void hierarchy_mesh_drawable::add(hierarchy_mesh_drawable_node const& node)
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::add(hierarchy_mesh_drawable_node const& node)
     {
-        name_map[node.name] = static_cast<int>(elements.size());
+        // Check that the name is unique and that the parent is already defined
+        //  (the checks are done once here, instead of at every update)
+        int const parent = find_parent_index(*this, node);
+        int const index = static_cast<int>(elements.size());
+
+        // Keep the load factor of the name table below 1/2
+        if (2 * (elements.size() + 1) > name_table.size())
+        {
+            std::vector<int> table(std::max(size_t(16), 2 * name_table.size()), -1);
+            for (int k = 0; k < index; ++k)
+                name_table_insert(table, name_hash[k], k);
+            name_table.swap(table);
+        }
+        unsigned int const hash = name_hash_value(node.name.c_str(), node.name.size());
+        name_hash.push_back(hash);
+        name_table_insert(name_table, hash, index);
+
         elements.push_back(node);
-        assert_valid_hierarchy(*this);
+
+        parent_index.push_back(parent);
+        transform_local.push_back(node.transform_local);
+        transform_global.push_back(node.transform_local);
+        dirty.push_back(1);
+        depth.push_back(parent < 0 ? 0 : depth[parent] + 1);
+        bounding_center.resize(index + 1);
+        bounding_radius.push_back(-1.0f);
+
+        return hierarchy_mesh_drawable_handle{ index };
     }
-    void hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, vec3 const& translation, rotation_transform const& rotation)
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, vec3 const& translation, rotation_transform const& rotation)
     {
         affine_rts const transform = affine_rts(rotation, translation, 1.0f);
         hierarchy_mesh_drawable_node const node = {element, name, name_parent, transform};
-        add(node);
+        return add(node);
     }
-    void hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform)
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform)
     {
         hierarchy_mesh_drawable_node const node = {element, name, name_parent, transform};
-        add(node);
+        return add(node);
     }
 
 
-    hierarchy_mesh_drawable_node& hierarchy_mesh_drawable::operator[](std::string const& name)
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::find(std::string const& name) const
     {
-        auto it = name_map.find(name);
-        if (it == name_map.end())
-        {
-            std::cerr << "Error: cannot find element [" << name << "] in hierarchy_mesh_drawable" << std::endl;
-            std::cerr << "Possibles element names are: ";
-            for (auto const& s : name_map) { std::cerr << "[" << s.first << "] "; }
-            abort();
-        }
+        return hierarchy_mesh_drawable_handle{ name_lookup(*this, name.c_str(), name.size()) };
+    }
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::find(char const* name) const
+    {
+        return hierarchy_mesh_drawable_handle{ name_lookup(*this, name, std::strlen(name)) };
+    }
+    hierarchy_mesh_drawable_handle hierarchy_mesh_drawable::handle(std::string const& name) const
+    {
+        hierarchy_mesh_drawable_handle const h = find(name);
+        if (!h.valid())
+            error_name_not_found(*this, name.c_str());
+        return h;
+    }
 
-        const size_t index = it->second;
-        assert_cgp_no_msg(index < elements.size());
+    bool hierarchy_mesh_drawable::is_valid(hierarchy_mesh_drawable_handle const& handle) const
+    {
+        return handle.valid() && handle.index < int(elements.size());
+    }
 
-        return elements[index];
+    hierarchy_mesh_drawable_node& hierarchy_mesh_drawable::operator[](hierarchy_mesh_drawable_handle const& handle)
+    {
+        assert_cgp(is_valid(handle), "Invalid handle (" + str(handle.index) + ") in hierarchy_mesh_drawable of size " + str(elements.size()));
+        return elements[handle.index];
+    }
+    hierarchy_mesh_drawable_node const& hierarchy_mesh_drawable::operator[](hierarchy_mesh_drawable_handle const& handle) const
+    {
+        assert_cgp(is_valid(handle), "Invalid handle (" + str(handle.index) + ") in hierarchy_mesh_drawable of size " + str(elements.size()));
+        return elements[handle.index];
+    }
+
+    hierarchy_mesh_drawable_node& hierarchy_mesh_drawable::operator[](std::string const& name)
+    {
+        return elements[handle(name).index];
     }
     hierarchy_mesh_drawable_node const& hierarchy_mesh_drawable::operator[](std::string const& name) const
     {
-        auto it = name_map.find(name);
-        if (it == name_map.end())
+        return elements[handle(name).index];
+    }
+    hierarchy_mesh_drawable_node& hierarchy_mesh_drawable::operator[](char const* name)
+    {
+        int const index = name_lookup(*this, name, std::strlen(name));
+        if (index < 0)
+            error_name_not_found(*this, name);
+        return elements[index];
+    }
+    hierarchy_mesh_drawable_node const& hierarchy_mesh_drawable::operator[](char const* name) const
+    {
+        int const index = name_lookup(*this, name, std::strlen(name));
+        if (index < 0)
+            error_name_not_found(*this, name);
+        return elements[index];
+    }
+
+
+    // FNV-1a hash of the name
+    static unsigned int name_hash_value(char const* name, size_t length)
+    {
+        unsigned int hash = 2166136261u;
+        for (size_t k = 0; k < length; ++k) {
+            hash ^= static_cast<unsigned char>(name[k]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    static void name_table_insert(std::vector<int>& table, unsigned int hash, int index)
+    {
+        size_t const mask = table.size() - 1;
+        size_t slot = hash & mask;
+        while (table[slot] != -1)
+            slot = (slot + 1) & mask;
+        table[slot] = index;
+    }
+
+    static int name_lookup(hierarchy_mesh_drawable const& hierarchy, char const* name, size_t length)
+    {
+        std::vector<int> const& table = hierarchy.name_table;
+        if (table.size() == 0)
+            return -1;
+
+        unsigned int const hash = name_hash_value(name, length);
+        size_t const mask = table.size() - 1;
+        for (size_t slot = hash & mask; table[slot] != -1; slot = (slot + 1) & mask)
         {
-            std::cerr << "Error: cannot find element [" << name << "] in hierarchy_mesh_drawable" << std::endl;
-            std::cerr << "Possibles element names are: ";
-            for (auto const& s : name_map) { std::cerr << "[" << s.first << "] "; }
-            abort();
+            int const index = table[slot];
+            std::string const& candidate = hierarchy.elements[index].name;
+            if (hierarchy.name_hash[index] == hash && candidate.size() == length && std::memcmp(candidate.data(), name, length) == 0)
+                return index;
         }
+        return -1;
+    }
 
-        const size_t index = it->second;
-        assert_cgp_no_msg(index < elements.size());
+    static void error_name_not_found(hierarchy_mesh_drawable const& hierarchy, char const* name)
+    {
+        std::cerr << "Error: cannot find element [" << name << "] in hierarchy_mesh_drawable" << std::endl;
+        std::cerr << "Possibles element names are: ";
+        for (auto const& e : hierarchy.elements) { std::cerr << "[" << e.name << "] "; }
+        abort();
+    }
 
-        return elements[index];
+
+    // Exact comparison of two transforms (used to detect the local transforms modified by the user)
+    static bool is_identical(affine_rts const& a, affine_rts const& b)
+    {
+        quaternion const& qa = a.rotation.data;
+        quaternion const& qb = b.rotation.data;
+        return qa.x == qb.x && qa.y == qb.y && qa.z == qb.z && qa.w == qb.w
+            && a.translation.x == b.translation.x && a.translation.y == b.translation.y && a.translation.z == b.translation.z
+            && a.scaling == b.scaling;
     }
 
+    // Recompute the global transform of the element k if needed, returns true if it has been recomputed
+    //  Requires the parent of k to be already updated. Only the data associated to the index k are modified.
+    static bool update_element(hierarchy_mesh_drawable& hierarchy, int k)
+    {
+        affine_rts const& local = hierarchy.elements[k].transform_local;
+        int const parent = hierarchy.parent_index[k];
+
+        bool const parent_changed = parent >= 0 && hierarchy.dirty[parent];
+        if (!hierarchy.dirty[k] && !parent_changed && is_identical(local, hierarchy.transform_local[k]))
+            return false;
+
+        hierarchy.transform_local[k] = local;
+        if (parent < 0) // Case of root element - local = global
+            hierarchy.transform_global[k] = local;
+        else            // Else apply hierarchical transformation
+            hierarchy.transform_global[k] = hierarchy.transform_global[parent] * local;
+
+        hierarchy.elements[k].drawable.hierarchy_transform_model = hierarchy.transform_global[k];
+        hierarchy.elements[k].changed = true;
+
+        bounding_sphere const bounds = bounding_volume_world(hierarchy.elements[k].drawable);
+        hierarchy.bounding_center.set(k, bounds.center);
+        hierarchy.bounding_radius.at(k) = bounds.radius;
+
+        hierarchy.dirty[k] = 1; // the flag is used by the children of this element during this pass
+        return true;
+    }
 
     void hierarchy_mesh_drawable::update_local_to_global_coordinates()
     {
-        if(elements.size()==0)
-            return ;
+        int const N = static_cast<int>(elements.size());
+        assert_cgp(parent_index.size()==elements.size(), "Elements of hierarchy_mesh_drawable must be inserted using add()");
+
+        // Reset the status of the elements changed during the previous update
+        for (int const k : changed_elements)
+            elements[k].changed = false;
+        changed_elements.clear();
+
+        // Propagate along the hierarchy: parents are always processed before their children
+        //  An element is recomputed if its local transform changed, or if its parent has been recomputed
+        for (int k = 0; k < N; ++k)
+            if (update_element(*this, k))
+                changed_elements.push_back(k);
 
-        assert_valid_hierarchy(*this);
+        // Clear the dirty flags for the next update
+        for (int const k : changed_elements)
+            dirty[k] = 0;
 
-        std::string const& name_root_parent = elements[0].name_parent;
+        if (instancing)
+            update_instancing_groups(*this);
+    }
 
+    void hierarchy_mesh_drawable::update_local_to_global_coordinates_parallel()
+    {
         int const N = static_cast<int>(elements.size());
-        for(int k=0; k<N; ++k)
+        assert_cgp(parent_index.size()==elements.size(), "Elements of hierarchy_mesh_drawable must be inserted using add()");
+
+        // (Re)build the ordering of the elements per depth level if new elements have been added
+        if (int(level_order.size()) != N)
         {
-            hierarchy_mesh_drawable_node& element = elements[k];
+            int const N_level = N == 0 ? 0 : 1 + *std::max_element(depth.begin(), depth.end());
+            level_offset.assign(N_level + 1, 0);
+            for (int k = 0; k < N; ++k)
+                level_offset[depth[k] + 1]++;
+            for (int level = 0; level < N_level; ++level)
+                level_offset[level + 1] += level_offset[level];
+
+            // Counting sort: elements of the same level remain sorted by increasing index
+            level_order.resize(N);
+            std::vector<int> position(level_offset.begin(), level_offset.end() - 1);
+            for (int k = 0; k < N; ++k)
+                level_order[position[depth[k]]++] = k;
+        }
 
-            std::string const& parent_name = element.name_parent;
+        for (int const k : changed_elements)
+            elements[k].changed = false;
+        changed_elements.clear();
 
-            // Case of root element (or same parent) - local = global
-            if( parent_name == name_root_parent ) {
-                element.drawable.hierarchy_transform_model = element.transform_local;
-            }
-            // Else apply hierarchical transformation
-            else
-            {
-                int const parent_id = name_map[parent_name];
-                affine_rts const& local = element.transform_local;
-                affine_rts const& global_parent = elements[parent_id].drawable.hierarchy_transform_model;
-
-                element.drawable.hierarchy_transform_model = global_parent * local;
+        // The elements of one level only depend on the previous levels: each level is processed in parallel
+        //  The computation of each element is the same as in the serial update, so the result is identical.
+        int const N_level = int(level_offset.size()) - 1;
+        for (int level = 0; level < N_level; ++level)
+        {
+            int const offset = level_offset[level];
+            parallel_for(level_offset[level + 1] - offset, [this, offset](int k_begin, int k_end) {
+                for (int k = k_begin; k < k_end; ++k)
+                    update_element(*this, level_order[offset + k]);
+            }, parallel_grain_size);
+        }
+
+        // Gather the changed elements in increasing order (same list as the serial update)
+        for (int k = 0; k < N; ++k) {
+            if (dirty[k]) {
+                changed_elements.push_back(k);
+                dirty[k] = 0;
             }
         }
+
+        if (instancing)
+            update_instancing_groups(*this);
     }
 
 
-    void assert_valid_hierarchy(hierarchy_mesh_drawable const& hierarchy)
+    void hierarchy_mesh_drawable::update_visibility(mat4 const& projection_view)
     {
-        if(hierarchy.elements.size()==0)
-            return ;
+        int const N = static_cast<int>(elements.size());
+        assert_cgp(bounding_radius.size()==elements.size(), "Elements of hierarchy_mesh_drawable must be inserted using add()");
 
-        {
-            // Check that elements and name_map have the same size
-            const size_t N1 = hierarchy.elements.size();
-            const size_t N2 = hierarchy.name_map.size();
-            if(N1!=N2) {
-                std::cerr<<"Error: Hierarchy not valid - Number of element ("<<N1<<") != Name_map.size() ("<<N2<<")"<<std::endl;
-                abort();
-            }
-        }
+        visible.resize(N);
+        int const N_visible = frustum_cull(visible.data(), frustum_planes(projection_view),
+            bounding_center.x.data.data(), bounding_center.y.data.data(), bounding_center.z.data.data(), bounding_radius.data.data(), N);
 
-        {
-            // Check that the name of the parent of root node doesn't belong to the hierarchy
-            const std::string root_name_parent = hierarchy.elements[0].name_parent;
-            const auto it = hierarchy.name_map.find(root_name_parent);
-            if(it!=hierarchy.name_map.end()) {
-                std::cerr<<"Error: Hierarchy not valid - name of the root node ("<<root_name_parent<<") cannot be an element of the hierarchy"<<std::endl;
-                abort();
-            }
-        }
+        culling.tested = N;
+        culling.culled = N - N_visible;
+    }
+
+    void hierarchy_mesh_drawable::clear_visibility()
+    {
+        visible.clear();
+        culling = hierarchy_mesh_drawable_culling_statistics();
+    }
 
+    // The visibility is ignored if it has not been computed for all the elements
+    bool hierarchy_mesh_drawable::is_drawn(int index) const
+    {
+        return visible.size() != elements.size() || visible[index] != 0;
+    }
+
+
+    static int find_parent_index(hierarchy_mesh_drawable const& hierarchy, hierarchy_mesh_drawable_node const& node)
+    {
+        // The first element defines the name of the root frame
+        std::string const& root_name_parent = hierarchy.elements.size()==0 ? node.name_parent : hierarchy.elements[0].name_parent;
+
+        if (hierarchy.find(node.name).valid() || node.name == root_name_parent)
         {
-            // Check that all names stored in map are designating the corresponding elements
-            for(const auto& e : hierarchy.name_map)
-            {
-                std::string const& name = e.first;
-                int const index = e.second;
-
-                if(index>=int(hierarchy.elements.size()) || index<0)
-                {
-                    std::cerr<<"Error: Hierarchy not valid - Incorrect index stored in name_map: "<<name<<";"<<index<<std::endl;
-                    abort();
-                }
-
-                hierarchy_mesh_drawable_node const& designated_element = hierarchy.elements[index];
-                if(designated_element.name != name)
-                {
-                    std::cerr<<"Error: Hierarchy not valid - Incoherent name between map ("<<name<<";"<<index<<") and element ("<<designated_element.name<<") "<<std::endl;
-                    abort();
-                }
-            }
+            std::cerr << "Error: Hierarchy not valid - the name of the element (" << node.name << ") is already used in the hierarchy" << std::endl;
+            std::cerr << "Display hierarchy for debugging: " << std::endl;
+            std::cerr << hierarchy.hierarchy_display() << std::endl;
+            abort();
         }
 
+        if (node.name_parent == root_name_parent)
+            return -1;
+
+        hierarchy_mesh_drawable_handle const parent = hierarchy.find(node.name_parent);
+        if (!parent.valid())
         {
-            // Check that all parents are defined before their children (excepted for root parent)
-            std::set<std::string> parent_names_visited;
-            parent_names_visited.insert(hierarchy.elements[0].name_parent);
-            int const N = hierarchy.elements.size();
-            for(int k=0; k<N; ++k)
-            {
-                std::string const& name = hierarchy.elements[k].name;
-                std::string const& parent_name = hierarchy.elements[k].name_parent;
-                if(parent_names_visited.find(parent_name)==parent_names_visited.end())
-                {
-                    std::cerr<<"Error: Hierarchy not valid"<<std::endl;
-                    std::cerr<<"Element ("<<name<<","<<k<<") has parent name ("<<parent_name<<") used before being defined"<<std::endl;
-                    std::cerr << std::endl;
-                    std::cerr << "Display hierarchy for debugging: " << std::endl;
-                    std::cerr << hierarchy.hierarchy_display() << std::endl;
-                    abort();
-                }
-                else
-                    parent_names_visited.insert(name);
-            }
+            std::cerr << "Error: Hierarchy not valid" << std::endl;
+            std::cerr << "Element (" << node.name << "," << hierarchy.elements.size() << ") has parent name (" << node.name_parent << ") used before being defined" << std::endl;
+            std::cerr << std::endl;
+            std::cerr << "Display hierarchy for debugging: " << std::endl;
+            std::cerr << hierarchy.hierarchy_display() << std::endl;
+            abort();
         }
 
+        return parent.index;
     }
 
     std::string hierarchy_mesh_drawable::hierarchy_display() const
@@ -178,18 +347,150 @@ namespace cgp
     }
 
 
+    // Nodes that can be drawn as instances of the same draw call (the color is sent per instance)
+    static bool instancing_compatible(mesh_drawable const& drawable)
+    {
+        return drawable.shader.id == mesh_drawable::default_shader.id && drawable.supplementary_texture.empty()
+            && drawable.vbo_position.size != 0 && drawable.ebo_connectivity.size != 0;
+    }
+    static hierarchy_mesh_drawable_instancing_key instancing_key(mesh_drawable const& drawable)
+    {
+        hierarchy_mesh_drawable_instancing_key key;
+        if (instancing_compatible(drawable)) {
+            key.vao = drawable.vao;
+            key.ebo = drawable.ebo_connectivity.id;
+            key.texture = drawable.texture.id;
+            key.material = drawable.material;
+        }
+        return key;
+    }
+    // Values of the key compared to build the groups (the color is ignored)
+    static auto instancing_key_tie(hierarchy_mesh_drawable_instancing_key const& key)
+    {
+        material_mesh_drawable_phong const& m = key.material;
+        return std::tie(key.vao, key.ebo, key.texture, m.alpha,
+            m.phong.ambient, m.phong.diffuse, m.phong.specular, m.phong.specular_exponent,
+            m.texture_settings.active, m.texture_settings.inverse_v, m.texture_settings.two_sided);
+    }
+    static bool is_same_key(hierarchy_mesh_drawable_instancing_key const& a, hierarchy_mesh_drawable_instancing_key const& b)
+    {
+        return instancing_key_tie(a) == instancing_key_tie(b);
+    }
+
+    // Rebuild the groups only if a node has been added, or if the key of a node changed since the last update
+    static void update_instancing_groups(hierarchy_mesh_drawable& hierarchy)
+    {
+        int const N = static_cast<int>(hierarchy.elements.size());
+        std::vector<hierarchy_mesh_drawable_instancing_key>& keys = hierarchy.instancing_keys;
+
+        bool modified = int(keys.size()) != N;
+        keys.resize(N);
+        for (int k = 0; k < N; ++k) {
+            hierarchy_mesh_drawable_instancing_key const key = instancing_key(hierarchy.elements[k].drawable);
+            if (!is_same_key(key, keys[k])) {
+                keys[k] = key;
+                modified = true;
+            }
+        }
+        if (!modified)
+            return;
+
+        std::vector<int>& order = hierarchy.instancing_order;
+        order.clear();
+        for (int k = 0; k < N; ++k)
+            if (keys[k].vao != 0)
+                order.push_back(k);
+        std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+            return instancing_key_tie(keys[a]) < instancing_key_tie(keys[b]);
+        });
+
+        std::vector<int>& offset = hierarchy.instancing_offset;
+        offset.clear();
+        int const N_order = static_cast<int>(order.size());
+        for (int i = 0; i < N_order; ++i)
+            if (i == 0 || !is_same_key(keys[order[i]], keys[order[i - 1]]))
+                offset.push_back(i);
+        offset.push_back(N_order);
+    }
+
+    // The groups can only be used if the nodes were not modified since the last update
+    static bool instancing_groups_valid(hierarchy_mesh_drawable const& hierarchy)
+    {
+        int const N = static_cast<int>(hierarchy.elements.size());
+        if (int(hierarchy.instancing_keys.size()) != N || hierarchy.instancing_offset.empty())
+            return false;
+        for (int k = 0; k < N; ++k)
+            if (!is_same_key(instancing_key(hierarchy.elements[k].drawable), hierarchy.instancing_keys[k]))
+                return false;
+        return true;
+    }
+
+    static void draw_instanced_groups(hierarchy_mesh_drawable const& hierarchy, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+    {
+        // Nodes that cannot be instanced, in hierarchy order
+        int const N = static_cast<int>(hierarchy.elements.size());
+        for (int k = 0; k < N; ++k)
+            if (hierarchy.instancing_keys[k].vao == 0 && hierarchy.is_drawn(k))
+                draw(hierarchy.elements[k].drawable, environment, additional_uniforms);
+
+        std::vector<mesh_drawable_instance_data> instances;
+        int const N_group = static_cast<int>(hierarchy.instancing_offset.size()) - 1;
+        for (int g = 0; g < N_group; ++g) {
+            // Same matrices as mesh_drawable::send_opengl_uniform, and the material color becomes the color of the instance
+            instances.clear();
+            int last = -1;
+            for (int i = hierarchy.instancing_offset[g]; i < hierarchy.instancing_offset[g + 1]; ++i) {
+                int const k = hierarchy.instancing_order[i];
+                if (!hierarchy.is_drawn(k))
+                    continue;
+                mesh_drawable const& drawable = hierarchy.elements[k].drawable;
+                mat4 const model = drawable.hierarchy_transform_model.matrix() * drawable.model.matrix();
+                mat4 const model_normal = transpose(inverse(drawable.model).matrix() * inverse(drawable.hierarchy_transform_model).matrix());
+                instances.push_back(mesh_drawable_instance(model, model_normal, drawable.material.color));
+                last = k;
+            }
+
+            if (instances.size() == 1) {
+                draw(hierarchy.elements[last].drawable, environment, additional_uniforms);
+            }
+            else if (instances.size() > 1) {
+                mesh_drawable const& drawable = hierarchy.elements[last].drawable;
+                material_mesh_drawable_phong material = drawable.material;
+                material.color = { 1,1,1 };
+                draw_instances(drawable, material, mesh_drawable_instanced::default_shader, instances.data(), int(instances.size()), environment, additional_uniforms);
+            }
+        }
+    }
+
     void draw(hierarchy_mesh_drawable const& hierarchy, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
     {
+        if (hierarchy.instancing && mesh_drawable_instanced::default_shader.id != 0 && instancing_groups_valid(hierarchy)) {
+            draw_instanced_groups(hierarchy, environment, additional_uniforms);
+            return;
+        }
+
         int const N = hierarchy.elements.size();
         for (int k = 0; k < N; ++k)
-            draw(hierarchy.elements[k].drawable, environment, additional_uniforms);
+            if (hierarchy.is_drawn(k))
+                draw(hierarchy.elements[k].drawable, environment, additional_uniforms);
     }
 
     void draw_wireframe(hierarchy_mesh_drawable const& hierarchy, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
+    {
+        // Single pass over all the nodes: the line mode and the shared uniforms are set once
+        mesh_drawable_wireframe_pass pass(environment, color, additional_uniforms);
+        int const N = hierarchy.elements.size();
+        for (int k = 0; k < N; ++k)
+            if (hierarchy.is_drawn(k))
+                pass.draw(hierarchy.elements[k].drawable);
+    }
+
+    void draw_with_wireframe(hierarchy_mesh_drawable const& hierarchy, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
     {
         int const N = hierarchy.elements.size();
         for (int k = 0; k < N; ++k)
-            draw_wireframe(hierarchy.elements[k].drawable, environment, color, additional_uniforms);
+            if (hierarchy.is_drawn(k))
+                draw_with_wireframe(hierarchy.elements[k].drawable, environment, color, additional_uniforms);
     }
 
 }
\ No newline at end of file
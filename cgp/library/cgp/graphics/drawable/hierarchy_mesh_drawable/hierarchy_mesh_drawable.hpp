@@ -1,8 +1,9 @@
 #pragma once
 
 #include "cgp/graphics/drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/graphics/drawable/mesh_drawable_instanced/mesh_drawable_instanced.hpp"
+#include "cgp/geometry/vec/vec3_array/vec3_array.hpp"
 
-#include <map>
 #include <vector>
 
 
@@ -18,6 +19,40 @@ namespace cgp
 		std::string name_parent = "global_frame";
 
 		affine_rts transform_local;
+
+		// Set by update_local_to_global_coordinates(): true if the global transform (drawable.hierarchy_transform_model) was modified during the last update
+		//  Can be used to skip any further processing of the unchanged nodes
+		bool changed = true;
+	};
+
+
+	// Typed handle designating a node of a hierarchy_mesh_drawable
+	//  The handle is obtained once (returned by add(), or using handle(name)) and remains valid as long as the hierarchy exists.
+	//  Accessing a node from its handle is a direct indexing in the elements, without any name lookup.
+	struct hierarchy_mesh_drawable_handle
+	{
+		int index = -1;
+
+		bool valid() const { return index >= 0; }
+	};
+
+
+	// Counters of the last frustum culling (see hierarchy_mesh_drawable::update_visibility)
+	struct hierarchy_mesh_drawable_culling_statistics
+	{
+		int tested = 0; // number of elements tested against the frustum
+		int culled = 0; // number of elements outside the frustum (not drawn)
+	};
+
+
+	// Drawable state shared by the nodes drawn with the same instanced draw call (see hierarchy_mesh_drawable::instancing)
+	//  vao==0 designates a node that cannot be instanced. The material color is not part of the key (it is sent per instance).
+	struct hierarchy_mesh_drawable_instancing_key
+	{
+		GLuint vao = 0;
+		GLuint ebo = 0;
+		GLuint texture = 0;
+		material_mesh_drawable_phong material;
 	};
 
 
@@ -27,24 +62,108 @@ namespace cgp
 		std::vector<hierarchy_mesh_drawable_node> elements;
 
 		// Lookup table to quickly find the index of an element from its name
-		std::map<std::string, int> name_map;
+		//  Open-addressing hash table with linear probing: name_table stores the index of an element (-1 for an empty slot)
+		//  and name_hash[k] stores the hash of elements[k].name. The size of name_table is a power of 2.
+		std::vector<int> name_table;
+		std::vector<unsigned int> name_hash;
+
+		// Flat representation of the hierarchy built incrementally in add()
+		//  The propagation only relies on these indices and never compares names.
+		//  Note: The name and name_parent of an element must not be modified after its insertion.
+		//  parent_index[k]: index of the parent of elements[k] (-1 if elements[k] is attached to the root frame)
+		std::vector<int> parent_index;
+		//  Contiguous storage of the local and global transforms of each element (same indexing as elements)
+		std::vector<affine_rts> transform_local;
+		std::vector<affine_rts> transform_global;
+		//  dirty[k]: elements[k] must be recomputed at the next update regardless of its local transform (set for newly added elements)
+		//   The modifications of transform_local are not tracked: every update compares each elements[k].transform_local with its copy in transform_local,
+		//   so an unchanged frame still costs one scan of the N elements. This is intended: transform_local stays a plain public member that can be written directly.
+		std::vector<char> dirty;
+		//  depth[k]: number of ancestors of elements[k]
+		std::vector<int> depth;
+
+		// Ordering of the elements by increasing depth used by the parallel update (built when needed)
+		//  The elements of depth d are level_order[level_offset[d] ... level_offset[d+1]-1]
+		std::vector<int> level_order;
+		std::vector<int> level_offset;
+
+		// Indices of the elements whose global transform was modified during the last update
+		std::vector<int> changed_elements;
+
+		// Sphere containing each element in world coordinates, stored per component for the batched frustum test
+		//  Computed with the global transform of the element during the update (from drawable.model and drawable.bounding_volume)
+		//  Note: A modification of drawable.model or drawable.bounding_volume alone is not detected by the update.
+		vec3_array bounding_center;
+		numarray<float> bounding_radius;
+
+		// Result of the last update_visibility(): elements[k] is not drawn if visible[k]==0
+		//  All the elements are drawn if update_visibility() has not been called since the last insertion
+		std::vector<char> visible;
+		hierarchy_mesh_drawable_culling_statistics culling;
+
+		// Draw the nodes sharing the same VAO, texture and material (up to the color) with a single instanced draw call
+		//  Only applies to the nodes using mesh_drawable::default_shader, when mesh_drawable_instanced::default_shader is loaded
+		//  Note: The nodes are not drawn in the order of the hierarchy (the other nodes first, then one group after the other),
+		//        which modifies the result of blending. The instancing is therefore only used when explicitly enabled.
+		bool instancing = false;
+
+		// Grouping of the nodes used by the instanced draw, rebuilt by the update of the global coordinates when instancing is enabled
+		//  The grouping is only recomputed if a node is added, or if the mesh, the texture or the material of a node changed.
+		//  instancing_keys[k]: key of elements[k] at the last update
+		//  The group g is instancing_order[instancing_offset[g] ... instancing_offset[g+1]-1] (instanceable nodes only, in hierarchy order within a group)
+		std::vector<hierarchy_mesh_drawable_instancing_key> instancing_keys;
+		std::vector<int> instancing_order;
+		std::vector<int> instancing_offset;
 		
 		// Add new node to the hierarchy
 		// Note: Parent node is expected to be already present in the hierarchy
 		// The name of each node must be unique in the hierarchy
-		void add(hierarchy_mesh_drawable_node const& node);
-		void add(mesh_drawable const& element, std::string const& name, std::string const& name_parent = "global_frame", vec3 const& translation = vec3(), rotation_transform const& = rotation_transform());
-		void add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform);
+		// Return the handle of the inserted node
+		hierarchy_mesh_drawable_handle add(hierarchy_mesh_drawable_node const& node);
+		hierarchy_mesh_drawable_handle add(mesh_drawable const& element, std::string const& name, std::string const& name_parent = "global_frame", vec3 const& translation = vec3(), rotation_transform const& = rotation_transform());
+		hierarchy_mesh_drawable_handle add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform);
+
+		// Get the handle of a node from its name
+		//  handle() stops the program if the name doesn't exist, while find() returns an invalid handle
+		hierarchy_mesh_drawable_handle handle(std::string const& name) const;
+		hierarchy_mesh_drawable_handle find(std::string const& name) const;
+		hierarchy_mesh_drawable_handle find(char const* name) const;
+
+		// True if the handle designates a node of this hierarchy (a handle obtained from another, larger, hierarchy may be out of range)
+		bool is_valid(hierarchy_mesh_drawable_handle const& handle) const;
+
+		// Get node by handle (prefered access in the animation loop)
+		hierarchy_mesh_drawable_node& operator[](hierarchy_mesh_drawable_handle const& handle);
+		hierarchy_mesh_drawable_node const& operator[](hierarchy_mesh_drawable_handle const& handle) const;
 
 		// Get node by name
 		hierarchy_mesh_drawable_node& operator[](std::string const& name);
 		hierarchy_mesh_drawable_node const& operator[](std::string const& name) const;
+		hierarchy_mesh_drawable_node& operator[](char const* name);
+		hierarchy_mesh_drawable_node const& operator[](char const* name) const;
 
 
 		// Update the global coordinates of the nodes along the hierarchy
 		//  This function must be called before draw, and called again if any hierarchical transform is modified
+		//  The propagation is a single linear pass over the elements (parents are always stored before their children)
+		//  Only the elements whose transform_local changed since the last update (and their descendants) are recomputed
 		void update_local_to_global_coordinates();
 
+		// Same as update_local_to_global_coordinates() using multiple threads (see parallel_for)
+		//  The elements of the same depth are computed in parallel, one depth level after the other.
+		//  The result is identical to the serial update. Only efficient for wide hierarchies (ex. many independent roots).
+		void update_local_to_global_coordinates_parallel();
+		// Number of elements of a level processed per task of the parallel update (a level is split between threads only if it is wider)
+		static int const parallel_grain_size = 1024;
+
+		// Frustum culling: test the bounding sphere of each element against the view frustum of (projection * view)
+		//  Must be called after the update of the global coordinates, and before draw (typically once per frame)
+		void update_visibility(mat4 const& projection_view);
+		// Disable the culling: all the elements are drawn
+		void clear_visibility();
+		// True if elements[index] passed the last culling (or if the culling is not used)
+		bool is_drawn(int index) const;
+
 		// Helper function to display all the hierarchy
 		std::string hierarchy_display() const;
 	};
@@ -53,5 +172,8 @@ namespace cgp
 
 	void draw_wireframe(hierarchy_mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = { 0,0,1 }, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
 
+	// Draw each node with its wireframe in a single pass (see draw_with_wireframe on mesh_drawable). The nodes are not instanced.
+	void draw_with_wireframe(hierarchy_mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = { 0,0,1 }, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+
 
 }
\ No newline at end of file
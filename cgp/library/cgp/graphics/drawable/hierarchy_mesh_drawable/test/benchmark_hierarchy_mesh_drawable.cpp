@@ -0,0 +1,58 @@
+#include "cgp/graphics/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace cgp_test
+{
+	using namespace cgp;
+
+	// Forest of 4-ary trees: the first N/100 nodes are roots
+	static hierarchy_mesh_drawable generate_hierarchy(int N)
+	{
+		hierarchy_mesh_drawable hierarchy;
+		mesh_drawable drawable;
+		int const N_root = std::max(1, N / 100);
+		for (int k = 0; k < N; ++k)
+		{
+			std::string const parent = k < N_root ? "global_frame" : "node " + str((k - N_root) / 4);
+			vec3 const translation = { rand_interval(), rand_interval(), rand_interval() };
+			rotation_transform const rotation = rotation_transform::from_axis_angle(normalize(vec3{ rand_interval(), rand_interval(), 1.0f }), rand_interval());
+			hierarchy.add(drawable, "node " + str(k), parent, affine_rts(rotation, translation, rand_interval(0.5f, 1.5f)));
+		}
+		return hierarchy;
+	}
+
+	static double timing_ms(hierarchy_mesh_drawable& hierarchy, void (hierarchy_mesh_drawable::*update)(), int N_repeat)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_repeat; ++k) {
+			for (auto& element : hierarchy.elements) // force the full recomputation
+				element.transform_local.scaling += 1e-3f;
+			(hierarchy.*update)();
+		}
+		auto const t1 = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(t1 - t0).count() / N_repeat;
+	}
+
+	void benchmark_hierarchy_mesh_drawable()
+	{
+		for (int N : { 10000, 100000, 1000000 })
+		{
+			hierarchy_mesh_drawable serial = generate_hierarchy(N);
+			hierarchy_mesh_drawable parallel = serial;
+
+			int const N_repeat = std::max(1, 1000000 / N);
+			double const t_serial = timing_ms(serial, &hierarchy_mesh_drawable::update_local_to_global_coordinates, N_repeat);
+			double const t_parallel = timing_ms(parallel, &hierarchy_mesh_drawable::update_local_to_global_coordinates_parallel, N_repeat);
+
+			// The results must be identical bit for bit
+			assert_cgp_no_msg(serial.changed_elements == parallel.changed_elements);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(std::memcmp(&serial.transform_global[k], &parallel.transform_global[k], sizeof(affine_rts)) == 0);
+
+			std::cout << "hierarchy_mesh_drawable update - " << N << " nodes: serial " << t_serial << " ms, parallel (" << parallel_number_of_threads() << " threads) " << t_parallel << " ms" << std::endl;
+		}
+	}
+}
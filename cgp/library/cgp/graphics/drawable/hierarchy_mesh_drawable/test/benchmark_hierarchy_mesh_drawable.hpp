@@ -0,0 +1,9 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Compare the timing of the serial and parallel update of hierarchy_mesh_drawable for 10k, 100k and 1M nodes
+	//  Also checks that both updates give identical results
+	void benchmark_hierarchy_mesh_drawable();
+}
@@ -0,0 +1,209 @@
+#include "test_hierarchy_mesh_drawable.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/core/parallel/parallel.hpp"
+#include "../hierarchy_mesh_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static affine_rts rand_affine_rts()
+	{
+		vec3 const axis = normalize(vec3{ rand_interval(-1,1), rand_interval(-1,1), rand_interval(0.1f,1) });
+		vec3 const translation = { rand_interval(-2,2), rand_interval(-2,2), rand_interval(-2,2) };
+		return affine_rts(rotation_transform::from_axis_angle(axis, rand_interval(-3,3)), translation, rand_interval(0.8f, 1.2f));
+	}
+
+	// Random tree of N nodes: the parent of each node is chosen among the previous nodes, either the previous one (deep chains) or any of them (wide levels)
+	static hierarchy_mesh_drawable random_hierarchy(int N, int N_root)
+	{
+		hierarchy_mesh_drawable hierarchy;
+		for (int k = 0; k < N; ++k) {
+			std::string parent = "global_frame";
+			if (k >= N_root)
+				parent = "node " + str(rand_interval() < 0.5f ? k - 1 : int(rand_interval(0, float(k) - 0.5f)));
+			hierarchy.add(mesh_drawable(), "node " + str(k), parent, rand_affine_rts());
+		}
+		return hierarchy;
+	}
+
+	static bool is_equal_transform(affine_rts const& a, affine_rts const& b)
+	{
+		return is_equal(vec4(a.rotation.data), vec4(b.rotation.data)) && is_equal(a.translation, b.translation) && is_equal(a.scaling, b.scaling);
+	}
+
+	// Reference global transform: recursion along the names of the parents
+	static affine_rts global_transform_recursive(hierarchy_mesh_drawable const& hierarchy, std::string const& name)
+	{
+		for (hierarchy_mesh_drawable_node const& node : hierarchy.elements) {
+			if (node.name == name) {
+				if (node.name_parent == hierarchy.elements[0].name_parent)
+					return node.transform_local;
+				return global_transform_recursive(hierarchy, node.name_parent) * node.transform_local;
+			}
+		}
+		error_cgp("Element not found " + name);
+	}
+
+	// True if the element k is the element root or one of its descendants
+	static bool is_in_subtree(hierarchy_mesh_drawable const& hierarchy, int k, int root)
+	{
+		for (; k >= 0; k = hierarchy.parent_index[k])
+			if (k == root)
+				return true;
+		return false;
+	}
+
+	void test_hierarchy_mesh_drawable_propagation()
+	{
+		int const N = 300;
+		hierarchy_mesh_drawable hierarchy = random_hierarchy(N, 3);
+		hierarchy.update_local_to_global_coordinates();
+
+		for (int k = 0; k < N; ++k) {
+			affine_rts const reference = global_transform_recursive(hierarchy, hierarchy.elements[k].name);
+			assert_cgp_no_msg(is_equal_transform(hierarchy.transform_global[k], reference));
+			assert_cgp_no_msg(is_equal_transform(hierarchy.elements[k].drawable.hierarchy_transform_model, reference));
+		}
+
+		// The parents are stored before their children
+		for (int k = 0; k < N; ++k)
+			assert_cgp_no_msg(hierarchy.parent_index[k] < k);
+	}
+
+	void test_hierarchy_mesh_drawable_dirty_update()
+	{
+		int const N = 300;
+		hierarchy_mesh_drawable hierarchy = random_hierarchy(N, 3);
+		hierarchy.update_local_to_global_coordinates();
+		assert_cgp_no_msg(int(hierarchy.changed_elements.size()) == N);
+
+		// Nothing to recompute without modification
+		hierarchy.update_local_to_global_coordinates();
+		assert_cgp_no_msg(hierarchy.changed_elements.size() == 0);
+
+		for (int modified : { 0, 17, 150, N - 1 })
+		{
+			hierarchy[hierarchy_mesh_drawable_handle{ modified }].transform_local = rand_affine_rts();
+			hierarchy.update_local_to_global_coordinates();
+
+			// Only the subtree of the modified element is recomputed
+			std::vector<int> expected;
+			for (int k = 0; k < N; ++k)
+				if (is_in_subtree(hierarchy, k, modified))
+					expected.push_back(k);
+			assert_cgp_no_msg(hierarchy.changed_elements == expected);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(hierarchy.elements[k].changed == is_in_subtree(hierarchy, k, modified));
+
+			// Same result as a full update
+			hierarchy_mesh_drawable full = hierarchy;
+			full.dirty.assign(N, 1);
+			full.update_local_to_global_coordinates();
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(is_equal_transform(hierarchy.transform_global[k], full.transform_global[k]));
+		}
+	}
+
+	void test_hierarchy_mesh_drawable_handle()
+	{
+		int const N = 50;
+		hierarchy_mesh_drawable hierarchy;
+		std::vector<hierarchy_mesh_drawable_handle> handles;
+		for (int k = 0; k < N; ++k)
+			handles.push_back(hierarchy.add(mesh_drawable(), "node " + str(k), k == 0 ? "global_frame" : "node " + str(k / 2)));
+
+		// The handles returned by add() and obtained from the names designate the same nodes
+		for (int k = 0; k < N; ++k) {
+			std::string const name = "node " + str(k);
+			assert_cgp_no_msg(hierarchy.is_valid(handles[k]));
+			assert_cgp_no_msg(hierarchy.handle(name).index == handles[k].index);
+			assert_cgp_no_msg(hierarchy.find(name).index == handles[k].index);
+			assert_cgp_no_msg(hierarchy.find(name.c_str()).index == handles[k].index);
+			assert_cgp_no_msg(hierarchy[handles[k]].name == name);
+			assert_cgp_no_msg(&hierarchy[handles[k]] == &hierarchy[name]);
+		}
+
+		// Invalid handles: default, unknown name, and handle out of range of a smaller hierarchy
+		assert_cgp_no_msg(!hierarchy_mesh_drawable_handle().valid());
+		assert_cgp_no_msg(!hierarchy.is_valid(hierarchy_mesh_drawable_handle()));
+		assert_cgp_no_msg(!hierarchy.find("unknown").valid());
+		assert_cgp_no_msg(!hierarchy.is_valid(hierarchy.find(std::string("node ") + str(N))));
+		assert_cgp_no_msg(!hierarchy.is_valid(hierarchy_mesh_drawable_handle{ N }));
+
+		hierarchy_mesh_drawable small;
+		small.add(mesh_drawable(), "node 0");
+		assert_cgp_no_msg(small.is_valid(handles[0]));
+		assert_cgp_no_msg(!small.is_valid(handles[N - 1]));
+
+		// A handle remains valid when nodes are added afterwards
+		hierarchy_mesh_drawable_handle const h = handles[N / 2];
+		hierarchy.add(mesh_drawable(), "node extra", "node 3");
+		assert_cgp_no_msg(hierarchy.is_valid(h));
+		assert_cgp_no_msg(hierarchy[h].name == "node " + str(N / 2));
+		assert_cgp_no_msg(hierarchy[hierarchy.handle("node extra")].name_parent == "node 3");
+	}
+
+	// The serial and parallel updates compute the same floating point operations: the results are compared bitwise
+	static bool is_same_update(hierarchy_mesh_drawable const& a, hierarchy_mesh_drawable const& b)
+	{
+		return a.transform_global.size() == b.transform_global.size()
+			&& std::memcmp(a.transform_global.data(), b.transform_global.data(), a.transform_global.size() * sizeof(affine_rts)) == 0
+			&& a.changed_elements == b.changed_elements;
+	}
+
+	void test_hierarchy_mesh_drawable_parallel_update()
+	{
+		int const N_thread_initial = parallel_number_of_threads();
+		parallel_set_number_of_threads(4);
+
+		// Forest of 3 roots with many direct children (wide level), followed by deep chains and random subtrees
+		int const N_root = 3;
+		int const N_child = 2 * hierarchy_mesh_drawable::parallel_grain_size;
+		int const N_random = 2000;
+		hierarchy_mesh_drawable serial;
+		for (int k = 0; k < N_root; ++k)
+			serial.add(mesh_drawable(), "node " + str(k), "global_frame", rand_affine_rts());
+		for (int k = N_root; k < N_root + N_root * N_child; ++k)
+			serial.add(mesh_drawable(), "node " + str(k), "node " + str(k % N_root), rand_affine_rts());
+		int const N_wide = N_root + N_root * N_child;
+		for (int k = N_wide; k < N_wide + N_random; ++k) {
+			int const parent = rand_interval() < 0.5f ? k - 1 : int(rand_interval(0, float(k) - 0.5f));
+			serial.add(mesh_drawable(), "node " + str(k), "node " + str(parent), rand_affine_rts());
+		}
+		int const N = N_wide + N_random;
+		hierarchy_mesh_drawable parallel = serial;
+
+		serial.update_local_to_global_coordinates();
+		parallel.update_local_to_global_coordinates_parallel();
+		assert_cgp_no_msg(is_same_update(serial, parallel));
+
+		// At least one level is split between several tasks of parallel_for, and the tree has deep levels
+		int width_max = 0;
+		int const N_level = int(parallel.level_offset.size()) - 1;
+		for (int level = 0; level < N_level; ++level)
+			width_max = std::max(width_max, parallel.level_offset[level + 1] - parallel.level_offset[level]);
+		assert_cgp_no_msg(width_max > 4 * hierarchy_mesh_drawable::parallel_grain_size);
+		assert_cgp_no_msg(N_level > 10);
+
+		// Incremental updates after modifying some nodes
+		for (int iteration = 0; iteration < 3; ++iteration) {
+			for (int k = 0; k < 100; ++k) {
+				int const index = int(rand_interval(0, N - 0.5f));
+				affine_rts const T = rand_affine_rts();
+				serial.elements[index].transform_local = T;
+				parallel.elements[index].transform_local = T;
+			}
+			serial.update_local_to_global_coordinates();
+			parallel.update_local_to_global_coordinates_parallel();
+			assert_cgp_no_msg(serial.changed_elements.size() > 0);
+			assert_cgp_no_msg(is_same_update(serial, parallel));
+		}
+
+		parallel_set_number_of_threads(N_thread_initial);
+	}
+}
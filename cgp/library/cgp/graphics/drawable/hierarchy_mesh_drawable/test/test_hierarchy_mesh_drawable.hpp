@@ -0,0 +1,10 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	void test_hierarchy_mesh_drawable_propagation();
+	void test_hierarchy_mesh_drawable_dirty_update();
+	void test_hierarchy_mesh_drawable_handle();
+	void test_hierarchy_mesh_drawable_parallel_update();
+}
@@ -0,0 +1,77 @@
+#include "test_hierarchy_mesh_drawable_culling.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/geometry/transform/projection/projection.hpp"
+#include "../hierarchy_mesh_drawable.hpp"
+#include "cgp/graphics/drawable/render_queue/render_queue.hpp"
+#include "cgp/graphics/opengl/debug/opengl_call_recorder/test/fake_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static int count_draws(hierarchy_mesh_drawable const& hierarchy)
+	{
+		opengl_call_recorder_reset();
+		draw(hierarchy);
+		return opengl_call_recorder_statistics().draw;
+	}
+
+	void test_hierarchy_mesh_drawable_culling()
+	{
+		// Camera at the origin looking toward -z
+		mat4 const projection_view = projection_perspective(Pi / 2, 1.0f, 0.1f, 100.0f);
+
+		// Root in front of the camera, N children in view, N children far on the side, and N grand-children brought back in view by their local transform
+		int const N = 100;
+		mesh_drawable const bounded = fake_drawable(1, 10, 1, bounding_sphere{ {0,0,0}, 1.0f });
+		hierarchy_mesh_drawable hierarchy;
+		hierarchy.instancing = false;
+		hierarchy.add(bounded, "root", "global_frame", { 0,0,-10 });
+		for (int k = 0; k < N; ++k) {
+			hierarchy.add(bounded, "near " + str(k), "root");
+			hierarchy.add(bounded, "far " + str(k), "root", { 1000,0,0 });
+			hierarchy.add(bounded, "back " + str(k), "far " + str(k), { -1000,0,0 });
+		}
+		hierarchy.update_local_to_global_coordinates();
+
+		opengl_call_recorder_start();
+
+		assert_cgp_no_msg(count_draws(hierarchy) == 1 + 3 * N);
+
+		hierarchy.update_visibility(projection_view);
+		assert_cgp_no_msg(hierarchy.culling.tested == 1 + 3 * N);
+		assert_cgp_no_msg(hierarchy.culling.culled == N);
+		assert_cgp_no_msg(count_draws(hierarchy) == 1 + 2 * N);
+
+		// The render queue skips the culled elements as well
+		render_queue queue;
+		queue.push_back(hierarchy);
+		assert_cgp_no_msg(queue.size() == 1 + 2 * N);
+		opengl_call_recorder_reset();
+		draw(queue);
+		assert_cgp_no_msg(opengl_call_recorder_statistics().draw == 1 + 2 * N);
+
+		// The bounds follow the global transforms: moving the root behind the camera culls everything
+		hierarchy["root"].transform_local.translation = { 0,0,10 };
+		hierarchy.update_local_to_global_coordinates();
+		hierarchy.update_visibility(projection_view);
+		assert_cgp_no_msg(hierarchy.culling.culled == 1 + 3 * N);
+		assert_cgp_no_msg(count_draws(hierarchy) == 0);
+		queue.clear();
+		queue.push_back(hierarchy);
+		assert_cgp_no_msg(queue.size() == 0);
+
+		// Elements without bounding sphere are never culled, and new elements are drawn until the next culling
+		hierarchy.add(fake_drawable(1, 10, 1), "unbounded", "root");
+		hierarchy.update_local_to_global_coordinates();
+		assert_cgp_no_msg(count_draws(hierarchy) == 2 + 3 * N);
+		hierarchy.update_visibility(projection_view);
+		assert_cgp_no_msg(count_draws(hierarchy) == 1);
+
+		hierarchy.clear_visibility();
+		assert_cgp_no_msg(count_draws(hierarchy) == 2 + 3 * N);
+
+		opengl_call_recorder_stop();
+	}
+}
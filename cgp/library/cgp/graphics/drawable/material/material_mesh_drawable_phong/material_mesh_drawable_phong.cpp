@@ -9,17 +9,19 @@ namespace cgp
 {
 	void material_mesh_drawable_phong::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 	{
-		opengl_uniform(shader, "material.color", color, expected);
-		opengl_uniform(shader, "material.alpha", alpha, expected);
+		opengl_uniform_layout const& layout = shader.uniform_layout();
 
-		opengl_uniform(shader, "material.phong.ambient", phong.ambient, expected);
-		opengl_uniform(shader, "material.phong.diffuse", phong.diffuse, expected);
-		opengl_uniform(shader, "material.phong.specular", phong.specular, expected);
-		opengl_uniform(shader, "material.phong.specular_exponent", phong.specular_exponent, expected);
+		opengl_uniform(layout.material_color, color, expected);
+		opengl_uniform(layout.material_alpha, alpha, expected);
 
-		opengl_uniform(shader, "material.texture_settings.use_texture", texture_settings.active, expected);
-		opengl_uniform(shader, "material.texture_settings.texture_inverse_v", texture_settings.inverse_v, expected);
-		opengl_uniform(shader, "material.texture_settings.two_sided", texture_settings.two_sided, expected);
+		opengl_uniform(layout.material_phong_ambient, phong.ambient, expected);
+		opengl_uniform(layout.material_phong_diffuse, phong.diffuse, expected);
+		opengl_uniform(layout.material_phong_specular, phong.specular, expected);
+		opengl_uniform(layout.material_phong_specular_exponent, phong.specular_exponent, expected);
+
+		opengl_uniform(layout.material_texture_use_texture, texture_settings.active, expected);
+		opengl_uniform(layout.material_texture_inverse_v, texture_settings.inverse_v, expected);
+		opengl_uniform(layout.material_texture_two_sided, texture_settings.two_sided, expected);
 	}
 
 }
\ No newline at end of file
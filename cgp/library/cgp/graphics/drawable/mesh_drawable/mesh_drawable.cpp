@@ -6,8 +6,10 @@ namespace cgp
 {
 	opengl_shader_structure mesh_drawable::default_shader;
 	opengl_texture_image_structure mesh_drawable::default_texture;
+	opengl_shader_structure mesh_drawable::wireframe_shader;
 
 	static void warning_initialize_non_empty();
+	static void initialize_vao(mesh_drawable& drawable);
 
 	void mesh_drawable::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
 	{
@@ -36,6 +38,7 @@ namespace cgp
 		texture = texture_arg;
 		model = affine();
 		material = material_mesh_drawable_phong();
+		bounding_volume = bounding_sphere_compute(data.position);
 
 
 		// Send the data to the GPU
@@ -49,13 +52,54 @@ namespace cgp
 		ebo_connectivity.initialize_data_on_gpu(data.connectivity);
 
 
+		initialize_vao(*this);
+	}
+
+	void mesh_drawable::initialize_data_on_gpu(mesh_binary_mapping const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		opengl_check;
+
+		if (vao != 0 || vbo_position.size != 0)
+			warning_initialize_non_empty();
+
+		if (data.N_position == 0) {
+			warning_cgp("Warning try to generate mesh_drawable with 0 vertex", "");
+			return;
+		}
+
+		// Same requirements as mesh_check, the per-vertex data must be filled
+		int const N = data.N_position;
+		assert_cgp(data.N_normal == N && data.N_color == N && data.N_uv == N, "Cannot send this binary mesh data to GPU in initializing mesh_drawable: all per-vertex data must have the same size");
+		for (int k = 0; k < data.N_connectivity; ++k) {
+			uint3 const& f = data.connectivity[k];
+			assert_cgp(f[0] < unsigned(N) && f[1] < unsigned(N) && f[2] < unsigned(N), "Cannot send this binary mesh data to GPU in initializing mesh_drawable: incorrect index in connectivity");
+		}
+
+		shader = shader_arg;
+		texture = texture_arg;
+		model = affine();
+		material = material_mesh_drawable_phong();
+		bounding_volume = bounding_sphere_compute(data.position, N);
+
+		vbo_position.initialize_data_on_gpu(data.position, N);
+		vbo_normal.initialize_data_on_gpu(data.normal, N);
+		vbo_color.initialize_data_on_gpu(data.color, N);
+		vbo_uv.initialize_data_on_gpu(data.uv, N);
+
+		ebo_connectivity.initialize_data_on_gpu(data.connectivity, data.N_connectivity);
+
+		initialize_vao(*this);
+	}
+
+	static void initialize_vao(mesh_drawable& drawable)
+	{
 		// Generate VAO
-		glGenVertexArrays(1, &vao); opengl_check;
-		glBindVertexArray(vao); opengl_check;
-		opengl_set_vao_location(vbo_position, 0);
-		opengl_set_vao_location(vbo_normal, 1);
-		opengl_set_vao_location(vbo_color, 2);
-		opengl_set_vao_location(vbo_uv, 3);
+		glGenVertexArrays(1, &drawable.vao); opengl_check;
+		glBindVertexArray(drawable.vao); opengl_check;
+		opengl_set_vao_location(drawable.vbo_position, 0);
+		opengl_set_vao_location(drawable.vbo_normal, 1);
+		opengl_set_vao_location(drawable.vbo_color, 2);
+		opengl_set_vao_location(drawable.vbo_uv, 3);
 		glBindVertexArray(0); opengl_check;
 	}
 
@@ -74,6 +118,7 @@ namespace cgp
 		shader = opengl_shader_structure();
 		model = affine();
 		material = material_mesh_drawable_phong();
+		bounding_volume = bounding_sphere();
 		texture = opengl_texture_image_structure();
 		supplementary_texture.clear();
 
@@ -93,41 +138,46 @@ namespace cgp
 	}
 
 
-	void draw(mesh_drawable const& drawable, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	// Model matrices of the drawable sent to the given shader
+	static void send_model_uniform(mesh_drawable const& drawable, opengl_shader_structure const& shader, bool expected)
 	{
-		// Initial clean check
-		// ********************************** //
-		// If there is not vertices or not triangles, returns
-		//  (no error + does not display anything)
-		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
-			return;
+		// Final model matrix in the shader is: hierarchy_transform_model * model
+		mat4 const model_shader = drawable.hierarchy_transform_model.matrix() * drawable.model.matrix();
 
-		assert_cgp(drawable.shader.id != 0, "Try to draw mesh_drawable without shader ");
-		assert_cgp(!glIsShader(drawable.shader.id), "Try to draw mesh_drawable with incorrect shader ");
-		assert_cgp(drawable.texture.id != 0, "Try to draw mesh_drawable without texture ");
+		// The normal matrix is transpose( (hierarchy_transform_model * model)^{-1} )
+		mat4 const model_normal_shader = transpose(inverse(drawable.model).matrix() * inverse(drawable.hierarchy_transform_model).matrix());
 
+		opengl_uniform_layout const& layout = shader.uniform_layout();
+		opengl_uniform(layout.model, model_shader, expected);
+		opengl_uniform(layout.modelNormal, model_normal_shader, expected);
+	}
+
+	// Set the shader, the uniforms and the textures used to draw the mesh (the shader replaces drawable.shader)
+	static void draw_setup(mesh_drawable const& drawable, opengl_shader_structure const& shader, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
 		// Set the current shader
 		// ********************************** //
-		glUseProgram(drawable.shader.id); opengl_check;
+		glUseProgram(shader.id); opengl_check;
 
 		// Send uniforms for this shader
 		// ********************************** //
 
 		// send the uniform values for the model and material of the mesh_drawable
-		drawable.send_opengl_uniform();
+		send_model_uniform(drawable, shader, true);
+		drawable.material.send_opengl_uniform(shader);
 
 		// send the uniform values for the environment
-		environment.send_opengl_uniform(drawable.shader);
+		environment.send_opengl_uniform(shader);
 
 		// [Optionnal] send any additional uniform for this specidic draw call
-		additional_uniforms.send_opengl_uniform(drawable.shader);
+		additional_uniforms.send_opengl_uniform(shader);
 
 
 		// Set textures
 		// ********************************** //
 		glActiveTexture(GL_TEXTURE0); opengl_check;
 		drawable.texture.bind();
-		opengl_uniform(drawable.shader, "image_texture", 0);  opengl_check;
+		opengl_uniform(shader.uniform_layout().image_texture, 0);  opengl_check;
 
 		//Set any additional texture
 		int texture_count = 1;
@@ -138,57 +188,123 @@ namespace cgp
 
 			glActiveTexture(GL_TEXTURE0 + texture_count); opengl_check;
 			additional_texture.bind();
-			opengl_uniform(drawable.shader, additional_texture_name, texture_count);
+			opengl_uniform(shader, additional_texture_name, texture_count);
 
 			texture_count++;
 		}
+	}
 
-
-		// Prepare for draw call
-		// ********************************** //
+	// Indexed draw call on the VAO of the drawable
+	static void draw_elements(mesh_drawable const& drawable)
+	{
 		glBindVertexArray(drawable.vao);                                     opengl_check;
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ebo_connectivity.id); opengl_check;
-
-
-		// Draw call
-		// ********************************** //
 		glDrawElements(GL_TRIANGLES, GLsizei(drawable.ebo_connectivity.size * 3), GL_UNSIGNED_INT, nullptr); opengl_check;
+	}
 
-
-		// Clean state
-		// ********************************** //
+	static void draw_clean(mesh_drawable const& drawable)
+	{
 		glBindVertexArray(0);
 		drawable.texture.unbind();
 		glUseProgram(0);
 	}
 
-	void draw_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
+	void draw(mesh_drawable const& drawable, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		// Initial clean check
+		// ********************************** //
+		// If there is not vertices or not triangles, returns
+		//  (no error + does not display anything)
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+			return;
+
+		assert_cgp(drawable.shader.id != 0, "Try to draw mesh_drawable without shader ");
+		assert_cgp(!glIsShader(drawable.shader.id), "Try to draw mesh_drawable with incorrect shader ");
+		assert_cgp(drawable.texture.id != 0, "Try to draw mesh_drawable without texture ");
+
+		draw_setup(drawable, drawable.shader, environment, additional_uniforms);
+		draw_elements(drawable);
+		draw_clean(drawable);
+	}
+
+	void draw_with_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
+	{
+		// The single pass replaces the default shader only: other shaders are drawn in two passes
+		if (mesh_drawable::wireframe_shader.id == 0 || drawable.shader.id != mesh_drawable::default_shader.id) {
+			draw(drawable, environment, additional_uniforms);
+			draw_wireframe(drawable, environment, color, additional_uniforms);
+			return;
+		}
+
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+			return;
+		assert_cgp(drawable.texture.id != 0, "Try to draw mesh_drawable without texture ");
+
+		draw_setup(drawable, mesh_drawable::wireframe_shader, environment, additional_uniforms);
+		opengl_uniform(mesh_drawable::wireframe_shader, "wireframe_color", color);
+		draw_elements(drawable);
+		draw_clean(drawable);
+	}
+
+
+	mesh_drawable_wireframe_pass::mesh_drawable_wireframe_pass(environment_generic_structure const& environment_arg, vec3 const& color_arg, uniform_generic_structure const& additional_uniforms_arg)
+		:environment(environment_arg), additional_uniforms(additional_uniforms_arg), color(color_arg), current_shader(0)
 	{
-		mesh_drawable wireframe = drawable;
-		wireframe.material.phong = { 1.0f,0.0f,0.0f,64.0f };
-		wireframe.material.color = color;
-		wireframe.material.texture_settings.active = false;
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glEnable(GL_POLYGON_OFFSET_LINE);
 		glPolygonOffset(-1.0, 1.0);        opengl_check;
-		draw(wireframe, environment, additional_uniforms);
+	}
+
+	mesh_drawable_wireframe_pass::~mesh_drawable_wireframe_pass()
+	{
+		glBindVertexArray(0);
+		glUseProgram(0);
 		glDisable(GL_POLYGON_OFFSET_LINE); opengl_check;
 		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	}
 
+	void mesh_drawable_wireframe_pass::draw(mesh_drawable const& drawable)
+	{
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+			return;
+		assert_cgp(drawable.shader.id != 0, "Try to draw mesh_drawable without shader ");
 
-	void mesh_drawable::send_opengl_uniform(bool expected) const
+		// The uniforms shared by all the drawables are only sent when the shader changes
+		opengl_shader_structure const& shader = drawable.shader;
+		if (shader.id != current_shader) {
+			glUseProgram(shader.id); opengl_check;
+			environment.send_opengl_uniform(shader);
+			additional_uniforms.send_opengl_uniform(shader);
+			current_shader = shader.id;
+		}
+
+		// Material override on a copy of the material only (no texture is used)
+		material_mesh_drawable_phong material = drawable.material;
+		material.phong = { 1.0f,0.0f,0.0f,64.0f };
+		material.color = color;
+		material.texture_settings.active = false;
+
+		send_model_uniform(drawable, shader, true);
+		material.send_opengl_uniform(shader);
+		draw_elements(drawable);
+	}
+
+	void draw_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms)
 	{
-		// Final model matrix in the shader is: hierarchy_transform_model * model
-		mat4 const model_shader = hierarchy_transform_model.matrix() * model.matrix();
+		mesh_drawable_wireframe_pass pass(environment, color, additional_uniforms);
+		pass.draw(drawable);
+	}
 
-		// The normal matrix is transpose( (hierarchy_transform_model * model)^{-1} )
-		mat4 const model_normal_shader = transpose(inverse(model).matrix() * inverse(hierarchy_transform_model).matrix());
-		
+	bounding_sphere bounding_volume_world(mesh_drawable const& drawable)
+	{
+		return drawable.hierarchy_transform_model * (drawable.model * drawable.bounding_volume);
+	}
 
+
+	void mesh_drawable::send_opengl_uniform(bool expected) const
+	{
 		// set the Model matrix
-		opengl_uniform(shader, "model", model_shader, expected);
-		opengl_uniform(shader, "modelNormal", model_normal_shader, expected);
+		send_model_uniform(*this, shader, expected);
 
 		// set the material
 		material.send_opengl_uniform(shader);
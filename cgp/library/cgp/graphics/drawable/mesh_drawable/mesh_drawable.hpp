@@ -2,6 +2,7 @@
 
 #include "cgp/graphics/opengl/opengl.hpp"
 #include "cgp/geometry/shape/mesh/mesh.hpp"
+#include "cgp/geometry/shape/bounding_volume/bounding_volume.hpp"
 #include "cgp/graphics/drawable/material/material_mesh_drawable_phong/material_mesh_drawable_phong.hpp"
 #include "cgp/graphics/drawable/environment/environment.hpp"
 #include "cgp/geometry/transform/affine/affine.hpp"
@@ -16,6 +17,9 @@ namespace cgp
 		// Shader data
 		static opengl_shader_structure default_shader; // default mesh shader shared by all mesh_drawable 
 		opengl_shader_structure shader;
+		// Optional shader drawing the mesh and its wireframe in a single pass (see draw_with_wireframe)
+		//  Replaces default_shader, with an additional geometry shader computing the barycentric coordinates on each triangle
+		static opengl_shader_structure wireframe_shader;
 
 		// Texture image
 		static opengl_texture_image_structure default_texture; // default white texture shared by all mesh_drawable
@@ -40,8 +44,14 @@ namespace cgp
 
 		material_mesh_drawable_phong material;
 
+		// Sphere containing the vertices in the local coordinates of the mesh (before model), computed in initialize_data_on_gpu
+		//  Must be updated if the positions are modified afterwards (used for frustum culling)
+		bounding_sphere bounding_volume;
+
 
 		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
+		// Send the data of a memory mapped binary mesh (see mesh_map_file_obj_cached) - the buffers are filled directly from the mapped file
+		void initialize_data_on_gpu(mesh_binary_mapping const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
 		void clear();
 		void send_opengl_uniform(bool expected = true) const;
 
@@ -50,7 +60,33 @@ namespace cgp
 
 	void draw(mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
 
+	// Sphere containing the mesh in world coordinates (after model and hierarchy_transform_model)
+	bounding_sphere bounding_volume_world(mesh_drawable const& drawable);
+
 	void draw_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = {0,0,1}, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
 
+	// Draw the mesh and its wireframe in a single pass using mesh_drawable::wireframe_shader
+	//  Falls back to draw + draw_wireframe if the wireframe shader is not loaded, or if the drawable doesn't use the default shader
+	void draw_with_wireframe(mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = {0,0,1}, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+
+	// Wireframe overlay of one or several drawables (used by draw_wireframe)
+	//  The line mode is set once for the pass, and each drawable reuses its VAO and only sends its matrices and a material override.
+	//  The environment and additional uniforms are sent once per shader. The state is restored when the pass is destroyed.
+	struct mesh_drawable_wireframe_pass
+	{
+		mesh_drawable_wireframe_pass(environment_generic_structure const& environment, vec3 const& color, uniform_generic_structure const& additional_uniforms);
+		~mesh_drawable_wireframe_pass();
+		mesh_drawable_wireframe_pass(mesh_drawable_wireframe_pass const&) = delete;
+		mesh_drawable_wireframe_pass& operator=(mesh_drawable_wireframe_pass const&) = delete;
+
+		void draw(mesh_drawable const& drawable);
+
+	private:
+		environment_generic_structure const& environment;
+		uniform_generic_structure const& additional_uniforms;
+		vec3 color;
+		GLuint current_shader;
+	};
+
 
 }
@@ -0,0 +1,63 @@
+#include "test_mesh_drawable_wireframe.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../mesh_drawable.hpp"
+#include "cgp/graphics/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "cgp/graphics/opengl/debug/opengl_call_recorder/test/fake_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_mesh_drawable_wireframe()
+	{
+		// Fake default shaders (restored at the end)
+		GLuint const shader_id = mesh_drawable::default_shader.id;
+		GLuint const shader_wireframe_id = mesh_drawable::wireframe_shader.id;
+		mesh_drawable::default_shader.id = 1;
+		mesh_drawable::wireframe_shader.id = 3;
+
+		int const N = 100;
+		hierarchy_mesh_drawable hierarchy;
+		hierarchy.instancing = false;
+		hierarchy.add(fake_drawable(1, 10, 1), "root");
+		for (int k = 0; k < N - 1; ++k)
+			hierarchy.add(fake_drawable(1, 10, 1 + k % 3), "node " + str(k), "root", { float(k),0,0 });
+		hierarchy.update_local_to_global_coordinates();
+
+		opengl_call_recorder_start();
+
+		// Wireframe pass: one draw per node reusing its VAO, the program is set once and no texture is bound
+		draw_wireframe(hierarchy);
+		opengl_call_statistics const wireframe = opengl_call_recorder_statistics();
+		std::vector<opengl_draw_record> const wireframe_draws = opengl_call_recorder_draws();
+		assert_cgp_no_msg(wireframe.draw == N);
+		assert_cgp_no_msg(wireframe.use_program == 2); // set, then reset to 0 at the end of the pass
+		assert_cgp_no_msg(wireframe.bind_texture == 0);
+		for (int k = 0; k < N; ++k)
+			assert_cgp_no_msg(wireframe_draws[k].vao == hierarchy.elements[k].drawable.vao);
+
+		opengl_call_recorder_reset();
+		draw(hierarchy);
+		opengl_call_statistics const solid = opengl_call_recorder_statistics();
+		assert_cgp_no_msg(wireframe.state_change() < solid.state_change());
+
+		// Single pass with the wireframe shader
+		opengl_call_recorder_reset();
+		draw_with_wireframe(hierarchy);
+		std::vector<opengl_draw_record> const single_pass = opengl_call_recorder_draws();
+		assert_cgp_no_msg(single_pass.size() == N);
+		for (opengl_draw_record const& record : single_pass)
+			assert_cgp_no_msg(record.program == 3);
+
+		// Without the wireframe shader: solid and wireframe in two passes
+		mesh_drawable::wireframe_shader.id = 0;
+		opengl_call_recorder_reset();
+		draw_with_wireframe(hierarchy.elements[0].drawable);
+		assert_cgp_no_msg(opengl_call_recorder_statistics().draw == 2);
+
+		opengl_call_recorder_stop();
+		mesh_drawable::default_shader.id = shader_id;
+		mesh_drawable::wireframe_shader.id = shader_wireframe_id;
+	}
+}
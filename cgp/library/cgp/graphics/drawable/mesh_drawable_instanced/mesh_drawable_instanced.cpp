@@ -0,0 +1,169 @@
+#include "mesh_drawable_instanced.hpp"
+
+#include "cgp/core/base/base.hpp"
+
+#include <cstddef>
+
+namespace cgp
+{
+	opengl_shader_structure mesh_drawable_instanced::default_shader;
+
+	// Locations of the per-instance attributes (see mesh_drawable_instance_data)
+	static GLuint const instance_location_model = 4;
+	static GLuint const instance_location_model_normal = 8;
+	static GLuint const instance_location_color = 12;
+
+	static void fill_column_major(float* out, mat4 const& M)
+	{
+		for (int j = 0; j < 4; ++j)
+			for (int i = 0; i < 4; ++i)
+				out[4 * j + i] = M.at(i, j);
+	}
+
+	mesh_drawable_instance_data mesh_drawable_instance(mat4 const& model, mat4 const& model_normal, vec3 const& color)
+	{
+		mesh_drawable_instance_data data;
+		fill_column_major(data.model, model);
+		fill_column_major(data.model_normal, model_normal);
+		data.color = color;
+		return data;
+	}
+
+	// Attach the buffer of mesh_drawable_instance_data to the per-instance attributes of the VAO currently bound
+	static void enable_instance_attributes(GLuint vbo_instance)
+	{
+		GLsizei const stride = sizeof(mesh_drawable_instance_data);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo_instance); opengl_check;
+		for (GLuint k = 0; k < 4; ++k) {
+			glEnableVertexAttribArray(instance_location_model + k);
+			glVertexAttribPointer(instance_location_model + k, 4, GL_FLOAT, GL_FALSE, stride, (void const*)(offsetof(mesh_drawable_instance_data, model) + 4 * k * sizeof(float)));
+			glVertexAttribDivisor(instance_location_model + k, 1);
+
+			glEnableVertexAttribArray(instance_location_model_normal + k);
+			glVertexAttribPointer(instance_location_model_normal + k, 4, GL_FLOAT, GL_FALSE, stride, (void const*)(offsetof(mesh_drawable_instance_data, model_normal) + 4 * k * sizeof(float)));
+			glVertexAttribDivisor(instance_location_model_normal + k, 1);
+		}
+		glEnableVertexAttribArray(instance_location_color);
+		glVertexAttribPointer(instance_location_color, 3, GL_FLOAT, GL_FALSE, stride, (void const*)offsetof(mesh_drawable_instance_data, color));
+		glVertexAttribDivisor(instance_location_color, 1);
+		glBindBuffer(GL_ARRAY_BUFFER, 0); opengl_check;
+	}
+
+	static void disable_instance_attributes()
+	{
+		for (GLuint k = 0; k < 4; ++k) {
+			glDisableVertexAttribArray(instance_location_model + k);
+			glDisableVertexAttribArray(instance_location_model_normal + k);
+		}
+		glDisableVertexAttribArray(instance_location_color); opengl_check;
+	}
+
+	void mesh_drawable_instanced::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		drawable.initialize_data_on_gpu(data, shader_arg, texture_arg);
+		shader = shader_arg;
+		if (drawable.vao == 0)
+			return;
+
+		glGenBuffers(1, &vbo_instance); opengl_check;
+		glBindVertexArray(drawable.vao); opengl_check;
+		enable_instance_attributes(vbo_instance);
+		glBindVertexArray(0); opengl_check;
+		instance_count = 0;
+	}
+
+	void mesh_drawable_instanced::update_instances_on_gpu()
+	{
+		int const N = instance_transform.size();
+		assert_cgp(instance_color.size() == 0 || instance_color.size() == N, "instance_color must be empty or have the same size as instance_transform (" + str(instance_color.size()) + " colors for " + str(N) + " transforms)");
+		assert_cgp(vbo_instance != 0, "Call initialize_data_on_gpu() before update_instances_on_gpu()");
+
+		// Same matrices as mesh_drawable::send_opengl_uniform with instance_transform[k] in place of hierarchy_transform_model
+		mat4 const model_matrix = drawable.model.matrix();
+		mat4 const model_inverse = inverse(drawable.model).matrix();
+		std::vector<mesh_drawable_instance_data> data(N);
+		for (int k = 0; k < N; ++k) {
+			affine const& T = instance_transform[k];
+			vec3 const color = instance_color.size() == 0 ? vec3{ 1,1,1 } : instance_color[k];
+			data[k] = mesh_drawable_instance(T.matrix() * model_matrix, transpose(model_inverse * inverse(T).matrix()), color);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, vbo_instance); opengl_check;
+		glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(N * sizeof(mesh_drawable_instance_data)), data.data(), GL_DYNAMIC_DRAW); opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, 0); opengl_check;
+		instance_count = N;
+	}
+
+	void mesh_drawable_instanced::clear()
+	{
+		if (vbo_instance != 0)
+			glDeleteBuffers(1, &vbo_instance);
+		vbo_instance = 0;
+		instance_count = 0;
+		drawable.clear();
+		shader = opengl_shader_structure();
+		instance_transform.clear();
+		instance_color.clear();
+		opengl_check;
+	}
+
+	// Set the shader, uniforms and texture, and draw the N instances of the VAO of drawable (with the instance attributes already enabled)
+	static void draw_instances_elements(mesh_drawable const& drawable, material_mesh_drawable_phong const& material, opengl_shader_structure const& shader, int N, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		glUseProgram(shader.id); opengl_check;
+
+		material.send_opengl_uniform(shader);
+		environment.send_opengl_uniform(shader);
+		additional_uniforms.send_opengl_uniform(shader);
+
+		glActiveTexture(GL_TEXTURE0); opengl_check;
+		drawable.texture.bind();
+		opengl_uniform(shader.uniform_layout().image_texture, 0);  opengl_check;
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ebo_connectivity.id); opengl_check;
+		glDrawElementsInstanced(GL_TRIANGLES, GLsizei(drawable.ebo_connectivity.size * 3), GL_UNSIGNED_INT, nullptr, N); opengl_check;
+
+		drawable.texture.unbind();
+		glUseProgram(0);
+	}
+
+	static bool check_instanced_drawable(mesh_drawable const& drawable, opengl_shader_structure const& shader)
+	{
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+			return false;
+		assert_cgp(shader.id != 0, "Try to draw instances without instanced shader (mesh_drawable_instanced::default_shader is not loaded)");
+		assert_cgp(drawable.texture.id != 0, "Try to draw instances without texture ");
+		return true;
+	}
+
+	void draw(mesh_drawable_instanced const& instanced, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		if (instanced.instance_count == 0 || !check_instanced_drawable(instanced.drawable, instanced.shader))
+			return;
+
+		glBindVertexArray(instanced.drawable.vao); opengl_check;
+		draw_instances_elements(instanced.drawable, instanced.drawable.material, instanced.shader, instanced.instance_count, environment, additional_uniforms);
+		glBindVertexArray(0); opengl_check;
+	}
+
+	void draw_instances(mesh_drawable const& drawable, material_mesh_drawable_phong const& material, opengl_shader_structure const& shader, mesh_drawable_instance_data const* instances, int N, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		if (N == 0 || !check_instanced_drawable(drawable, shader))
+			return;
+
+		// Buffer shared by all the calls, re-allocated at each upload to avoid waiting for the previous draw
+		static GLuint vbo_stream = 0;
+		if (vbo_stream == 0) {
+			glGenBuffers(1, &vbo_stream); opengl_check;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, vbo_stream); opengl_check;
+		glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(N * sizeof(mesh_drawable_instance_data)), instances, GL_STREAM_DRAW); opengl_check;
+
+		// The instance attributes are only enabled during this draw: the VAO can still be used by mesh_drawable
+		glBindVertexArray(drawable.vao); opengl_check;
+		enable_instance_attributes(vbo_stream);
+		draw_instances_elements(drawable, material, shader, N, environment, additional_uniforms);
+		disable_instance_attributes();
+		glBindVertexArray(0); opengl_check;
+	}
+}
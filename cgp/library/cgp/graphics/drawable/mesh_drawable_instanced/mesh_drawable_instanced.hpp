@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cgp/graphics/drawable/mesh_drawable/mesh_drawable.hpp"
+
+namespace cgp
+{
+	// Per-instance data read by the instanced shaders as vertex attributes (glVertexAttribDivisor = 1)
+	//   layout (location = 4) in mat4 instance_model;        // locations 4 to 7
+	//   layout (location = 8) in mat4 instance_model_normal; // locations 8 to 11
+	//   layout (location = 12) in vec3 instance_color;
+	//  The matrices are stored column-major (OpenGL convention).
+	struct mesh_drawable_instance_data
+	{
+		float model[16];
+		float model_normal[16];
+		vec3 color;
+	};
+	// model_normal is transpose(inverse(model)), similar to the uniforms sent by mesh_drawable
+	mesh_drawable_instance_data mesh_drawable_instance(mat4 const& model, mat4 const& model_normal, vec3 const& color = { 1,1,1 });
+
+
+	// Set of instances of the same mesh drawn with a single call to glDrawElementsInstanced
+	//  The geometry (VBO/EBO/VAO), texture and material are shared. Each instance has its own transform and color.
+	//  Usage:
+	//    instanced.initialize_data_on_gpu(mesh);
+	//    instanced.instance_transform = ... ; instanced.instance_color = ... ;
+	//    instanced.update_instances_on_gpu(); // after each modification of the instances
+	//    draw(instanced, environment);
+	struct mesh_drawable_instanced
+	{
+		// Shader reading the per-instance attributes (ex. shaders/mesh_instanced/vert.glsl of the scenes)
+		static opengl_shader_structure default_shader;
+		opengl_shader_structure shader;
+
+		// Shared geometry, texture and material (the shader of the drawable is not used)
+		mesh_drawable drawable;
+
+		// The model matrix of the instance k is instance_transform[k] * drawable.model
+		numarray<affine> instance_transform;
+		// Color of each instance multiplied by the material color (optional: white if empty)
+		numarray<vec3> instance_color;
+
+		// Buffer of mesh_drawable_instance_data attached to the VAO of the drawable
+		GLuint vbo_instance = 0;
+		int instance_count = 0; // Number of instances sent by the last update_instances_on_gpu()
+
+		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture);
+		void update_instances_on_gpu();
+		void clear();
+	};
+
+	void draw(mesh_drawable_instanced const& instanced, environment_generic_structure const& environment = environment_generic_structure(), uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+
+	// Draw N instances of the geometry and texture of drawable with the given material and instanced shader
+	//  The instance data is streamed at each call through a buffer shared by all the calls (ex. instances changing at every frame)
+	void draw_instances(mesh_drawable const& drawable, material_mesh_drawable_phong const& material, opengl_shader_structure const& shader, mesh_drawable_instance_data const* instances, int N, environment_generic_structure const& environment = environment_generic_structure(), uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+}
@@ -0,0 +1,95 @@
+#include "test_mesh_drawable_instanced.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../mesh_drawable_instanced.hpp"
+#include "cgp/graphics/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "cgp/graphics/opengl/debug/opengl_call_recorder/test/fake_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_mesh_drawable_instanced()
+	{
+		// Instance data: column-major matrices
+		{
+			affine_rts const T(rotation_transform::from_axis_angle({ 0,0,1 }, 0.5f), { 1,2,3 }, 2.0f);
+			mat4 const M = T.matrix();
+			mesh_drawable_instance_data const data = mesh_drawable_instance(M, transpose(inverse(T).matrix()), { 1,0,0 });
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 4; ++j)
+					assert_cgp_no_msg(is_equal(data.model[4 * j + i], M(i, j)));
+			assert_cgp_no_msg(is_equal(vec3(data.model[12], data.model[13], data.model[14]), vec3(1, 2, 3)));
+		}
+
+		// Fake default shaders (restored at the end)
+		GLuint const shader_id = mesh_drawable::default_shader.id;
+		GLuint const shader_instanced_id = mesh_drawable_instanced::default_shader.id;
+		mesh_drawable::default_shader.id = 1;
+		mesh_drawable_instanced::default_shader.id = 2;
+
+		// 10k copies of a prop, 6 tubes, and 2 different wings
+		int const N_prop = 10000;
+		hierarchy_mesh_drawable hierarchy;
+		hierarchy.instancing = true;
+		mesh_drawable prop = fake_drawable(1, 10, 1);
+		prop.material.color = { 1,0,0 };
+		mesh_drawable tube = fake_drawable(1, 10, 2);
+		tube.material.color = { 0,1,0 };
+		hierarchy.add(fake_drawable(1, 10, 1), "root");
+		for (int k = 0; k < N_prop - 1; ++k)
+			hierarchy.add(prop, "prop " + str(k), "root", { float(k),0,0 });
+		for (int k = 0; k < 6; ++k)
+			hierarchy.add(tube, "tube " + str(k), "root");
+		mesh_drawable wing = fake_drawable(1, 10, 3);
+		hierarchy.add(wing, "wing up", "root");
+		wing.material.phong.specular = 0.0f;
+		hierarchy.add(wing, "wing low", "root");
+		hierarchy.update_local_to_global_coordinates();
+
+		opengl_call_recorder_start();
+
+		draw(hierarchy);
+		std::vector<opengl_draw_record> const draws_instanced = opengl_call_recorder_draws();
+
+		// The groups are kept by an update without modification of the meshes or materials
+		std::vector<int> const order = hierarchy.instancing_order;
+		std::vector<int> const offset = hierarchy.instancing_offset;
+		hierarchy["prop 3"].transform_local.translation = { 0,1,0 };
+		hierarchy.update_local_to_global_coordinates();
+		assert_cgp_no_msg(hierarchy.instancing_order == order && hierarchy.instancing_offset == offset);
+
+		// A material modified after the update is not drawn with the previous groups
+		hierarchy["wing low"].drawable.material.phong.specular = 0.3f;
+		opengl_call_recorder_reset();
+		draw(hierarchy);
+		assert_cgp_no_msg(opengl_call_recorder_statistics().draw == N_prop + 6 + 2);
+
+		// The update rebuilds the groups: the two wings now share the same material
+		hierarchy.update_local_to_global_coordinates();
+		assert_cgp_no_msg(hierarchy.instancing_offset.size() == 4);
+		opengl_call_recorder_reset();
+		draw(hierarchy);
+		assert_cgp_no_msg(opengl_call_recorder_draws().size() == 3);
+
+		opengl_call_recorder_reset();
+		hierarchy.instancing = false;
+		draw(hierarchy);
+		int const draws_direct = opengl_call_recorder_statistics().draw;
+
+		opengl_call_recorder_stop();
+		mesh_drawable::default_shader.id = shader_id;
+		mesh_drawable_instanced::default_shader.id = shader_instanced_id;
+
+		// One instanced call for the props, one for the tubes, and the wings with different materials are drawn separately
+		assert_cgp_no_msg(draws_direct == N_prop + 6 + 2);
+		assert_cgp_no_msg(draws_instanced.size() == 4);
+		int instance_count = 0;
+		for (opengl_draw_record const& record : draws_instanced) {
+			instance_count += record.instance_count;
+			if (record.instance_count > 1)
+				assert_cgp_no_msg(record.program == 2);
+		}
+		assert_cgp_no_msg(instance_count == N_prop + 6 + 2);
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Headless test using opengl_call_recorder: nodes of a hierarchy sharing the same mesh are drawn with a single instanced call
+	void test_mesh_drawable_instanced();
+}
@@ -0,0 +1,148 @@
+#include "render_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace cgp
+{
+	void render_queue::push_back(mesh_drawable const& drawable, uniform_generic_structure const* additional_uniforms)
+	{
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0)
+			return;
+
+		render_queue_item item;
+		item.drawable = &drawable;
+		item.additional_uniforms = additional_uniforms;
+		items.push_back(item);
+	}
+
+	void render_queue::push_back(hierarchy_mesh_drawable const& hierarchy)
+	{
+		// The elements culled by hierarchy.update_visibility() are skipped, as in draw(hierarchy_mesh_drawable)
+		int const N = int(hierarchy.elements.size());
+		for (int k = 0; k < N; ++k)
+			if (hierarchy.is_drawn(k))
+				push_back(hierarchy.elements[k].drawable);
+	}
+
+	void render_queue::clear()
+	{
+		items.clear();
+	}
+
+	int render_queue::size() const
+	{
+		return int(items.size());
+	}
+
+	void render_queue::sort()
+	{
+		std::stable_sort(items.begin(), items.end(), [](render_queue_item const& a, render_queue_item const& b) {
+			mesh_drawable const& da = *a.drawable;
+			mesh_drawable const& db = *b.drawable;
+			if (da.shader.id != db.shader.id)
+				return da.shader.id < db.shader.id;
+			if (da.texture.id != db.texture.id)
+				return da.texture.id < db.texture.id;
+			return da.vao < db.vao;
+		});
+	}
+
+	static void record_binding(std::vector<std::pair<int, GLenum> >& bound_units, int unit, GLenum texture_type)
+	{
+		std::pair<int, GLenum> const binding(unit, texture_type);
+		if (std::find(bound_units.begin(), bound_units.end(), binding) == bound_units.end())
+			bound_units.push_back(binding);
+	}
+
+	void draw(render_queue& queue, environment_generic_structure const& environment, uniform_generic_structure const& additional_uniforms)
+	{
+		if (queue.items.size() == 0)
+			return;
+		queue.sort();
+
+		// Currently bound state (0: unknown or unbound)
+		GLuint program = 0;
+		GLuint vao = 0;
+		GLuint ebo = 0;
+		opengl_texture_image_structure const* texture = nullptr;
+		int active_texture_unit = -1;
+		// (unit, texture type) of all the bindings done by the queue, to be reset at the end
+		std::vector<std::pair<int, GLenum> > bound_units;
+
+		for (render_queue_item const& item : queue.items)
+		{
+			mesh_drawable const& drawable = *item.drawable;
+			assert_cgp(drawable.shader.id != 0, "Try to draw mesh_drawable without shader ");
+			assert_cgp(!glIsShader(drawable.shader.id), "Try to draw mesh_drawable with incorrect shader ");
+			assert_cgp(drawable.texture.id != 0, "Try to draw mesh_drawable without texture ");
+
+			// Program and uniforms shared by all the drawables using it
+			// ********************************** //
+			if (drawable.shader.id != program) {
+				program = drawable.shader.id;
+				glUseProgram(program); opengl_check;
+				environment.send_opengl_uniform(drawable.shader);
+				additional_uniforms.send_opengl_uniform(drawable.shader);
+				opengl_uniform(drawable.shader.uniform_layout().image_texture, 0);  opengl_check;
+			}
+
+			// Uniforms of the drawable
+			// ********************************** //
+			drawable.send_opengl_uniform();
+			if (item.additional_uniforms != nullptr)
+				item.additional_uniforms->send_opengl_uniform(drawable.shader);
+
+			// Textures
+			// ********************************** //
+			if (texture == nullptr || texture->id != drawable.texture.id || texture->texture_type != drawable.texture.texture_type) {
+				if (active_texture_unit != 0) {
+					glActiveTexture(GL_TEXTURE0); opengl_check;
+					active_texture_unit = 0;
+				}
+				drawable.texture.bind();
+				texture = &drawable.texture;
+				record_binding(bound_units, 0, texture->texture_type);
+			}
+
+			// The supplementary textures are specific to each drawable and always bound
+			int texture_count = 1;
+			for (auto const& element : drawable.supplementary_texture)
+			{
+				glActiveTexture(GL_TEXTURE0 + texture_count); opengl_check;
+				element.second.bind();
+				record_binding(bound_units, texture_count, element.second.texture_type);
+				opengl_uniform(drawable.shader, element.first, texture_count);
+				active_texture_unit = texture_count;
+				texture_count++;
+			}
+
+			// VAO and connectivity
+			// ********************************** //
+			if (drawable.vao != vao) {
+				vao = drawable.vao;
+				glBindVertexArray(vao); opengl_check;
+				ebo = 0;
+			}
+			if (drawable.ebo_connectivity.id != ebo) {
+				ebo = drawable.ebo_connectivity.id;
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); opengl_check;
+			}
+
+			// Draw call
+			// ********************************** //
+			glDrawElements(GL_TRIANGLES, GLsizei(drawable.ebo_connectivity.size * 3), GL_UNSIGNED_INT, nullptr); opengl_check;
+		}
+
+		// Clean state
+		// ********************************** //
+		glBindVertexArray(0);
+		// Unbind the textures of every unit used by the queue, then restore the unit 0 as the active unit
+		for (std::pair<int, GLenum> const& binding : bound_units) {
+			glActiveTexture(GL_TEXTURE0 + binding.first); opengl_check;
+			glBindTexture(binding.second, 0); opengl_check;
+		}
+		glActiveTexture(GL_TEXTURE0); opengl_check;
+		glUseProgram(0);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "cgp/graphics/drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/graphics/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	struct render_queue_item
+	{
+		mesh_drawable const* drawable = nullptr;
+		uniform_generic_structure const* additional_uniforms = nullptr; // Optional uniforms specific to this drawable
+	};
+
+	// Set of mesh_drawable drawn together with a minimal number of OpenGL state changes
+	//  The items are sorted by shader, texture and VAO. The program, texture and VAO are only bound when they change,
+	//  and the environment is sent once per program instead of once per drawable.
+	//  The queue stores pointers: the drawables must remain valid (and not be moved) until the draw.
+	//  Usage (at each frame):
+	//    queue.clear();
+	//    queue.push_back(drawable_1); queue.push_back(hierarchy); ...
+	//    draw(queue, environment);
+	struct render_queue
+	{
+		std::vector<render_queue_item> items;
+
+		// Drawables without vertex or triangle are ignored (same as draw(mesh_drawable))
+		void push_back(mesh_drawable const& drawable, uniform_generic_structure const* additional_uniforms = nullptr);
+		// Only the elements of the hierarchy that are not culled are added (see hierarchy_mesh_drawable::update_visibility)
+		void push_back(hierarchy_mesh_drawable const& hierarchy);
+		void clear();
+		int size() const;
+
+		// Sort the items by shader, texture and VAO (keep the insertion order of identical states)
+		void sort();
+	};
+
+	// Sort and draw all the items of the queue
+	//  The environment and additional_uniforms are sent once per program: they should not set the uniforms of the drawables (model, material)
+	void draw(render_queue& queue, environment_generic_structure const& environment = environment_generic_structure(), uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+}
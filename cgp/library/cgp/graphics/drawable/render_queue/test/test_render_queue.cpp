@@ -0,0 +1,103 @@
+#include "test_render_queue.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../render_queue.hpp"
+#include "cgp/graphics/opengl/debug/opengl_call_recorder/test/fake_drawable.hpp"
+
+#include <algorithm>
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	namespace
+	{
+		struct environment_test : environment_generic_structure
+		{
+			mat4 projection;
+			mat4 view;
+			vec3 light;
+
+			void send_opengl_uniform(opengl_shader_structure const& shader, bool expected = true) const override
+			{
+				opengl_uniform(shader, "projection", projection, expected);
+				opengl_uniform(shader, "view", view, expected);
+				opengl_uniform(shader, "light", light, expected);
+			}
+		};
+	}
+
+	void test_render_queue()
+	{
+		// 3 shaders, 4 textures, 60 drawables (the last ones share the VAO of the first ones)
+		std::vector<mesh_drawable> drawables;
+		for (int k = 0; k < 60; ++k)
+			drawables.push_back(fake_drawable(1 + (k * 7) % 3, 10 + (k * 5) % 4, 100 + k % 45));
+		drawables.push_back(mesh_drawable()); // empty drawable: ignored
+		environment_test environment;
+
+		opengl_call_recorder_start();
+
+		for (mesh_drawable const& drawable : drawables)
+			draw(drawable, environment);
+		std::vector<opengl_draw_record> draws_direct = opengl_call_recorder_draws();
+		opengl_call_statistics const direct = opengl_call_recorder_statistics();
+
+		opengl_call_recorder_reset();
+		render_queue queue;
+		for (mesh_drawable const& drawable : drawables)
+			queue.push_back(drawable);
+		draw(queue, environment);
+		std::vector<opengl_draw_record> draws_queue = opengl_call_recorder_draws();
+		opengl_call_statistics const queued = opengl_call_recorder_statistics();
+
+		opengl_call_recorder_stop();
+
+		// Same draw calls with the same state
+		assert_cgp_no_msg(queue.size() == 60);
+		assert_cgp_no_msg(draws_direct.size() == 60 && draws_queue.size() == 60);
+		std::sort(draws_direct.begin(), draws_direct.end());
+		std::sort(draws_queue.begin(), draws_queue.end());
+		assert_cgp_no_msg(draws_direct == draws_queue);
+
+		// One program change per shader (+ final reset), and the environment is sent once per shader
+		assert_cgp_no_msg(queued.use_program == 3 + 1);
+		assert_cgp_no_msg(direct.use_program == 2 * 60);
+		assert_cgp_no_msg(queued.uniform == direct.uniform - (60 - 3) * 4);
+		assert_cgp_no_msg(queued.state_change() < direct.state_change() / 2);
+
+		// Items sorted by shader, then texture
+		for (int k = 1; k < queue.size(); ++k) {
+			mesh_drawable const& a = *queue.items[k - 1].drawable;
+			mesh_drawable const& b = *queue.items[k].drawable;
+			assert_cgp_no_msg(a.shader.id < b.shader.id || (a.shader.id == b.shader.id && a.texture.id <= b.texture.id));
+		}
+
+		// Supplementary textures: every unit bound by the queue is reset at the end, and the unit 0 is active
+		{
+			mesh_drawable a = fake_drawable(1, 10, 100);
+			mesh_drawable b = fake_drawable(2, 11, 101);
+			opengl_texture_image_structure supplementary;
+			supplementary.texture_type = GL_TEXTURE_2D;
+			supplementary.id = 50;
+			a.supplementary_texture["first"] = supplementary;
+			supplementary.id = 51;
+			a.supplementary_texture["second"] = supplementary;
+			supplementary.id = 52;
+			supplementary.texture_type = GL_TEXTURE_CUBE_MAP;
+			b.supplementary_texture["first"] = supplementary;
+
+			render_queue queue_supplementary;
+			queue_supplementary.push_back(a);
+			queue_supplementary.push_back(b);
+
+			opengl_call_recorder_start();
+			draw(queue_supplementary, environment);
+			assert_cgp_no_msg(opengl_call_recorder_draws().size() == 2);
+			for (int unit = 0; unit < 3; ++unit)
+				assert_cgp_no_msg(opengl_call_recorder_bound_texture(unit) == 0);
+			assert_cgp_no_msg(opengl_call_recorder_active_texture_unit() == 0);
+			opengl_call_recorder_stop();
+		}
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Headless test using opengl_call_recorder: the render queue issues the same draw calls as individual draws with fewer state changes
+	void test_render_queue();
+}
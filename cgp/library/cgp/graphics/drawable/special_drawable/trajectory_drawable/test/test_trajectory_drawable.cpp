@@ -0,0 +1,115 @@
+#include "test_trajectory_drawable.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "../trajectory_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// Positions drawn for the trajectory from its ranges: the ranges are joined by the copy of the slot 0
+	static std::vector<vec3> drawn_positions(trajectory_batch_drawable const& drawable, GLint const* first, GLsizei const* count, int N_range)
+	{
+		std::vector<vec3> positions;
+		for (int r = 0; r < N_range; ++r) {
+			for (int k = 0; k < count[r]; ++k) {
+				vec3 const& p = drawable.position_record[first[r] + k];
+				if (k == 0 && r > 0 && is_equal(p, positions.back()))
+					continue;
+				positions.push_back(p);
+			}
+		}
+		return positions;
+	}
+
+	void test_trajectory_drawable()
+	{
+		// Ring buffer of N=5 slots (+1 copy) starting at the slot 10
+		{
+			GLint first[2] = { -1,-1 };
+			GLsizei count[2] = { -1,-1 };
+			assert_cgp_no_msg(ring_buffer_ranges(10, 1, 1, 5, first, count) == 0);
+
+			// Not full
+			assert_cgp_no_msg(ring_buffer_ranges(10, 3, 3, 5, first, count) == 1);
+			assert_cgp_no_msg(first[0] == 10 && count[0] == 3);
+
+			// Full, the most recent sample in the last slot
+			assert_cgp_no_msg(ring_buffer_ranges(10, 0, 5, 5, first, count) == 1);
+			assert_cgp_no_msg(first[0] == 10 && count[0] == 5);
+
+			// Full, the most recent sample in the slot 0: drawn from its copy at the end of the ring
+			assert_cgp_no_msg(ring_buffer_ranges(10, 1, 5, 5, first, count) == 1);
+			assert_cgp_no_msg(first[0] == 11 && count[0] == 5);
+
+			// Full, wrapping: oldest samples [3,5[ followed by the copy of the slot 0, then [0,3[
+			assert_cgp_no_msg(ring_buffer_ranges(10, 3, 5, 5, first, count) == 2);
+			assert_cgp_no_msg(first[0] == 13 && count[0] == 3);
+			assert_cgp_no_msg(first[1] == 10 && count[1] == 3);
+		}
+
+		// Batch of trajectories with different numbers of samples, drawn with a single multi-draw call
+		GLuint const shader_id = curve_drawable::default_shader.id;
+		curve_drawable::default_shader.id = 1;
+		opengl_call_recorder_start();
+
+		int const N_trajectory = 8;
+		int const N_max_sample = 7;
+		trajectory_batch_drawable batch(N_trajectory, N_max_sample);
+		for (int k = 0; k < N_trajectory; ++k)
+			for (int i = 0; i < 3 * k + 1; ++i)
+				batch.add(k, { float(k), float(i), rand_interval() });
+		batch.clear_trajectory(5);
+		batch.add(5, { 5,0,0 });
+		batch.add(5, { 5,1,0 });
+		batch.update_data_on_gpu();
+
+		// The ranges of each trajectory are stored one after the other, and join the samples from the oldest to the most recent one
+		int r = 0;
+		for (int k = 0; k < N_trajectory; ++k) {
+			GLint first[2];
+			GLsizei count[2];
+			int const offset = k * (N_max_sample + 1);
+			int const N_range_k = ring_buffer_ranges(offset, batch.next_slot[k], batch.current_size[k], N_max_sample, first, count);
+			for (int i = 0; i < N_range_k; ++i) {
+				assert_cgp_no_msg(batch.range_first[r + i] == first[i] && batch.range_count[r + i] == count[i]);
+				assert_cgp_no_msg(first[i] >= offset && first[i] + count[i] <= offset + N_max_sample + 1);
+			}
+			r += N_range_k;
+
+			std::vector<vec3> const positions = drawn_positions(batch, first, count, N_range_k);
+			int const N_sample = batch.current_size[k];
+			assert_cgp_no_msg(int(positions.size()) == (N_sample < 2 ? 0 : N_sample));
+			for (int i = 0; i < int(positions.size()); ++i)
+				assert_cgp_no_msg(is_equal(positions[i], batch.sample(k, N_sample - 1 - i)));
+		}
+		assert_cgp_no_msg(batch.N_range == r);
+
+		opengl_call_recorder_reset();
+		draw(batch, environment_generic_structure());
+		std::vector<opengl_draw_record> const draws = opengl_call_recorder_draws();
+		assert_cgp_no_msg(int(draws.size()) == batch.N_range);
+		for (int i = 0; i < batch.N_range; ++i)
+			assert_cgp_no_msg(draws[i].count == batch.range_count[i]);
+
+		// The arrays of ranges are not reallocated by the next updates
+		GLint const* range_first_data = batch.range_first.data.data();
+		for (int i = 0; i < 10; ++i) {
+			for (int k = 0; k < N_trajectory; ++k)
+				batch.add(k, { 0,0,float(i) });
+			batch.update_data_on_gpu();
+		}
+		assert_cgp_no_msg(batch.range_first.data.data() == range_first_data);
+		assert_cgp_no_msg(batch.N_range > N_trajectory);
+
+		batch.max_update_call = 1;
+		batch.add(0, { 1,1,1 });
+		batch.add(4, { 1,1,1 });
+		batch.update_data_on_gpu();
+		assert_cgp_no_msg(is_equal(batch.sample(4, 0), vec3(1, 1, 1)));
+
+		batch.clear();
+		opengl_call_recorder_stop();
+		curve_drawable::default_shader.id = shader_id;
+	}
+}
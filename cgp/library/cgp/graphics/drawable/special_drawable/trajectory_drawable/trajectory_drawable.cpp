@@ -1,9 +1,33 @@
 #include "trajectory_drawable.hpp"
 
+#include <algorithm>
+
 namespace cgp
 {
-	trajectory_drawable::trajectory_drawable(size_t N_max_sample_arg)
-		:position_record(), visual(), N_max_sample(N_max_sample_arg), current_size(0)
+	int ring_buffer_ranges(int offset, int next_slot, int current_size, int N, GLint* first, GLsizei* count)
+	{
+		if (current_size < 2)
+			return 0;
+
+		// The ring is not full or ends exactly at its last slot
+		if (current_size < N || next_slot == 0) {
+			first[0] = offset;
+			count[0] = current_size;
+			return 1;
+		}
+
+		// Oldest samples [next_slot, N[ followed by the copy of the slot 0, then the most recent samples [0, next_slot[
+		first[0] = offset + next_slot;
+		count[0] = N + 1 - next_slot;
+		if (next_slot < 2)
+			return 1;
+		first[1] = offset;
+		count[1] = next_slot;
+		return 2;
+	}
+
+	trajectory_drawable::trajectory_drawable(size_t N_max_sample_arg, trajectory_drawable_mode mode_arg)
+		:position_record(), visual(), N_max_sample(N_max_sample_arg), current_size(0), mode(mode_arg), next_slot(0)
 	{}
 
 	void trajectory_drawable::clear()
@@ -11,36 +35,197 @@ namespace cgp
 		position_record.clear();
 		visual.clear();
 		current_size = 0;
+		next_slot = 0;
 	}
 	void trajectory_drawable::add(vec3 const& position)
 	{
+		size_t const N_slot = mode == trajectory_drawable_mode::ring_buffer ? N_max_sample + 1 : N_max_sample;
 
 		// Initialize if needed
 		if (position_record.size() == 0) {
 			assert_cgp_no_msg(current_size == 0);
 			assert_cgp_no_msg(visual.vbo_position.id == 0);
 
-			position_record.resize(N_max_sample);
+			position_record.resize(N_slot);
 			visual.initialize_data_on_gpu(position_record);
 		}
-		assert_cgp_no_msg(position_record.size() == N_max_sample);
-
-		for (size_t k = N_max_sample - 1; k > 0; --k) {
-			position_record[k] = position_record[k - 1];
-		}
-		position_record[0] = position;
+		assert_cgp_no_msg(position_record.size() == N_slot);
 
 		if (current_size < N_max_sample)
 			current_size++;
 
-		visual.vbo_position.update(position_record);
+		if (mode == trajectory_drawable_mode::shift) {
+			for (size_t k = N_max_sample - 1; k > 0; --k) {
+				position_record[k] = position_record[k - 1];
+			}
+			position_record[0] = position;
+
+			visual.vbo_position.update(position_record);
+			return;
+		}
+
+		// Ring buffer: only the written slot is sent to the GPU
+		int const slot = int(next_slot);
+		position_record[slot] = position;
+		visual.vbo_position.update(&position_record[slot], 1, slot);
+		if (slot == 0) {
+			position_record[N_max_sample] = position;
+			visual.vbo_position.update(&position_record[N_max_sample], 1, int(N_max_sample));
+		}
+		next_slot = (next_slot + 1) % N_max_sample;
+	}
 
+	vec3 const& trajectory_drawable::sample(size_t k) const
+	{
+		assert_cgp(k < current_size, "Sample " + str(k) + " of a trajectory with " + str(current_size) + " samples");
+		if (mode == trajectory_drawable_mode::shift)
+			return position_record[k];
+		return position_record[(next_slot + N_max_sample - 1 - k) % N_max_sample];
 	}
 
 	void draw(trajectory_drawable const& drawable, environment_generic_structure const& environment)
 	{
-		if (drawable.current_size > 0) {
-			draw(drawable.visual, environment);
+		if (drawable.current_size == 0)
+			return;
+
+		GLint first[2] = { 0, 0 };
+		GLsizei count[2] = { GLsizei(drawable.current_size), 0 };
+		int N_range = 1;
+		if (drawable.mode == trajectory_drawable_mode::ring_buffer)
+			N_range = ring_buffer_ranges(0, int(drawable.next_slot), int(drawable.current_size), int(drawable.N_max_sample), first, count);
+
+		draw(drawable.visual, environment, first, count, N_range);
+	}
+
+
+
+	trajectory_batch_drawable::trajectory_batch_drawable(int N_trajectory_arg, int N_max_sample_arg)
+		:position_record(), next_slot(), current_size(), modified_slot(), visual(), N_trajectory(N_trajectory_arg), N_max_sample(N_max_sample_arg),
+		range_first(), range_count(), N_range(-1), max_update_call(64)
+	{
+		assert_cgp(N_trajectory >= 0 && N_max_sample > 0, "Invalid trajectory_batch_drawable with " + str(N_trajectory) + " trajectories of " + str(N_max_sample) + " samples");
+	}
+
+	int trajectory_batch_drawable::size() const
+	{
+		return N_trajectory;
+	}
+
+	void trajectory_batch_drawable::clear()
+	{
+		position_record.clear();
+		next_slot.clear();
+		current_size.clear();
+		modified_slot.clear();
+		range_first.clear();
+		range_count.clear();
+		N_range = -1;
+		if (visual.vao != 0)
+			visual.clear();
+	}
+
+	void trajectory_batch_drawable::clear_trajectory(int trajectory)
+	{
+		assert_cgp(trajectory >= 0 && trajectory < N_trajectory, "Trajectory " + str(trajectory) + " out of a batch of " + str(N_trajectory));
+		if (current_size.size() == 0)
+			return;
+		next_slot[trajectory] = 0;
+		current_size[trajectory] = 0;
+		N_range = -1;
+	}
+
+	void trajectory_batch_drawable::add(int trajectory, vec3 const& position)
+	{
+		assert_cgp(trajectory >= 0 && trajectory < N_trajectory, "Trajectory " + str(trajectory) + " out of a batch of " + str(N_trajectory));
+
+		// Initialize the CPU storage if needed (the VBO is created at the first call to update_data_on_gpu)
+		if (position_record.size() == 0) {
+			position_record.resize(N_trajectory * (N_max_sample + 1));
+			next_slot.resize(N_trajectory);
+			current_size.resize(N_trajectory);
+		}
+
+		int const offset = trajectory * (N_max_sample + 1);
+		int const slot = next_slot[trajectory];
+		position_record[offset + slot] = position;
+		modified_slot.push_back(offset + slot);
+		if (slot == 0) {
+			position_record[offset + N_max_sample] = position;
+			modified_slot.push_back(offset + N_max_sample);
+		}
+
+		next_slot[trajectory] = (slot + 1) % N_max_sample;
+		if (current_size[trajectory] < N_max_sample)
+			current_size[trajectory]++;
+	}
+
+	// Ranges of all the trajectories stored contiguously in range_first and range_count
+	static void update_ranges(trajectory_batch_drawable& drawable)
+	{
+		int const N_trajectory = drawable.current_size.size();
+		drawable.range_first.resize(2 * N_trajectory);
+		drawable.range_count.resize(2 * N_trajectory);
+
+		int N_range = 0;
+		for (int k = 0; k < N_trajectory; ++k)
+			N_range += ring_buffer_ranges(k * (drawable.N_max_sample + 1), drawable.next_slot[k], drawable.current_size[k], drawable.N_max_sample, &drawable.range_first[N_range], &drawable.range_count[N_range]);
+		drawable.N_range = N_range;
+	}
+
+	void trajectory_batch_drawable::update_data_on_gpu()
+	{
+		if (position_record.size() == 0)
+			return;
+		update_ranges(*this);
+
+		if (visual.vbo_position.id == 0) {
+			visual.initialize_data_on_gpu(position_record);
+			modified_slot.clear();
+			return;
+		}
+		if (modified_slot.size() == 0)
+			return;
+
+		std::sort(modified_slot.begin(), modified_slot.end());
+		int const N = modified_slot.size();
+		int N_run = 1;
+		for (int k = 1; k < N; ++k)
+			if (modified_slot.at(k) > modified_slot.at(k - 1) + 1)
+				N_run++;
+
+		if (N_run > max_update_call) {
+			int const first = modified_slot.at(0);
+			int const last = modified_slot.at(N - 1);
+			visual.vbo_position.update(&position_record[first], last - first + 1, first);
+		}
+		else {
+			int run_start = 0;
+			for (int k = 1; k <= N; ++k) {
+				if (k == N || modified_slot.at(k) > modified_slot.at(k - 1) + 1) {
+					int const first = modified_slot.at(run_start);
+					int const last = modified_slot.at(k - 1);
+					visual.vbo_position.update(&position_record[first], last - first + 1, first);
+					run_start = k;
+				}
+			}
 		}
+		modified_slot.clear();
+	}
+
+	vec3 const& trajectory_batch_drawable::sample(int trajectory, int k) const
+	{
+		assert_cgp(trajectory >= 0 && trajectory < N_trajectory, "Trajectory " + str(trajectory) + " out of a batch of " + str(N_trajectory));
+		assert_cgp(current_size.size() > 0 && k >= 0 && k < current_size[trajectory], "Sample " + str(k) + " out of the trajectory " + str(trajectory));
+		int const offset = trajectory * (N_max_sample + 1);
+		return position_record[offset + (next_slot[trajectory] + N_max_sample - 1 - k) % N_max_sample];
+	}
+
+	void draw(trajectory_batch_drawable const& drawable, environment_generic_structure const& environment)
+	{
+		if (drawable.visual.vbo_position.id == 0)
+			return;
+		assert_cgp(drawable.modified_slot.size() == 0 && drawable.N_range >= 0, "Samples added to (or cleared from) trajectory_batch_drawable without a call to update_data_on_gpu() before draw");
+
+		draw(drawable.visual, environment, drawable.range_first.data.data(), drawable.range_count.data.data(), drawable.N_range);
 	}
-}
\ No newline at end of file
+}
@@ -1,21 +1,78 @@
+#pragma once
+
 #include "cgp/graphics/drawable/curve_drawable/curve_drawable.hpp"
 
 namespace cgp
 {
+	// Storage of the samples
+	//  - ring_buffer: a new sample overwrites the oldest slot of a ring buffer, and only this slot is sent to the GPU
+	//  - shift: position_record[0] is the most recent sample, the entire buffer is shifted and sent to the GPU for every new sample
+	enum class trajectory_drawable_mode { ring_buffer, shift };
+
+	// Ranges of slots of a ring buffer drawn as a line strip from the oldest to the most recent sample (see trajectory_drawable in ring_buffer mode)
+	//  The ring starts at the slot "offset" and has N+1 slots, the last one being a copy of the first one.
+	//  Fill first[] and count[] (at most 2 ranges) and returns the number of ranges.
+	int ring_buffer_ranges(int offset, int next_slot, int current_size, int N, GLint* first, GLsizei* count);
+
 	struct trajectory_drawable
 	{
-		trajectory_drawable(size_t N_max_sample = 100);
+		trajectory_drawable(size_t N_max_sample = 100, trajectory_drawable_mode mode = trajectory_drawable_mode::ring_buffer);
 		void clear();
 		void add(vec3 const& position);
 
+		// The k-th most recent sample (k=0 is the last added position) - k < current_size
+		vec3 const& sample(size_t k) const;
+
 
+		// In ring_buffer mode: N_max_sample slots, followed by a copy of the slot 0 linking the two drawn ranges
 		numarray<vec3> position_record;
 		curve_drawable visual;
 		size_t N_max_sample;
 		size_t current_size;
+		trajectory_drawable_mode mode;
+		size_t next_slot; // Slot written by the next call to add() in ring_buffer mode
 
 	};
 
 
 	void draw(trajectory_drawable const& drawable, environment_generic_structure const& environment);
-}
\ No newline at end of file
+
+
+	// Set of trajectories sharing a single VBO and drawn with a single draw call
+	//  - Each trajectory is a ring buffer of N_max_sample slots (same layout as trajectory_drawable in ring_buffer mode)
+	//  - add() only stores the sample on the CPU: call update_data_on_gpu() once all the samples of the frame are added
+	struct trajectory_batch_drawable
+	{
+		trajectory_batch_drawable(int N_trajectory = 0, int N_max_sample = 100);
+		void clear();
+		// Remove the samples of a single trajectory (ex. when a particle is re-emitted)
+		void clear_trajectory(int trajectory);
+		void add(int trajectory, vec3 const& position);
+		// Send the slots modified since the last call to the GPU (initialize the VBO at the first call), and update the drawn ranges
+		//  Must also be called after clear_trajectory() before the next draw
+		void update_data_on_gpu();
+
+		vec3 const& sample(int trajectory, int k) const;
+		int size() const;
+
+
+		numarray<vec3> position_record; // N_trajectory blocks of N_max_sample+1 slots
+		numarray<int> next_slot;
+		numarray<int> current_size;
+		numarray<int> modified_slot;    // Slots to send to the GPU at the next update_data_on_gpu()
+		curve_drawable visual;
+		int N_trajectory;
+		int N_max_sample;
+
+		// Ranges of the VBO drawn in a single call (see ring_buffer_ranges), computed by update_data_on_gpu()
+		//  The arrays have 2*N_trajectory elements and are allocated once. N_range is -1 if the ranges must be updated.
+		numarray<GLint> range_first;
+		numarray<GLsizei> range_count;
+		int N_range;
+
+		// Above this number of contiguous modified ranges, the span between the first and last modified slots is sent in one call
+		int max_update_call;
+	};
+
+	void draw(trajectory_batch_drawable const& drawable, environment_generic_structure const& environment);
+}
@@ -10,6 +10,7 @@ namespace cgp
 	struct opengl_ebo_structure : opengl_gpu_buffer
 	{
 		void initialize_data_on_gpu(numarray<uint3> const& data);
+		void initialize_data_on_gpu(uint3 const* data, int N);
 	};
 
 
@@ -4,47 +4,54 @@
 
 namespace cgp
 {
-	template <int N>
-	static GLuint opengl_buffer_data_initialize_generic(numarray<numarray_stack<float,N> > const& data, GLuint buffer_type, GLenum draw_type)
+	static GLuint opengl_buffer_data_initialize_generic(void const* data, size_t size_byte, GLuint buffer_type, GLenum draw_type)
 	{
 		GLuint vbo_index;
-		glGenBuffers(1, &vbo_index);                                                       opengl_check;
-		glBindBuffer(buffer_type, vbo_index);                                              opengl_check;
-		glBufferData(buffer_type, GLsizeiptr(size_in_memory(data)), ptr(data), draw_type); opengl_check;
-		glBindBuffer(buffer_type, 0);                                                      opengl_check;
+		glGenBuffers(1, &vbo_index);                                                 opengl_check;
+		glBindBuffer(buffer_type, vbo_index);                                        opengl_check;
+		glBufferData(buffer_type, GLsizeiptr(size_byte), data, draw_type);           opengl_check;
+		glBindBuffer(buffer_type, 0);                                                opengl_check;
 
 		return vbo_index;
 	}
 
-	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec3> const& data)
+	template <int N>
+	static void opengl_vbo_initialize_generic(opengl_vbo_structure& vbo, numarray_stack<float, N> const* data, int size)
 	{
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
+		size_t const size_byte = size_t(size) * sizeof(numarray_stack<float, N>);
+		vbo.id = opengl_buffer_data_initialize_generic(data, size_byte, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+		vbo.size = size;
+		vbo.type = GL_ARRAY_BUFFER;
 
-		details.size_byte = size_in_memory(data);
-		details.size_element = 3;
-		details.type_element = GL_FLOAT;
+		vbo.details.size_byte = GLuint(size_byte);
+		vbo.details.size_element = N;
+		vbo.details.type_element = GL_FLOAT;
+	}
+
+	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec3> const& data)
+	{
+		opengl_vbo_initialize_generic(*this, data.data.data(), data.size());
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec2> const& data)
 	{
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
-
-		details.size_byte = size_in_memory(data);
-		details.size_element = 2;
-		details.type_element = GL_FLOAT;
+		opengl_vbo_initialize_generic(*this, data.data.data(), data.size());
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec4> const& data)
 	{
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
+		opengl_vbo_initialize_generic(*this, data.data.data(), data.size());
+	}
 
-		details.size_byte = size_in_memory(data);
-		details.size_element = 4;
-		details.type_element = GL_FLOAT;
+	void opengl_vbo_structure::initialize_data_on_gpu(vec3 const* data, int N)
+	{
+		opengl_vbo_initialize_generic(*this, data, N);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(vec2 const* data, int N)
+	{
+		opengl_vbo_initialize_generic(*this, data, N);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(vec4 const* data, int N)
+	{
+		opengl_vbo_initialize_generic(*this, data, N);
 	}
 
 	void opengl_vbo_structure::update(numarray<vec2> const& data)
@@ -63,6 +70,30 @@ namespace cgp
 		glBufferSubData(GL_ARRAY_BUFFER, 0, size_in_memory(data), ptr(data));  opengl_check;
 	}
 
+	template <int N>
+	static void opengl_vbo_update_range_generic(opengl_vbo_structure const& vbo, numarray_stack<float, N> const* data, int size, int offset)
+	{
+		assert_cgp(offset >= 0 && size >= 0 && GLuint(offset + size) <= vbo.size, "Update of the range [" + str(offset) + "," + str(offset + size) + "[ out of the VBO of size " + str(vbo.size));
+		if (size == 0)
+			return;
+		GLintptr const offset_byte = GLintptr(offset) * sizeof(numarray_stack<float, N>);
+		GLsizeiptr const size_byte = GLsizeiptr(size) * sizeof(numarray_stack<float, N>);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo.id); opengl_check;
+		glBufferSubData(GL_ARRAY_BUFFER, offset_byte, size_byte, data);  opengl_check;
+	}
+	void opengl_vbo_structure::update(vec3 const* data, int N, int offset)
+	{
+		opengl_vbo_update_range_generic(*this, data, N, offset);
+	}
+	void opengl_vbo_structure::update(vec2 const* data, int N, int offset)
+	{
+		opengl_vbo_update_range_generic(*this, data, N, offset);
+	}
+	void opengl_vbo_structure::update(vec4 const* data, int N, int offset)
+	{
+		opengl_vbo_update_range_generic(*this, data, N, offset);
+	}
+
 
 	void opengl_set_vao_location(opengl_vbo_structure const& vbo, GLuint location_index)
 	{
@@ -15,9 +15,19 @@ namespace cgp
 		void initialize_data_on_gpu(numarray<vec2> const& data);
 		void initialize_data_on_gpu(numarray<vec4> const& data);
 
+		// Initialize from a raw pointer on N elements (ex. data read from a memory mapped file)
+		void initialize_data_on_gpu(vec3 const* data, int N);
+		void initialize_data_on_gpu(vec2 const* data, int N);
+		void initialize_data_on_gpu(vec4 const* data, int N);
+
 		void update(numarray<vec2> const& data);
 		void update(numarray<vec3> const& data);
 		void update(numarray<vec4> const& data);
+
+		// Update only the elements [offset, offset+N[ of the buffer (glBufferSubData on this range)
+		void update(vec3 const* data, int N, int offset);
+		void update(vec2 const* data, int N, int offset);
+		void update(vec4 const* data, int N, int offset);
 	};
 
 	/** Call glVertexAttribPointer and set the correspondance between VBO and the location in the shader */
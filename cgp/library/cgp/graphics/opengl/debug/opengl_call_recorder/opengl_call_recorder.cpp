@@ -0,0 +1,297 @@
+#include "opengl_call_recorder.hpp"
+
+#include "cgp/core/base/base.hpp"
+
+#include <tuple>
+
+namespace cgp
+{
+	int opengl_call_statistics::state_change() const
+	{
+		return use_program + bind_texture + active_texture + bind_vertex_array + bind_buffer;
+	}
+
+	static auto draw_record_key(opengl_draw_record const& a)
+	{
+		return std::make_tuple(a.program, a.texture, a.vao, a.element_buffer, a.count, a.instance_count);
+	}
+	bool operator<(opengl_draw_record const& a, opengl_draw_record const& b)
+	{
+		return draw_record_key(a) < draw_record_key(b);
+	}
+	bool operator==(opengl_draw_record const& a, opengl_draw_record const& b)
+	{
+		return draw_record_key(a) == draw_record_key(b);
+	}
+
+	namespace opengl_call_recorder_detail
+	{
+		static bool active = false;
+		static opengl_call_statistics statistics;
+		static std::vector<opengl_draw_record> draws;
+
+		// Tracked state
+		static GLuint program = 0;
+		static GLuint vao = 0;
+		static GLuint element_buffer = 0;
+		static GLuint active_unit = 0;
+		static GLuint texture_unit[32] = {};
+
+		// Original functions
+		static PFNGLUSEPROGRAMPROC UseProgram;
+		static PFNGLBINDTEXTUREPROC BindTexture;
+		static PFNGLACTIVETEXTUREPROC ActiveTexture;
+		static PFNGLBINDVERTEXARRAYPROC BindVertexArray;
+		static PFNGLBINDBUFFERPROC BindBuffer;
+		static PFNGLUNIFORM1IPROC Uniform1i;
+		static PFNGLUNIFORM1FPROC Uniform1f;
+		static PFNGLUNIFORM2FPROC Uniform2f;
+		static PFNGLUNIFORM3FPROC Uniform3f;
+		static PFNGLUNIFORM4FPROC Uniform4f;
+		static PFNGLUNIFORMMATRIX2FVPROC UniformMatrix2fv;
+		static PFNGLUNIFORMMATRIX3FVPROC UniformMatrix3fv;
+		static PFNGLUNIFORMMATRIX4FVPROC UniformMatrix4fv;
+		static PFNGLDRAWELEMENTSPROC DrawElements;
+		static PFNGLDRAWELEMENTSINSTANCEDPROC DrawElementsInstanced;
+		static PFNGLDRAWARRAYSPROC DrawArrays;
+		static PFNGLMULTIDRAWARRAYSPROC MultiDrawArrays;
+		static PFNGLGETERRORPROC GetError;
+		static PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation;
+		static PFNGLISSHADERPROC IsShader;
+		static PFNGLENABLEPROC Enable;
+		static PFNGLDISABLEPROC Disable;
+		static PFNGLPOLYGONMODEPROC PolygonMode;
+		static PFNGLPOLYGONOFFSETPROC PolygonOffset;
+		static PFNGLGENBUFFERSPROC GenBuffers;
+		static PFNGLBUFFERDATAPROC BufferData;
+		static PFNGLBUFFERSUBDATAPROC BufferSubData;
+		static PFNGLDELETEBUFFERSPROC DeleteBuffers;
+		static PFNGLGENVERTEXARRAYSPROC GenVertexArrays;
+		static PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays;
+		static PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+		static PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray;
+		static PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
+		static PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+
+		static void record_draw(GLsizei count, GLsizei instance_count)
+		{
+			opengl_draw_record record;
+			record.program = program;
+			record.texture = texture_unit[0];
+			record.vao = vao;
+			record.element_buffer = element_buffer;
+			record.count = count;
+			record.instance_count = instance_count;
+			draws.push_back(record);
+			statistics.draw++;
+		}
+
+		static void APIENTRY use_program(GLuint id) {
+			statistics.use_program++; program = id;
+			if (UseProgram) UseProgram(id);
+		}
+		static void APIENTRY bind_texture(GLenum target, GLuint id) {
+			statistics.bind_texture++; texture_unit[active_unit] = id;
+			if (BindTexture) BindTexture(target, id);
+		}
+		static void APIENTRY active_texture(GLenum unit) {
+			statistics.active_texture++; active_unit = (unit - GL_TEXTURE0) % 32;
+			if (ActiveTexture) ActiveTexture(unit);
+		}
+		static void APIENTRY bind_vertex_array(GLuint id) {
+			statistics.bind_vertex_array++; vao = id;
+			if (BindVertexArray) BindVertexArray(id);
+		}
+		static void APIENTRY bind_buffer(GLenum target, GLuint id) {
+			statistics.bind_buffer++;
+			if (target == GL_ELEMENT_ARRAY_BUFFER) element_buffer = id;
+			if (BindBuffer) BindBuffer(target, id);
+		}
+		static void APIENTRY uniform_1i(GLint location, GLint x) {
+			statistics.uniform++;
+			if (Uniform1i) Uniform1i(location, x);
+		}
+		static void APIENTRY uniform_1f(GLint location, GLfloat x) {
+			statistics.uniform++;
+			if (Uniform1f) Uniform1f(location, x);
+		}
+		static void APIENTRY uniform_2f(GLint location, GLfloat x, GLfloat y) {
+			statistics.uniform++;
+			if (Uniform2f) Uniform2f(location, x, y);
+		}
+		static void APIENTRY uniform_3f(GLint location, GLfloat x, GLfloat y, GLfloat z) {
+			statistics.uniform++;
+			if (Uniform3f) Uniform3f(location, x, y, z);
+		}
+		static void APIENTRY uniform_4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+			statistics.uniform++;
+			if (Uniform4f) Uniform4f(location, x, y, z, w);
+		}
+		static void APIENTRY uniform_matrix_2fv(GLint location, GLsizei count, GLboolean transpose, GLfloat const* value) {
+			statistics.uniform++;
+			if (UniformMatrix2fv) UniformMatrix2fv(location, count, transpose, value);
+		}
+		static void APIENTRY uniform_matrix_3fv(GLint location, GLsizei count, GLboolean transpose, GLfloat const* value) {
+			statistics.uniform++;
+			if (UniformMatrix3fv) UniformMatrix3fv(location, count, transpose, value);
+		}
+		static void APIENTRY uniform_matrix_4fv(GLint location, GLsizei count, GLboolean transpose, GLfloat const* value) {
+			statistics.uniform++;
+			if (UniformMatrix4fv) UniformMatrix4fv(location, count, transpose, value);
+		}
+		static void APIENTRY draw_elements(GLenum mode, GLsizei count, GLenum type, void const* indices) {
+			record_draw(count, 1);
+			if (DrawElements) DrawElements(mode, count, type, indices);
+		}
+		static void APIENTRY draw_elements_instanced(GLenum mode, GLsizei count, GLenum type, void const* indices, GLsizei instance_count) {
+			record_draw(count, instance_count);
+			if (DrawElementsInstanced) DrawElementsInstanced(mode, count, type, indices, instance_count);
+		}
+		static void APIENTRY draw_arrays(GLenum mode, GLint first, GLsizei count) {
+			record_draw(count, 1);
+			if (DrawArrays) DrawArrays(mode, first, count);
+		}
+		static void APIENTRY multi_draw_arrays(GLenum mode, GLint const* first, GLsizei const* count, GLsizei N) {
+			for (GLsizei k = 0; k < N; ++k)
+				record_draw(count[k], 1);
+			if (MultiDrawArrays) MultiDrawArrays(mode, first, count, N);
+		}
+
+		// Queries and state used by the drawables, without OpenGL context
+		static GLenum APIENTRY get_error_headless() { return GL_NO_ERROR; }
+		static GLint APIENTRY get_uniform_location_headless(GLuint, GLchar const*) { return 0; }
+		static GLboolean APIENTRY is_shader_headless(GLuint) { return GL_FALSE; }
+		static void APIENTRY enable_headless(GLenum) {}
+		static void APIENTRY polygon_mode_headless(GLenum, GLenum) {}
+		static void APIENTRY polygon_offset_headless(GLfloat, GLfloat) {}
+		static void APIENTRY gen_buffers_headless(GLsizei N, GLuint* id) {
+			static GLuint counter = 0;
+			for (GLsizei k = 0; k < N; ++k)
+				id[k] = ++counter;
+		}
+		static void APIENTRY buffer_data_headless(GLenum, GLsizeiptr, void const*, GLenum) {}
+		static void APIENTRY buffer_sub_data_headless(GLenum, GLintptr, GLsizeiptr, void const*) {}
+		static void APIENTRY delete_headless(GLsizei, GLuint const*) {}
+		static void APIENTRY vertex_attrib_array_headless(GLuint) {}
+		static void APIENTRY vertex_attrib_pointer_headless(GLuint, GLint, GLenum, GLboolean, GLsizei, void const*) {}
+		static void APIENTRY vertex_attrib_divisor_headless(GLuint, GLuint) {}
+	}
+
+	void opengl_call_recorder_start()
+	{
+		using namespace opengl_call_recorder_detail;
+		assert_cgp(active == false, "opengl_call_recorder_start() called while the recorder is already active");
+		active = true;
+		opengl_call_recorder_reset();
+
+		UseProgram = glad_glUseProgram;                    glad_glUseProgram = use_program;
+		BindTexture = glad_glBindTexture;                  glad_glBindTexture = bind_texture;
+		ActiveTexture = glad_glActiveTexture;              glad_glActiveTexture = active_texture;
+		BindVertexArray = glad_glBindVertexArray;          glad_glBindVertexArray = bind_vertex_array;
+		BindBuffer = glad_glBindBuffer;                    glad_glBindBuffer = bind_buffer;
+		Uniform1i = glad_glUniform1i;                      glad_glUniform1i = uniform_1i;
+		Uniform1f = glad_glUniform1f;                      glad_glUniform1f = uniform_1f;
+		Uniform2f = glad_glUniform2f;                      glad_glUniform2f = uniform_2f;
+		Uniform3f = glad_glUniform3f;                      glad_glUniform3f = uniform_3f;
+		Uniform4f = glad_glUniform4f;                      glad_glUniform4f = uniform_4f;
+		UniformMatrix2fv = glad_glUniformMatrix2fv;        glad_glUniformMatrix2fv = uniform_matrix_2fv;
+		UniformMatrix3fv = glad_glUniformMatrix3fv;        glad_glUniformMatrix3fv = uniform_matrix_3fv;
+		UniformMatrix4fv = glad_glUniformMatrix4fv;        glad_glUniformMatrix4fv = uniform_matrix_4fv;
+		DrawElements = glad_glDrawElements;                glad_glDrawElements = draw_elements;
+		DrawElementsInstanced = glad_glDrawElementsInstanced; glad_glDrawElementsInstanced = draw_elements_instanced;
+		DrawArrays = glad_glDrawArrays;                    glad_glDrawArrays = draw_arrays;
+		MultiDrawArrays = glad_glMultiDrawArrays;          glad_glMultiDrawArrays = multi_draw_arrays;
+
+		GetError = glad_glGetError;                        if (!GetError) glad_glGetError = get_error_headless;
+		GetUniformLocation = glad_glGetUniformLocation;    if (!GetUniformLocation) glad_glGetUniformLocation = get_uniform_location_headless;
+		IsShader = glad_glIsShader;                        if (!IsShader) glad_glIsShader = is_shader_headless;
+		Enable = glad_glEnable;                            if (!Enable) glad_glEnable = enable_headless;
+		Disable = glad_glDisable;                          if (!Disable) glad_glDisable = enable_headless;
+		PolygonMode = glad_glPolygonMode;                  if (!PolygonMode) glad_glPolygonMode = polygon_mode_headless;
+		PolygonOffset = glad_glPolygonOffset;              if (!PolygonOffset) glad_glPolygonOffset = polygon_offset_headless;
+		GenBuffers = glad_glGenBuffers;                    if (!GenBuffers) glad_glGenBuffers = gen_buffers_headless;
+		BufferData = glad_glBufferData;                    if (!BufferData) glad_glBufferData = buffer_data_headless;
+		BufferSubData = glad_glBufferSubData;              if (!BufferSubData) glad_glBufferSubData = buffer_sub_data_headless;
+		DeleteBuffers = glad_glDeleteBuffers;              if (!DeleteBuffers) glad_glDeleteBuffers = delete_headless;
+		GenVertexArrays = glad_glGenVertexArrays;          if (!GenVertexArrays) glad_glGenVertexArrays = gen_buffers_headless;
+		DeleteVertexArrays = glad_glDeleteVertexArrays;    if (!DeleteVertexArrays) glad_glDeleteVertexArrays = delete_headless;
+		EnableVertexAttribArray = glad_glEnableVertexAttribArray;   if (!EnableVertexAttribArray) glad_glEnableVertexAttribArray = vertex_attrib_array_headless;
+		DisableVertexAttribArray = glad_glDisableVertexAttribArray; if (!DisableVertexAttribArray) glad_glDisableVertexAttribArray = vertex_attrib_array_headless;
+		VertexAttribPointer = glad_glVertexAttribPointer;  if (!VertexAttribPointer) glad_glVertexAttribPointer = vertex_attrib_pointer_headless;
+		VertexAttribDivisor = glad_glVertexAttribDivisor;  if (!VertexAttribDivisor) glad_glVertexAttribDivisor = vertex_attrib_divisor_headless;
+	}
+
+	void opengl_call_recorder_stop()
+	{
+		using namespace opengl_call_recorder_detail;
+		assert_cgp(active == true, "opengl_call_recorder_stop() called without opengl_call_recorder_start()");
+		active = false;
+
+		glad_glUseProgram = UseProgram;
+		glad_glBindTexture = BindTexture;
+		glad_glActiveTexture = ActiveTexture;
+		glad_glBindVertexArray = BindVertexArray;
+		glad_glBindBuffer = BindBuffer;
+		glad_glUniform1i = Uniform1i;
+		glad_glUniform1f = Uniform1f;
+		glad_glUniform2f = Uniform2f;
+		glad_glUniform3f = Uniform3f;
+		glad_glUniform4f = Uniform4f;
+		glad_glUniformMatrix2fv = UniformMatrix2fv;
+		glad_glUniformMatrix3fv = UniformMatrix3fv;
+		glad_glUniformMatrix4fv = UniformMatrix4fv;
+		glad_glDrawElements = DrawElements;
+		glad_glDrawElementsInstanced = DrawElementsInstanced;
+		glad_glDrawArrays = DrawArrays;
+		glad_glMultiDrawArrays = MultiDrawArrays;
+		glad_glGetError = GetError;
+		glad_glGetUniformLocation = GetUniformLocation;
+		glad_glIsShader = IsShader;
+		glad_glEnable = Enable;
+		glad_glDisable = Disable;
+		glad_glPolygonMode = PolygonMode;
+		glad_glPolygonOffset = PolygonOffset;
+		glad_glGenBuffers = GenBuffers;
+		glad_glBufferData = BufferData;
+		glad_glBufferSubData = BufferSubData;
+		glad_glDeleteBuffers = DeleteBuffers;
+		glad_glGenVertexArrays = GenVertexArrays;
+		glad_glDeleteVertexArrays = DeleteVertexArrays;
+		glad_glEnableVertexAttribArray = EnableVertexAttribArray;
+		glad_glDisableVertexAttribArray = DisableVertexAttribArray;
+		glad_glVertexAttribPointer = VertexAttribPointer;
+		glad_glVertexAttribDivisor = VertexAttribDivisor;
+	}
+
+	void opengl_call_recorder_reset()
+	{
+		using namespace opengl_call_recorder_detail;
+		statistics = opengl_call_statistics();
+		draws.clear();
+	}
+
+	opengl_call_statistics const& opengl_call_recorder_statistics()
+	{
+		return opengl_call_recorder_detail::statistics;
+	}
+	std::vector<opengl_draw_record> const& opengl_call_recorder_draws()
+	{
+		return opengl_call_recorder_detail::draws;
+	}
+
+	GLuint opengl_call_recorder_bound_texture(int unit)
+	{
+		assert_cgp(unit >= 0 && unit < 32, "Invalid texture unit " + str(unit));
+		return opengl_call_recorder_detail::texture_unit[unit];
+	}
+	int opengl_call_recorder_active_texture_unit()
+	{
+		return int(opengl_call_recorder_detail::active_unit);
+	}
+
+	std::string str(opengl_call_statistics const& s)
+	{
+		return "use_program: " + str(s.use_program) + ", bind_texture: " + str(s.bind_texture) + ", active_texture: " + str(s.active_texture)
+			+ ", bind_vertex_array: " + str(s.bind_vertex_array) + ", bind_buffer: " + str(s.bind_buffer) + ", uniform: " + str(s.uniform) + ", draw: " + str(s.draw);
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "cgp/opengl_include.hpp"
+
+#include <string>
+#include <vector>
+
+namespace cgp
+{
+	// Number of OpenGL calls changing the state, sending uniforms, or drawing since the last reset
+	struct opengl_call_statistics
+	{
+		int use_program = 0;
+		int bind_texture = 0;
+		int active_texture = 0;
+		int bind_vertex_array = 0;
+		int bind_buffer = 0;
+		int uniform = 0;
+		int draw = 0;
+
+		// Sum of the calls changing the bound program, textures, VAO and buffers
+		int state_change() const;
+	};
+
+	// State used by a draw call (program, texture on the unit 0, VAO and element buffer) and its size
+	struct opengl_draw_record
+	{
+		GLuint program = 0;
+		GLuint texture = 0;
+		GLuint vao = 0;
+		GLuint element_buffer = 0;
+		GLsizei count = 0;
+		GLsizei instance_count = 1;
+	};
+	bool operator<(opengl_draw_record const& a, opengl_draw_record const& b);
+	bool operator==(opengl_draw_record const& a, opengl_draw_record const& b);
+
+	// Recording of the OpenGL calls
+	//  opengl_call_recorder_start() replaces the OpenGL functions loaded by glad by functions that count the calls and track the bound state,
+	//  then forward to the original functions. opengl_call_recorder_stop() restores the original functions.
+	//  Without OpenGL context (ex. headless tests) the original functions are null: the calls are only recorded, and the queries
+	//  (glGetError, glGetUniformLocation, glIsShader) return GL_NO_ERROR, 0 and GL_FALSE. The buffer, vertex array and vertex attribute calls do nothing.
+	void opengl_call_recorder_start();
+	void opengl_call_recorder_stop();
+	void opengl_call_recorder_reset();
+
+	opengl_call_statistics const& opengl_call_recorder_statistics();
+	std::vector<opengl_draw_record> const& opengl_call_recorder_draws();
+	// Texture bound on the texture unit (any target), and index of the active texture unit, tracked since the first recording
+	GLuint opengl_call_recorder_bound_texture(int unit);
+	int opengl_call_recorder_active_texture_unit();
+
+	std::string str(opengl_call_statistics const& statistics);
+}
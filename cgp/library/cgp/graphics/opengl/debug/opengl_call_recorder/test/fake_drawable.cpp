@@ -0,0 +1,20 @@
+#include "fake_drawable.hpp"
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	mesh_drawable fake_drawable(GLuint shader, GLuint texture, GLuint vao, bounding_sphere const& bounds)
+	{
+		mesh_drawable drawable;
+		drawable.shader.id = shader;
+		drawable.texture.id = texture;
+		drawable.texture.texture_type = GL_TEXTURE_2D;
+		drawable.vao = vao;
+		drawable.vbo_position.size = 3;
+		drawable.ebo_connectivity.id = 1000 + vao;
+		drawable.ebo_connectivity.size = 1 + vao % 5;
+		drawable.bounding_volume = bounds;
+		return drawable;
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "cgp/graphics/drawable/mesh_drawable/mesh_drawable.hpp"
+
+
+namespace cgp_test
+{
+	// Drawable with fake OpenGL ids (never sent to an actual OpenGL context) to be drawn while the OpenGL calls are recorded
+	//  The element buffer and the number of triangles are derived from the VAO. The bounds are unknown by default (always visible).
+	cgp::mesh_drawable fake_drawable(GLuint shader, GLuint texture, GLuint vao, cgp::bounding_sphere const& bounds = cgp::bounding_sphere());
+}
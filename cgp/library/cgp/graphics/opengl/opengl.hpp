@@ -4,6 +4,7 @@
 
 #include "buffer/buffer.hpp"
 #include "debug/debug.hpp"
+#include "debug/opengl_call_recorder/opengl_call_recorder.hpp"
 #include "uniform/uniform.hpp"
 #include "shaders/shaders.hpp"
 #include "texture/texture.hpp"
\ No newline at end of file
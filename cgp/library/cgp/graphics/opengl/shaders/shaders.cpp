@@ -10,11 +10,27 @@ namespace cgp
     // Initialization of the static variable for the cache
     cache_uniform_location_structure opengl_shader_structure::cache_uniform_location;
 
+    // Layouts of the shaders, resolved once per shader id
+    static std::map<GLuint, std::shared_ptr<opengl_uniform_layout const> > cache_uniform_layout;
+
+    static std::shared_ptr<opengl_uniform_layout const> query_uniform_layout(GLuint shader_id)
+    {
+        std::shared_ptr<opengl_uniform_layout const>& layout = cache_uniform_layout[shader_id];
+        if (layout == nullptr) {
+            auto resolved = std::make_shared<opengl_uniform_layout>();
+            resolved->initialize(shader_id);
+            layout = resolved;
+        }
+        return layout;
+    }
+
 
     /** Load and compile shaders from glsl file sources
     * Display warnings and errors if the file cannot be accessed.
     * Display debug info when the shader is succesfully compiled. */
     GLuint opengl_load_shader(std::string const& vertex_shader_path, std::string const& fragment_shader_path);
+    /** Same as above with an additional geometry shader (ignored if geometry_shader_path is empty) */
+    GLuint opengl_load_shader(std::string const& vertex_shader_path, std::string const& geometry_shader_path, std::string const& fragment_shader_path);
 
     /** Compile shaders from direct text input.
     * Display no debug information in case of success */
@@ -30,6 +46,19 @@ namespace cgp
         }
 
         id = opengl_load_shader(vertex_shader_path, fragment_shader_path);
+        if (id != 0)
+            layout = query_uniform_layout(id);
+    }
+
+    void opengl_shader_structure::load(std::string const& vertex_shader_path, std::string const& geometry_shader_path, std::string const& fragment_shader_path)
+    {
+        if (id != 0) {
+            std::cout << " Warning: try to load a shader (" << vertex_shader_path << "," << geometry_shader_path << "," << fragment_shader_path << ") on a non empty shader_structure" << std::endl;
+        }
+
+        id = opengl_load_shader(vertex_shader_path, geometry_shader_path, fragment_shader_path);
+        if (id != 0)
+            layout = query_uniform_layout(id);
     }
 
     void opengl_shader_structure::load_from_inline_text(std::string const& vertex_shader_text, std::string const& fragment_shader_text)
@@ -39,6 +68,8 @@ namespace cgp
         }
 
         id = opengl_load_shader_from_text(vertex_shader_text, fragment_shader_text);
+        if (id != 0)
+            layout = query_uniform_layout(id);
     }
 
 
@@ -47,9 +78,17 @@ namespace cgp
         return cache_uniform_location.query(id, uniform_name);
     }
 
+    opengl_uniform_layout const& opengl_shader_structure::uniform_layout() const
+    {
+        if (layout != nullptr && layout->shader_id == id)
+            return *layout;
+        return *query_uniform_layout(id);
+    }
+
     void opengl_shader_structure::clear_cache_uniform_location()
     {
         cache_uniform_location.cache_data.clear();
+        cache_uniform_layout.clear();
     }
     std::string opengl_shader_structure::debug_dump_cache_uniform_location()
     {
@@ -160,6 +199,13 @@ namespace cgp
 
     GLuint opengl_load_shader(std::string const& vertex_shader_path, std::string const& fragment_shader_path)
     {
+        return opengl_load_shader(vertex_shader_path, "", fragment_shader_path);
+    }
+
+    GLuint opengl_load_shader(std::string const& vertex_shader_path, std::string const& geometry_shader_path, std::string const& fragment_shader_path)
+    {
+        bool const has_geometry_shader = !geometry_shader_path.empty();
+
         // Check the file are accessible
         if (check_file_exist(vertex_shader_path) == 0) {
             std::cout << "Warning: Cannot read the vertex shader at location " << vertex_shader_path << std::endl;
@@ -169,10 +215,16 @@ namespace cgp
             std::cout << "Warning: Cannot read the fragment shader at location " << vertex_shader_path << std::endl;
             std::cout << "If this file exists, you may need to adapt the directory from where your program is executed \n" << std::endl;
         }
+        if (has_geometry_shader && check_file_exist(geometry_shader_path) == 0) {
+            std::cout << "Warning: Cannot read the geometry shader at location " << geometry_shader_path << std::endl;
+            std::cout << "If this file exists, you may need to adapt the directory from where your program is executed \n" << std::endl;
+        }
 
         // Stop the program here if the file cannot be accessed
         assert_file_exist(vertex_shader_path);
         assert_file_exist(fragment_shader_path);
+        if (has_geometry_shader)
+            assert_file_exist(geometry_shader_path);
 
         // Read the files
         std::string const vertex_shader_text   = read_text_file(vertex_shader_path);
@@ -196,6 +248,16 @@ namespace cgp
             error_cgp("Failed to compile fragment shader " + fragment_shader_path);
         }
 
+        GLuint geometry_shader_id = 0;
+        if (has_geometry_shader) {
+            bool const geometry_shader_valid = compile_shader(GL_GEOMETRY_SHADER, read_text_file(geometry_shader_path), geometry_shader_id);
+            if (geometry_shader_valid == false) {
+                std::cout << "===> Failed to compile the Geometry Shader [" << geometry_shader_path << "]" << std::endl;
+                std::cout << "The error message from the compiler should be listed above. The program will stop." << std::endl;
+                error_cgp("Failed to compile geometry shader " + geometry_shader_path);
+            }
+        }
+
         assert_cgp_no_msg(glIsShader(vertex_shader_id));
         assert_cgp_no_msg(glIsShader(fragment_shader_id));
 
@@ -207,6 +269,8 @@ namespace cgp
         // Attach Shader to Program
         glAttachShader(program_id, vertex_shader_id);
         glAttachShader(program_id, fragment_shader_id);
+        if (has_geometry_shader)
+            glAttachShader(program_id, geometry_shader_id);
 
         // Link Program
         glLinkProgram(program_id);
@@ -221,11 +285,13 @@ namespace cgp
         // Shader can be detached.
         glDetachShader(program_id, vertex_shader_id);
         glDetachShader(program_id, fragment_shader_id);
+        if (has_geometry_shader)
+            glDetachShader(program_id, geometry_shader_id);
 
 
         // Debug info
         std::string msg = "  [info] Shader compiled succesfully [ID=" + str(program_id) + "]\n";
-        msg            += "         (" + vertex_shader_path + ", " + fragment_shader_path + ")\n";
+        msg            += "         (" + vertex_shader_path + ", " + (has_geometry_shader ? geometry_shader_path + ", " : "") + fragment_shader_path + ")\n";
         std::cout << msg << std::endl;
 
         return program_id;
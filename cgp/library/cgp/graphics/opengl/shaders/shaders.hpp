@@ -3,6 +3,9 @@
 #include "cgp/opengl_include.hpp"
 
 #include "cache_uniform_location/cache_uniform_location.hpp"
+#include "uniform_layout/uniform_layout.hpp"
+
+#include <memory>
 
 
 namespace cgp
@@ -17,6 +20,8 @@ namespace cgp
 		// Load a new shader from filepath
 		//  Expect to load a new shader on an empty structure (otherwise the previous shader is not automatically destroyed from memory)
 		void load(std::string const& vertex_shader_path, std::string const& fragment_shader_path);
+		// Load a new shader with an additional geometry shader stage
+		void load(std::string const& vertex_shader_path, std::string const& geometry_shader_path, std::string const& fragment_shader_path);
 
 		// Load a new shader from inline text
 		void load_from_inline_text(std::string const& vertex_shader_text, std::string const& fragment_shader_text);
@@ -24,6 +29,10 @@ namespace cgp
 		// Query the location of a uniform variable using the cache system
 		GLint query_uniform_location(std::string const& uniform_name) const;
 
+		// Locations of the uniforms of the drawables, resolved when the shader is loaded (see opengl_uniform_layout)
+		//  A shader whose id was set without load() gets its layout resolved at the first call
+		opengl_uniform_layout const& uniform_layout() const;
+
 		// Clear the cache system
 		void clear_cache_uniform_location();
 
@@ -37,6 +46,9 @@ namespace cgp
 		//  The cache is updated automatically when using the function opengl_get_location_uniform
 		//  Note that this cache is shader through all instances of shader_structure (to take care in case of parallelism)
 		static cache_uniform_location_structure cache_uniform_location;
+
+		// Layout shared by all the copies of this shader structure
+		std::shared_ptr<opengl_uniform_layout const> layout;
 	};
 
 
@@ -0,0 +1,60 @@
+#include "benchmark_uniform_layout.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/geometry/vec/vec.hpp"
+#include "cgp/graphics/opengl/opengl.hpp"
+#include "cgp/graphics/drawable/material/material.hpp"
+
+#include <chrono>
+
+namespace cgp_test
+{
+	using namespace cgp;
+
+	// Previous implementation of material_mesh_drawable_phong::send_opengl_uniform: one lookup by name per uniform
+	static void send_material_by_name(opengl_shader_structure const& shader, material_mesh_drawable_phong const& material)
+	{
+		opengl_uniform(shader, "material.color", material.color);
+		opengl_uniform(shader, "material.alpha", material.alpha);
+
+		opengl_uniform(shader, "material.phong.ambient", material.phong.ambient);
+		opengl_uniform(shader, "material.phong.diffuse", material.phong.diffuse);
+		opengl_uniform(shader, "material.phong.specular", material.phong.specular);
+		opengl_uniform(shader, "material.phong.specular_exponent", material.phong.specular_exponent);
+
+		opengl_uniform(shader, "material.texture_settings.use_texture", material.texture_settings.active);
+		opengl_uniform(shader, "material.texture_settings.texture_inverse_v", material.texture_settings.inverse_v);
+		opengl_uniform(shader, "material.texture_settings.two_sided", material.texture_settings.two_sided);
+	}
+
+	template <typename F>
+	static double time_ms(F const& f, int N)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N; ++k)
+			f();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+	}
+
+	void benchmark_uniform_layout()
+	{
+		int const N = 1000000;
+		opengl_shader_structure shader;
+		shader.id = 1; // fake shader (headless)
+		material_mesh_drawable_phong material;
+
+		opengl_call_recorder_start();
+
+		double const t_name = time_ms([&]() { send_material_by_name(shader, material); }, N);
+		int const uniform_name = opengl_call_recorder_statistics().uniform;
+
+		opengl_call_recorder_reset();
+		double const t_layout = time_ms([&]() { material.send_opengl_uniform(shader); }, N);
+		int const uniform_layout = opengl_call_recorder_statistics().uniform;
+
+		opengl_call_recorder_stop();
+
+		assert_cgp_no_msg(uniform_name == 9 * N && uniform_layout == 9 * N);
+		std::cout << "Material uniforms (" << N << " draws): by name " << t_name << " ms, layout " << t_layout << " ms (x" << t_name / t_layout << ")" << std::endl;
+	}
+}
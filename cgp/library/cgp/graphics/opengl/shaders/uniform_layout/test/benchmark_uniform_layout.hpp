@@ -0,0 +1,9 @@
+#pragma once
+
+
+namespace cgp_test
+{
+	// Compare the CPU cost of sending the material uniforms by name (cache lookup) and from the precomputed opengl_uniform_layout
+	//  Runs without OpenGL context using opengl_call_recorder
+	void benchmark_uniform_layout();
+}
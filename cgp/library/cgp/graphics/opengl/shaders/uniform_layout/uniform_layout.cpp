@@ -0,0 +1,58 @@
+#include "uniform_layout.hpp"
+
+#include "cgp/core/base/base.hpp"
+#include "cgp/graphics/opengl/debug/debug.hpp"
+
+
+namespace cgp
+{
+	static opengl_uniform_location query_location(GLuint shader_id, char const* name)
+	{
+		opengl_uniform_location u;
+		u.location = glGetUniformLocation(shader_id, name); opengl_check;
+		u.shader = shader_id;
+		u.name = name;
+		return u;
+	}
+
+	void opengl_uniform_layout::initialize(GLuint shader_id)
+	{
+		assert_cgp(shader_id != 0, "Try to initialize the uniform layout of an unspecified shader (shader index = 0).");
+		this->shader_id = shader_id;
+
+		model = query_location(shader_id, "model");
+		modelNormal = query_location(shader_id, "modelNormal");
+		color = query_location(shader_id, "color");
+		image_texture = query_location(shader_id, "image_texture");
+
+		material_color = query_location(shader_id, "material.color");
+		material_alpha = query_location(shader_id, "material.alpha");
+		material_phong_ambient = query_location(shader_id, "material.phong.ambient");
+		material_phong_diffuse = query_location(shader_id, "material.phong.diffuse");
+		material_phong_specular = query_location(shader_id, "material.phong.specular");
+		material_phong_specular_exponent = query_location(shader_id, "material.phong.specular_exponent");
+		material_texture_use_texture = query_location(shader_id, "material.texture_settings.use_texture");
+		material_texture_inverse_v = query_location(shader_id, "material.texture_settings.texture_inverse_v");
+		material_texture_two_sided = query_location(shader_id, "material.texture_settings.two_sided");
+
+		projection = query_location(shader_id, "projection");
+		view = query_location(shader_id, "view");
+		light = query_location(shader_id, "light");
+	}
+
+	static std::string str(opengl_uniform_location const& u)
+	{
+		return std::string("  ") + u.name + " : " + str(u.location) + "\n";
+	}
+
+	std::string str(opengl_uniform_layout const& layout)
+	{
+		std::string s;
+		for (opengl_uniform_location const* u : { &layout.model, &layout.modelNormal, &layout.color, &layout.image_texture,
+			&layout.material_color, &layout.material_alpha, &layout.material_phong_ambient, &layout.material_phong_diffuse,
+			&layout.material_phong_specular, &layout.material_phong_specular_exponent, &layout.material_texture_use_texture,
+			&layout.material_texture_inverse_v, &layout.material_texture_two_sided, &layout.projection, &layout.view, &layout.light })
+			s += str(*u);
+		return s;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "cgp/opengl_include.hpp"
+
+#include <string>
+
+namespace cgp
+{
+	// Location of a uniform variable in a shader, resolved once (see opengl_uniform_layout)
+	//  location == -1 if the shader doesn't use this uniform. The name is only used in the warnings.
+	struct opengl_uniform_location
+	{
+		GLint location = -1;
+		GLuint shader = 0;
+		char const* name = "";
+	};
+
+	// Locations of the uniforms sent by the drawables and the environment, resolved once per shader (at link time)
+	//  Sending a uniform from its layout is a direct write at its location, without string construction nor cache lookup.
+	//  Send the values using opengl_uniform(layout.model, value) (see uniform.hpp)
+	struct opengl_uniform_layout
+	{
+		GLuint shader_id = 0;
+
+		// Model block (mesh_drawable and curve_drawable)
+		opengl_uniform_location model;
+		opengl_uniform_location modelNormal;
+		opengl_uniform_location color;
+		opengl_uniform_location image_texture;
+
+		// Material block (material_mesh_drawable_phong)
+		opengl_uniform_location material_color;
+		opengl_uniform_location material_alpha;
+		opengl_uniform_location material_phong_ambient;
+		opengl_uniform_location material_phong_diffuse;
+		opengl_uniform_location material_phong_specular;
+		opengl_uniform_location material_phong_specular_exponent;
+		opengl_uniform_location material_texture_use_texture;
+		opengl_uniform_location material_texture_inverse_v;
+		opengl_uniform_location material_texture_two_sided;
+
+		// Environment block (camera and light)
+		opengl_uniform_location projection;
+		opengl_uniform_location view;
+		opengl_uniform_location light;
+
+		// Query all the locations of the layout in the shader (calls glGetUniformLocation)
+		void initialize(GLuint shader_id);
+	};
+
+	std::string str(opengl_uniform_layout const& layout);
+}
@@ -102,6 +102,50 @@ namespace cgp
 	}
 
 
+	static bool check_location(opengl_uniform_location const& u, bool expected)
+	{
+		if (u.location != -1)
+			return true;
+		return check_location(u.location, u.name, u.shader, expected);
+	}
+
+	void opengl_uniform(opengl_uniform_location const& u, int value, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniform1i(u.location, value); opengl_check;
+		}
+	}
+	void opengl_uniform(opengl_uniform_location const& u, float value, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniform1f(u.location, value); opengl_check;
+		}
+	}
+	void opengl_uniform(opengl_uniform_location const& u, vec3 const& value, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniform3f(u.location, value.x, value.y, value.z); opengl_check;
+		}
+	}
+	void opengl_uniform(opengl_uniform_location const& u, vec4 const& value, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniform4f(u.location, value.x, value.y, value.z, value.w); opengl_check;
+		}
+	}
+	void opengl_uniform(opengl_uniform_location const& u, mat4 const& m, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniformMatrix4fv(u.location, 1, GL_TRUE, ptr(m)); opengl_check;
+		}
+	}
+	void opengl_uniform(opengl_uniform_location const& u, mat3 const& m, bool expected)
+	{
+		if (check_location(u, expected)) {
+			glUniformMatrix3fv(u.location, 1, GL_TRUE, ptr(m)); opengl_check;
+		}
+	}
+
 
 	void uniform_generic_structure::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 	{
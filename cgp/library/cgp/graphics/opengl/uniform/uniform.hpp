@@ -45,5 +45,15 @@ namespace cgp
 	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat3 const& m, bool expected = true);
 	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat2 const& m, bool expected = true);
 
+
+	// Send a uniform at a location resolved in advance (see opengl_uniform_layout): no string manipulation nor lookup
+	//  Nothing is sent if the shader doesn't use the uniform (location == -1), with a warning if expected is true
+	void opengl_uniform(opengl_uniform_location const& u, int value, bool expected = true);
+	void opengl_uniform(opengl_uniform_location const& u, float value, bool expected = true);
+	void opengl_uniform(opengl_uniform_location const& u, vec3 const& value, bool expected = true);
+	void opengl_uniform(opengl_uniform_location const& u, vec4 const& value, bool expected = true);
+	void opengl_uniform(opengl_uniform_location const& u, mat4 const& m, bool expected = true);
+	void opengl_uniform(opengl_uniform_location const& u, mat3 const& m, bool expected = true);
+
 }
 
@@ -91,6 +91,10 @@ unsigned char perm[512] = {151,160,137,91,90,15,
   138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180 
 };
 
+unsigned char const* snoise_permutation() {
+  return perm;
+}
+
 //---------------------------------------------------------------------
 
 /*
@@ -12,9 +12,10 @@ environment_structure::environment_structure()
 
 void environment_structure::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 {
-	opengl_uniform(shader, "projection", camera_projection, expected);
-	opengl_uniform(shader, "view", camera_view, expected);
-	opengl_uniform(shader, "light", light, false);
+	opengl_uniform_layout const& layout = shader.uniform_layout();
+	opengl_uniform(layout.projection, camera_projection, expected);
+	opengl_uniform(layout.view, camera_view, expected);
+	opengl_uniform(layout.light, light, false);
 
 	uniform_generic.send_opengl_uniform(shader, expected);
 
@@ -113,6 +113,10 @@ void initialize_default_shaders()
 
 	// Set standard mesh shader for mesh_drawable
 	mesh_drawable::default_shader.load("shaders/mesh/vert.glsl", "shaders/mesh/frag.glsl");
+	// Instanced version of the mesh shader (used by mesh_drawable_instanced and to group the identical nodes of hierarchy_mesh_drawable)
+	mesh_drawable_instanced::default_shader.load("shaders/mesh_instanced/vert.glsl", "shaders/mesh/frag.glsl");
+	// Mesh shader drawing the edges of the triangles in the same pass (used by draw_with_wireframe)
+	mesh_drawable::wireframe_shader.load("shaders/mesh_wireframe/vert.glsl", "shaders/mesh_wireframe/geom.glsl", "shaders/mesh_wireframe/frag.glsl");
 	// Set default white texture
 	image_structure const white_image = image_structure{ 1,1,image_color_type::rgba,{255,255, 255,255} };
 	//image_structure const feather_texture = image_load_file("assets/feathers_ao.png");
@@ -2,7 +2,6 @@
 
 
 using namespace cgp;
-const char* tubeNames[3] = {"Tube A1", "Tube B1", "Tube C1"};
 
 void scene_structure::initialize()
 {
@@ -15,6 +14,9 @@ void scene_structure::initialize()
 	// Create the hierarchy
 	// ************************************ //
 
+	// The identical tubes and wings are drawn in a single instanced draw call each (see mesh_drawable_instanced::default_shader in main.cpp)
+	hierarchy.instancing = true;
+
 	// Initialize the temporary mesh_drawable that will be inserted in the hierarchy
 	mesh_drawable cube_base;
 	mesh_drawable cylinder_base;
@@ -94,18 +96,18 @@ void scene_structure::initialize()
 	hierarchy.add(yellow_cylinder, "Yellow cylinder 2", "Cylinder 1 son", { 0, 0, -0.25f });*/
 
 	// Bird
-	hierarchy.add(bird_body, "Bird body");
-	hierarchy.add(bird_head, "Bird head", "Bird body", { 0.45f, 0, 0.3f });
+	node_bird_body = hierarchy.add(bird_body, "Bird body");
+	node_bird_head = hierarchy.add(bird_head, "Bird head", "Bird body", { 0.45f, 0, 0.3f });
 	hierarchy.add(bird_nose, "Bird nose", "Bird head", { 0.12f, 0, 0 }, rotation_transform::from_axis_angle({0,1,0}, 1.571f));
-	hierarchy.add(wing_up, "Bird up left wing", "Bird body");
-	hierarchy.add(wing_up, "Bird up right wing", "Bird body");
-	hierarchy.add(wing_low, "Bird low left wing", "Bird up left wing", {0, 0.4f, 0});
-	hierarchy.add(wing_low, "Bird low right wing", "Bird up right wing", { 0, 0.4f, 0 });
-	hierarchy["Bird body"].transform_local.translation.z = 3.0f;
-	hierarchy["Bird body"].transform_local.scaling = 2.0f;
+	node_bird_up_left_wing = hierarchy.add(wing_up, "Bird up left wing", "Bird body");
+	node_bird_up_right_wing = hierarchy.add(wing_up, "Bird up right wing", "Bird body");
+	node_bird_low_left_wing = hierarchy.add(wing_low, "Bird low left wing", "Bird up left wing", {0, 0.4f, 0});
+	node_bird_low_right_wing = hierarchy.add(wing_low, "Bird low right wing", "Bird up right wing", { 0, 0.4f, 0 });
+	hierarchy[node_bird_body].transform_local.translation.z = 3.0f;
+	hierarchy[node_bird_body].transform_local.scaling = 2.0f;
 
 	// Tubes
-	hierarchy.add(tube, "Tube A1");
+	node_tubes[0] = hierarchy.add(tube, "Tube A1");
 	hierarchy.add(tube_top, "Tube A1 hat", "Tube A1", { 0, 0, 12.0f });
 	hierarchy.add(tube, "Tube A2", "Tube A1", { 0, 0, 32.5f /* hole between tubes */ });
 	hierarchy.add(tube_top, "Tube A2 hat", "Tube A2", { 0, 0, 12.0f });
@@ -113,14 +115,14 @@ void scene_structure::initialize()
 	hierarchy["Tube A1"].transform_local.translation.z = -17.0f; // hole height
 	hierarchy["Tube A1"].transform_local.translation.x = 100.0f; // first tubes spawn on the left out of frame
 
-	hierarchy.add(tube, "Tube B1");
+	node_tubes[1] = hierarchy.add(tube, "Tube B1");
 	hierarchy.add(tube_top, "Tube B1 hat", "Tube B1", { 0, 0, 12.0f });
 	hierarchy.add(tube, "Tube B2", "Tube B1", { 0, 0, 32.5f });
 	hierarchy.add(tube_top, "Tube B2 hat", "Tube B2", { 0, 0, 12.0f });
 	hierarchy["Tube B2"].transform_local.rotation = rotation_transform::from_axis_angle({ 0, 1, 0 }, Pi);
 	hierarchy["Tube B1"].transform_local.translation.x = 100.0f;
 
-	hierarchy.add(tube, "Tube C1");
+	node_tubes[2] = hierarchy.add(tube, "Tube C1");
 	hierarchy.add(tube_top, "Tube C1 hat", "Tube C1", { 0, 0, 12.0f });
 	hierarchy.add(tube, "Tube C2", "Tube C1", { 0, 0, 32.5f });
 	hierarchy.add(tube_top, "Tube C2 hat", "Tube C2", { 0, 0, 12.0f });
@@ -161,12 +163,12 @@ void scene_structure::display_frame()
 	lastSpawnedTube += deltaTime;
 	if (lastSpawnedTube > 2.0f)
 	{
-		const char* tubeName = tubeNames[lastTubeId];
-		std::cout << "Spawning tube " << tubeName << std::endl;
+		hierarchy_mesh_drawable_node& tubeNode = hierarchy[node_tubes[lastTubeId]];
+		std::cout << "Spawning tube " << tubeNode.name << std::endl;
 
 		float randY = rand_interval(-20.0f, -9.0f);
-		hierarchy[tubeName].transform_local.translation.z = randY;
-		hierarchy[tubeName].transform_local.translation.x = 10.0f;
+		tubeNode.transform_local.translation.z = randY;
+		tubeNode.transform_local.translation.x = 10.0f;
 
 		lastSpawnedTube = 0;
 		lastTubeId = (++lastTubeId) % 3;
@@ -183,29 +185,32 @@ void scene_structure::display_frame()
 	hierarchy["Cylinder 1 son"].transform_local.rotation = rotation_transform::from_axis_angle({ 0,0,1 }, 8 * timer.t);*/
 
 	// Bird physics
-	hierarchy["Bird body"].transform_local.translation += {0, 0, bird_speed_y * deltaTime};
-	hierarchy["Bird body"].transform_local.rotation = rotation_transform::from_axis_angle({ 0, 1, 0 }, -norm);
+	hierarchy[node_bird_body].transform_local.translation += {0, 0, bird_speed_y * deltaTime};
+	hierarchy[node_bird_body].transform_local.rotation = rotation_transform::from_axis_angle({ 0, 1, 0 }, -norm);
 
 	// Bird animations
-	hierarchy["Bird up left wing"].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, -cos(7 * timer.t) / 2);
-	hierarchy["Bird low left wing"].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, -cos(7 * timer.t));
-	hierarchy["Bird up right wing"].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, cos(7 * timer.t) / 2) * rotation_transform::from_axis_angle({ 1,0,0 }, Pi);
-	hierarchy["Bird low right wing"].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, cos(7 * timer.t));
-	hierarchy["Bird head"].transform_local.rotation = rotation_transform::from_axis_angle({ 0,1,0 }, cos(2 * timer.t) / 4);
+	hierarchy[node_bird_up_left_wing].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, -cos(7 * timer.t) / 2);
+	hierarchy[node_bird_low_left_wing].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, -cos(7 * timer.t));
+	hierarchy[node_bird_up_right_wing].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, cos(7 * timer.t) / 2) * rotation_transform::from_axis_angle({ 1,0,0 }, Pi);
+	hierarchy[node_bird_low_right_wing].transform_local.rotation = rotation_transform::from_axis_angle({ 1,0,0 }, cos(7 * timer.t));
+	hierarchy[node_bird_head].transform_local.rotation = rotation_transform::from_axis_angle({ 0,1,0 }, cos(2 * timer.t) / 4);
 
 	// Tubes
 	float tubeSpeed = 0.035f;
-	hierarchy["Tube A1"].transform_local.translation.x -= tubeSpeed;
-	hierarchy["Tube B1"].transform_local.translation.x -= tubeSpeed;
-	hierarchy["Tube C1"].transform_local.translation.x -= tubeSpeed;
+	for (auto const& tubeHandle : node_tubes)
+		hierarchy[tubeHandle].transform_local.translation.x -= tubeSpeed;
 
 	// This function must be called before the drawing in order to propagate the deformations through the hierarchy
 	hierarchy.update_local_to_global_coordinates();
+	// Skip the elements outside of the view (ex. the tubes that scrolled out of the screen)
+	hierarchy.update_visibility(environment.camera_projection * environment.camera_view);
 
 	// Draw the hierarchy as a single mesh
-	draw(hierarchy, environment);
+	//  (with the wireframe: the edges are drawn in the same pass)
 	if (gui.display_wireframe)
-		draw_wireframe(hierarchy, environment);
+		draw_with_wireframe(hierarchy, environment);
+	else
+		draw(hierarchy, environment);
 }
 
 void scene_structure::display_gui()
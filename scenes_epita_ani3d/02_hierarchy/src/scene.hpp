@@ -34,6 +34,15 @@ struct scene_structure : cgp::scene_inputs_generic {
 	// The entire hierarchy
 	cgp::hierarchy_mesh_drawable hierarchy;
 
+	// Handles on the animated nodes (resolved once at initialization)
+	cgp::hierarchy_mesh_drawable_handle node_bird_body;
+	cgp::hierarchy_mesh_drawable_handle node_bird_head;
+	cgp::hierarchy_mesh_drawable_handle node_bird_up_left_wing;
+	cgp::hierarchy_mesh_drawable_handle node_bird_up_right_wing;
+	cgp::hierarchy_mesh_drawable_handle node_bird_low_left_wing;
+	cgp::hierarchy_mesh_drawable_handle node_bird_low_right_wing;
+	cgp::hierarchy_mesh_drawable_handle node_tubes[3];
+
 	// Flappy Bird
 	float gravity = -25;
 	float minSpeed = -30;